@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <shared/ring.h>
+
 #include <stdint.h>
 #include <stdatomic.h>
 
@@ -49,14 +51,13 @@ typedef struct TcpSocket
 {
 	_Atomic SocketID id;
 	const char* Host;
-	uint8_t* buffer;
+	ring_t Buffer;
 	SocketCallback Open;
 	SocketReadCallback Read;
 	SocketCallback Close;
 	ThreadID thread;
 	uint16_t Port;
 	uint16_t Secure;
-	uint32_t BufferUsed;
 	uint32_t BufferSize;
 }
 TcpSocket;
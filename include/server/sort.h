@@ -4,7 +4,8 @@
 
 
 extern void
-QuickSort(
-	uint16_t* Array,
+QuickSortByKey(
+	uint32_t* Array,
+	const float* Keys,
 	int32_t len
 	);
@@ -139,6 +139,12 @@ alloc_get_global_state(
 	);
 
 
+extern alloc_t
+alloc_get_call_count(
+	void
+	);
+
+
 extern _const_func_ alloc_t
 alloc_get_page_size(
 	void
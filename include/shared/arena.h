@@ -0,0 +1,108 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <shared/alloc.h>
+
+
+typedef struct arena
+{
+	uint8_t* data;
+	alloc_t used;
+	alloc_t size;
+	alloc_t peak;
+}
+arena_t;
+
+
+typedef struct arena_ctx
+{
+	alloc_t used;
+}
+arena_ctx_t;
+
+
+extern void
+arena_init(
+	arena_t* arena,
+	alloc_t size
+	);
+
+
+extern void
+arena_free(
+	arena_t* arena
+	);
+
+
+extern void
+arena_reset(
+	arena_t* arena
+	);
+
+
+extern arena_ctx_t
+arena_save(
+	arena_t* arena
+	);
+
+
+extern void
+arena_restore(
+	arena_t* arena,
+	const arena_ctx_t* ctx
+	);
+
+
+extern alloc_t
+arena_available(
+	arena_t* arena
+	);
+
+
+extern void*
+arena_alloc(
+	arena_t* arena,
+	alloc_t size,
+	alloc_t alignment
+	);
+
+
+extern void*
+arena_alloc_safe(
+	arena_t* arena,
+	alloc_t size,
+	alloc_t alignment,
+	bool* status
+	);
+
+
+extern void*
+arena_calloc(
+	arena_t* arena,
+	alloc_t size,
+	alloc_t alignment
+	);
+
+
+#define arena_alloc_arr(arena, ptr, count)	\
+arena_alloc(arena, sizeof(*(ptr)) * (count), _Alignof(__typeof__(*(ptr))))
+
+
+#define arena_calloc_arr(arena, ptr, count)	\
+arena_calloc(arena, sizeof(*(ptr)) * (count), _Alignof(__typeof__(*(ptr))))
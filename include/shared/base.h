@@ -27,8 +27,9 @@ typedef enum GameConst
 	GAME_CONST_DEFAULT_WINDOW_HEIGHT = 720,
 	GAME_CONST_MAX_MOVEMENT_SPEED = 16,
 	GAME_CONST_MAX_PLAYERS = 256,
-	GAME_CONST_MAX_ENTITIES__BITS = MACRO_GET_BITS_CONST(GAME_CONST_MAX_PLAYERS * 100),
-	GAME_CONST_MAX_ENTITIES = 1 << GAME_CONST_MAX_ENTITIES__BITS,
+	GAME_CONST_MAX_ARENAS = 64,
+	GAME_CONST_INITIAL_ENTITIES = 1 << 11,
+	GAME_CONST_MAX_ENTITIES = 1 << 20,
 	GAME_CONST_PORT = 2468,
 	GAME_CONST_CLIENT_PACKET_SIZE = 256,
 	GAME_CONST_SERVER_PACKET_SIZE = 65536,
@@ -44,6 +45,18 @@ typedef enum GameConst
 	GAME_CONST_POSITION_INTEGER_BITS = MACRO_GET_BITS_CONST(GAME_CONST_HALF_ARENA_SIZE + GAME_CONST_HALF_ARENA_CLEAR_ZONE),
 	GAME_CONST_BUFFERED_STATES = 3,
 	GAME_CONST_TICK_RATE_MS = 30,
+	GAME_CONST_MAX_STALE_TICKS = 5000 / GAME_CONST_TICK_RATE_MS,
+	GAME_CONST_PROFILE_DUMP_TICKS = 10000 / GAME_CONST_TICK_RATE_MS,
+	GAME_CONST_STATS_WINDOW_TICKS = 1000 / GAME_CONST_TICK_RATE_MS,
+	GAME_CONST_TICK_MAX_CATCH_UP = 4,
+	GAME_CONST_SERVER_OUTBOUND_SIZE = GAME_CONST_SERVER_PACKET_SIZE << 1,
+	GAME_CONST_SERVER_URING_BUFS = 1024,
+	GAME_CONST_SNAPSHOT_HISTORY = 32,
+	GAME_CONST_ENTITY_HISTORY_TICKS = 500 / GAME_CONST_TICK_RATE_MS,
+	GAME_CONST_SNAPSHOT_BUDGET = 2048,
+	GAME_CONST_MAX_BROADCASTS = 16,
+	GAME_CONST_BROADCAST_PACKETS = 4,
+	GAME_CONST_BROADCAST_KEYFRAME_TICKS = 1000 / GAME_CONST_TICK_RATE_MS,
 	GAME_CONST_MAX_PLAYER_BARRELS = 8,
 	GAME_CONST_MAX_PLAYER_BULLETS = 90,
 	GAME_CONST_MAX_PLAYER_NAME_LENGTH = 16,
@@ -99,6 +112,9 @@ EntityFlags;
 typedef enum ClientOpCode
 {
 	CLIENT_OPCODE_INPUT,
+	CLIENT_OPCODE_ACK,
+	CLIENT_OPCODE_PING,
+	CLIENT_OPCODE_SPECTATE,
 	MACRO_ENUM_BITS(CLIENT_OPCODE)
 }
 ClientOpCode;
@@ -107,11 +123,23 @@ ClientOpCode;
 typedef enum ServerOpCode
 {
 	SERVER_OPCODE_UPDATE,
+	SERVER_OPCODE_PONG,
 	MACRO_ENUM_BITS(SERVER_OPCODE)
 }
 ServerOpCode;
 
 
+typedef enum EntityRecord
+{
+	ENTITY_RECORD_CREATE,
+	ENTITY_RECORD_UPDATE,
+	ENTITY_RECORD_REMOVE,
+	ENTITY_RECORD_REPLACE,
+	MACRO_ENUM_BITS(ENTITY_RECORD)
+}
+EntityRecord;
+
+
 typedef enum EntityType
 {
 	ENTITY_TYPE_TANK,
@@ -145,16 +173,6 @@ extern const uint32_t ShapeHPBits[];
 
 extern const uint32_t TypeToSubtypeBits[];
 
-typedef enum FieldSize
-{
-	FIELD_SIZE_TICK_DURATION = 51,
-	FIELD_SIZE_MOUSE_X = 11,
-	FIELD_SIZE_MOUSE_Y = 11,
-	FIELD_SIZE_FOV = 12
-}
-FieldSize;
-
-
 #define FIXED_POINT(name) FIXED_POINT_INTEGER_##name, FIXED_POINT_FRACTION_##name
 #define DEF_FIXED_POINT(name, Integer, Fraction)	\
 FIXED_POINT_INTEGER_##name = Integer,				\
@@ -170,3 +188,20 @@ typedef enum FixedPoint
 FixedPoint;
 
 #undef DEF_FIXED_POINT
+
+
+typedef enum FieldSize
+{
+	FIELD_SIZE_TICK_DURATION = 51,
+	FIELD_SIZE_MOUSE_X = 11,
+	FIELD_SIZE_MOUSE_Y = 11,
+	FIELD_SIZE_FOV = 12,
+	FIELD_SIZE_SNAPSHOT_SEQ = 16,
+	FIELD_SIZE_POSITION = 1 + GAME_CONST_POSITION_INTEGER_BITS + FIXED_POINT_FRACTION_POS,
+	FIELD_SIZE_POSITION_DELTA = 6,
+	FIELD_SIZE_INDEX_DELTA = 4,
+	FIELD_SIZE_RECORD_COUNT = 8,
+	FIELD_SIZE_ENTITY_INDEX = 32,
+	FIELD_SIZE_PING_TIME = 64
+}
+FieldSize;
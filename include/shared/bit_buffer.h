@@ -26,6 +26,8 @@ typedef struct bit_buffer
 
 	uint64_t len;
 	uint64_t bit;
+
+	uint8_t* written;
 }
 bit_buffer_t;
 
@@ -334,6 +336,23 @@ bit_buffer_len_bytes(
 	);
 
 
+extern void
+bit_buffer_copy_bits(
+	bit_buffer_t* bit_buffer,
+	bit_buffer_t* src,
+	uint64_t bits
+	);
+
+
+extern void
+bit_buffer_copy_bits_safe(
+	bit_buffer_t* bit_buffer,
+	bit_buffer_t* src,
+	uint64_t bits,
+	bool* status
+	);
+
+
 extern void
 bit_buffer_set_str(
 	bit_buffer_t* bit_buffer,
@@ -359,3 +378,151 @@ extern uint64_t
 bit_buffer_len_str(
 	uint64_t len
 	);
+
+
+extern void
+bit_buffer_set_bits_array(
+	bit_buffer_t* bit_buffer,
+	const uint32_t* values,
+	uint32_t count,
+	uint64_t bits
+	);
+
+
+extern void
+bit_buffer_get_bits_array(
+	bit_buffer_t* bit_buffer,
+	uint32_t* values,
+	uint32_t count,
+	uint64_t bits
+	);
+
+
+extern void
+bit_buffer_get_bits_array_safe(
+	bit_buffer_t* bit_buffer,
+	uint32_t* values,
+	uint32_t count,
+	uint64_t bits,
+	bool* status
+	);
+
+
+extern uint64_t
+bit_buffer_len_bits_array(
+	uint32_t count,
+	uint64_t bits
+	);
+
+
+extern void
+bit_buffer_set_signed_bits_array(
+	bit_buffer_t* bit_buffer,
+	const int32_t* values,
+	uint32_t count,
+	uint64_t bits
+	);
+
+
+extern void
+bit_buffer_get_signed_bits_array(
+	bit_buffer_t* bit_buffer,
+	int32_t* values,
+	uint32_t count,
+	uint64_t bits
+	);
+
+
+extern void
+bit_buffer_get_signed_bits_array_safe(
+	bit_buffer_t* bit_buffer,
+	int32_t* values,
+	uint32_t count,
+	uint64_t bits,
+	bool* status
+	);
+
+
+extern uint64_t
+bit_buffer_len_signed_bits_array(
+	uint32_t count,
+	uint64_t bits
+	);
+
+
+extern void
+bit_buffer_set_fixed_point_array(
+	bit_buffer_t* bit_buffer,
+	const float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	);
+
+
+extern void
+bit_buffer_get_fixed_point_array(
+	bit_buffer_t* bit_buffer,
+	float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	);
+
+
+extern void
+bit_buffer_get_fixed_point_array_safe(
+	bit_buffer_t* bit_buffer,
+	float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits,
+	bool* status
+	);
+
+
+extern uint64_t
+bit_buffer_len_fixed_point_array(
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	);
+
+
+extern void
+bit_buffer_set_signed_fixed_point_array(
+	bit_buffer_t* bit_buffer,
+	const float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	);
+
+
+extern void
+bit_buffer_get_signed_fixed_point_array(
+	bit_buffer_t* bit_buffer,
+	float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	);
+
+
+extern void
+bit_buffer_get_signed_fixed_point_array_safe(
+	bit_buffer_t* bit_buffer,
+	float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits,
+	bool* status
+	);
+
+
+extern uint64_t
+bit_buffer_len_signed_fixed_point_array(
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	);
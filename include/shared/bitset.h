@@ -0,0 +1,165 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <shared/alloc.h>
+
+#include <stdint.h>
+
+
+#define BITSET_WORD_BITS 64
+
+
+typedef struct bitset
+{
+	uint64_t* words;
+	uint32_t word_count;
+}
+bitset_t;
+
+
+typedef enum bitset_change : uint8_t
+{
+	BITSET_CHANGE_ENTERED,
+	BITSET_CHANGE_STAYED,
+	BITSET_CHANGE_LEFT
+}
+bitset_change_t;
+
+
+typedef struct bitset_diff_iter
+{
+	const uint64_t* old_words;
+	const uint64_t* new_words;
+	uint32_t word;
+	uint32_t word_count;
+
+	uint64_t entered;
+	uint64_t stayed;
+	uint64_t left;
+}
+bitset_diff_iter_t;
+
+
+extern void
+bitset_init(
+	bitset_t* set,
+	uint32_t bits
+	);
+
+
+extern void
+bitset_resize(
+	bitset_t* set,
+	uint32_t bits
+	);
+
+
+extern void
+bitset_free(
+	bitset_t* set
+	);
+
+
+extern void
+bitset_clear(
+	bitset_t* set
+	);
+
+
+_inline_ void
+bitset_set(
+	bitset_t* set,
+	uint32_t bit
+	)
+{
+	set->words[bit / BITSET_WORD_BITS] |= UINT64_C(1) << (bit % BITSET_WORD_BITS);
+}
+
+
+_inline_ void
+bitset_unset(
+	bitset_t* set,
+	uint32_t bit
+	)
+{
+	set->words[bit / BITSET_WORD_BITS] &= ~(UINT64_C(1) << (bit % BITSET_WORD_BITS));
+}
+
+
+_inline_ bool
+bitset_get(
+	const bitset_t* set,
+	uint32_t bit
+	)
+{
+	return (set->words[bit / BITSET_WORD_BITS] >> (bit % BITSET_WORD_BITS)) & 1;
+}
+
+
+extern uint32_t
+bitset_count(
+	const bitset_t* set
+	);
+
+
+extern void
+bitset_and(
+	bitset_t* dst,
+	const bitset_t* a,
+	const bitset_t* b
+	);
+
+
+extern void
+bitset_andnot(
+	bitset_t* dst,
+	const bitset_t* a,
+	const bitset_t* b
+	);
+
+
+extern void
+bitset_or(
+	bitset_t* dst,
+	const bitset_t* a,
+	const bitset_t* b
+	);
+
+
+extern bool
+bitset_next(
+	const bitset_t* set,
+	uint32_t* bit
+	);
+
+
+extern void
+bitset_diff_init(
+	bitset_diff_iter_t* iter,
+	const bitset_t* old_set,
+	const bitset_t* new_set
+	);
+
+
+extern bool
+bitset_diff_next(
+	bitset_diff_iter_t* iter,
+	uint32_t* bit,
+	bitset_change_t* change
+	);
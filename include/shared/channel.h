@@ -0,0 +1,204 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <shared/bit_buffer.h>
+
+#define CHANNEL_SENT_WINDOW 256
+#define CHANNEL_RELIABLE_WINDOW 64
+#define CHANNEL_MAX_MESSAGE_SIZE 255
+#define CHANNEL_LINK_CAPACITY 256
+#define CHANNEL_LINK_MTU 1400
+
+#define CHANNEL_SEQ_BITS 16
+#define CHANNEL_ACK_BITS 32
+#define CHANNEL_COUNT_BITS MACRO_GET_BITS_CONST(CHANNEL_RELIABLE_WINDOW + 1)
+#define CHANNEL_LEN_BITS 8
+#define CHANNEL_HEADER_BITS (CHANNEL_SEQ_BITS * 2 + 1 + CHANNEL_ACK_BITS + CHANNEL_COUNT_BITS)
+
+/* A header without any reliable messages in it */
+#define CHANNEL_HEADER_SIZE MACRO_TO_BYTES(CHANNEL_HEADER_BITS)
+
+
+typedef struct channel_sent
+{
+	uint16_t seq;
+	bool valid;
+	bool acked;
+
+	uint16_t msg_first;
+	uint16_t msg_count;
+}
+channel_sent_t;
+
+
+typedef struct channel_msg
+{
+	bool used;
+	uint16_t id;
+	uint8_t len;
+	uint8_t data[CHANNEL_MAX_MESSAGE_SIZE];
+}
+channel_msg_t;
+
+
+typedef struct channel
+{
+	uint16_t local_seq;
+
+	uint16_t remote_seq;
+	uint32_t remote_ack_bits;
+	bool received_any;
+
+	uint16_t acked_seq;
+	bool acked_any;
+
+	channel_sent_t sent[CHANNEL_SENT_WINDOW];
+
+	uint16_t out_oldest;
+	uint16_t out_next;
+	channel_msg_t out[CHANNEL_RELIABLE_WINDOW];
+
+	uint16_t in_next;
+	channel_msg_t in[CHANNEL_RELIABLE_WINDOW];
+}
+channel_t;
+
+
+typedef struct channel_packet_info
+{
+	uint16_t seq;
+	bool fresh;
+	bool duplicate;
+}
+channel_packet_info_t;
+
+
+extern void
+channel_init(
+	channel_t* channel
+	);
+
+
+extern bool
+channel_seq_greater(
+	uint16_t a,
+	uint16_t b
+	);
+
+
+extern void
+channel_send_reliable(
+	channel_t* channel,
+	const void* data,
+	uint32_t len,
+	bool* status
+	);
+
+
+extern bool
+channel_recv_reliable(
+	channel_t* channel,
+	void* data,
+	uint32_t* len
+	);
+
+
+extern uint32_t
+channel_reliable_pending(
+	channel_t* channel
+	);
+
+
+extern uint16_t
+channel_write_header(
+	channel_t* channel,
+	bit_buffer_t* bit_buffer,
+	uint32_t reliable_budget
+	);
+
+
+extern void
+channel_read_header(
+	channel_t* channel,
+	bit_buffer_t* bit_buffer,
+	channel_packet_info_t* info,
+	bool* status
+	);
+
+
+extern bool
+channel_is_acked(
+	channel_t* channel,
+	uint16_t seq
+	);
+
+
+extern bool
+channel_last_acked(
+	channel_t* channel,
+	uint16_t* seq
+	);
+
+
+typedef struct channel_datagram
+{
+	uint64_t deliver_at;
+	uint32_t len;
+	uint8_t data[CHANNEL_LINK_MTU];
+}
+channel_datagram_t;
+
+
+typedef struct channel_link
+{
+	float loss;
+	uint64_t latency;
+	uint64_t jitter;
+
+	uint32_t used;
+	channel_datagram_t datagrams[CHANNEL_LINK_CAPACITY];
+}
+channel_link_t;
+
+
+extern void
+channel_link_init(
+	channel_link_t* link,
+	float loss,
+	uint64_t latency,
+	uint64_t jitter
+	);
+
+
+extern void
+channel_link_send(
+	channel_link_t* link,
+	uint64_t now,
+	const void* data,
+	uint32_t len
+	);
+
+
+extern bool
+channel_link_recv(
+	channel_link_t* link,
+	uint64_t now,
+	void* data,
+	uint32_t* len
+	);
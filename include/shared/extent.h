@@ -118,6 +118,68 @@ typedef struct rect_extent
 rect_extent_t;
 
 
+typedef union half_extent_f64
+{
+	struct
+	{
+		double x;
+		double y;
+		double w;
+		double h;
+	};
+
+	struct
+	{
+		double top;
+		double left;
+		double right;
+		double bottom;
+	};
+}
+half_extent_f64_t;
+
+
+typedef struct rect_extent_f64
+{
+	double min_x;
+	double min_y;
+	double max_x;
+	double max_y;
+}
+rect_extent_f64_t;
+
+
+typedef union half_extent_i32
+{
+	struct
+	{
+		int32_t x;
+		int32_t y;
+		int32_t w;
+		int32_t h;
+	};
+
+	struct
+	{
+		int32_t top;
+		int32_t left;
+		int32_t right;
+		int32_t bottom;
+	};
+}
+half_extent_i32_t;
+
+
+typedef struct rect_extent_i32
+{
+	int32_t min_x;
+	int32_t min_y;
+	int32_t max_x;
+	int32_t max_y;
+}
+rect_extent_i32_t;
+
+
 extern bool
 rect_extent_intersects(
 	rect_extent_t a,
@@ -142,3 +204,41 @@ extern half_extent_t
 rect_to_half_extent(
 	rect_extent_t extent
 	);
+
+
+extern bool
+rect_extent_f64_intersects(
+	rect_extent_f64_t a,
+	rect_extent_f64_t b
+	);
+
+
+extern rect_extent_f64_t
+half_to_rect_extent_f64(
+	half_extent_f64_t extent
+	);
+
+
+extern half_extent_f64_t
+rect_to_half_extent_f64(
+	rect_extent_f64_t extent
+	);
+
+
+extern bool
+rect_extent_i32_intersects(
+	rect_extent_i32_t a,
+	rect_extent_i32_t b
+	);
+
+
+extern rect_extent_i32_t
+half_to_rect_extent_i32(
+	half_extent_i32_t extent
+	);
+
+
+extern half_extent_i32_t
+rect_to_half_extent_i32(
+	rect_extent_i32_t extent
+	);
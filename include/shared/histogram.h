@@ -0,0 +1,69 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS)
+
+
+typedef struct histogram
+{
+	uint64_t count;
+	uint64_t sum;
+	uint64_t min;
+	uint64_t max;
+
+	uint64_t buckets[HISTOGRAM_BUCKETS];
+}
+histogram_t;
+
+
+extern void
+histogram_reset(
+	histogram_t* histogram
+	);
+
+
+extern void
+histogram_record(
+	histogram_t* histogram,
+	uint64_t value
+	);
+
+
+extern void
+histogram_merge(
+	histogram_t* histogram,
+	const histogram_t* other
+	);
+
+
+extern uint64_t
+histogram_percentile(
+	const histogram_t* histogram,
+	double percentile
+	);
+
+
+extern uint64_t
+histogram_mean(
+	const histogram_t* histogram
+	);
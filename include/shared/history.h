@@ -0,0 +1,122 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <shared/extent.h>
+
+#include <stdint.h>
+
+
+#define HISTORY_FRACTION_BITS 4
+
+
+/*
+ * The last length ticks of every entity's bounds, one slab per tick with
+ * one array per field. Positions and half extents are kept in fixed point
+ * with HISTORY_FRACTION_BITS of fraction.
+ */
+typedef struct history
+{
+	int32_t* x;
+	int32_t* y;
+	uint16_t* w;
+	uint16_t* h;
+
+	uint32_t* counts;
+	uint32_t* spread;
+	uint64_t* born;
+	uint32_t* settled;
+
+	uint32_t length;
+	uint32_t capacity;
+	uint32_t recorded;
+	uint64_t tick;
+}
+history_t;
+
+
+extern void
+history_init(
+	history_t* history,
+	uint32_t length,
+	uint32_t capacity
+	);
+
+
+extern void
+history_free(
+	history_t* history
+	);
+
+
+extern void
+history_resize(
+	history_t* history,
+	uint32_t capacity
+	);
+
+
+extern void
+history_spawn(
+	history_t* history,
+	uint32_t idx
+	);
+
+
+extern void
+history_record(
+	history_t* history,
+	uint64_t tick,
+	const float* x,
+	const float* y,
+	const float* w,
+	const float* h,
+	uint32_t count
+	);
+
+
+extern bool
+history_has(
+	const history_t* history,
+	uint64_t tick
+	);
+
+
+extern float
+history_spread(
+	const history_t* history,
+	uint64_t tick
+	);
+
+
+extern bool
+history_get(
+	const history_t* history,
+	uint64_t tick,
+	uint32_t idx,
+	half_extent_t* extent
+	);
+
+
+extern bool
+history_intersects(
+	const history_t* history,
+	uint64_t tick,
+	uint32_t idx,
+	rect_extent_t extent
+	);
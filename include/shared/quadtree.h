@@ -18,9 +18,66 @@
 
 #include <shared/macro.h>
 #include <shared/extent.h>
+#include <shared/history.h>
 
 #define QUADTREE_DEDUPE_COLLISIONS 1
 
+#define QUADTREE_COORD_F32 0
+#define QUADTREE_COORD_F64 1
+#define QUADTREE_COORD_FIXED 2
+
+#ifndef quadtree_coord
+	#define quadtree_coord QUADTREE_COORD_F32
+#endif
+
+#ifndef quadtree_fixed_fraction_bits
+	#define quadtree_fixed_fraction_bits 8
+#endif
+
+
+#if quadtree_coord == QUADTREE_COORD_F32
+	typedef float quadtree_coord_t;
+	typedef float quadtree_dist_t;
+
+	typedef half_extent_t quadtree_half_extent_t;
+	typedef rect_extent_t quadtree_rect_extent_t;
+
+	#define quadtree_coord_from_f32(value) (value)
+	#define quadtree_coord_to_f32(coord) (coord)
+#elif quadtree_coord == QUADTREE_COORD_F64
+	typedef double quadtree_coord_t;
+	typedef double quadtree_dist_t;
+
+	typedef half_extent_f64_t quadtree_half_extent_t;
+	typedef rect_extent_f64_t quadtree_rect_extent_t;
+
+	#define quadtree_coord_from_f32(value) ((double)(value))
+	#define quadtree_coord_to_f32(coord) ((float)(coord))
+#elif quadtree_coord == QUADTREE_COORD_FIXED
+	/*
+	 * Signed 32-bit with quadtree_fixed_fraction_bits of fraction. All math
+	 * is integer, so results are bit-exact on every machine. Coordinates of
+	 * entities, queries and the tree itself must stay within +-(2^30 - 1)
+	 * raw, so that a difference stays below 2^31 and the sum of two squared
+	 * differences stays below 2^63, the limit of quadtree_dist_t.
+	 */
+	typedef int32_t quadtree_coord_t;
+	typedef int64_t quadtree_dist_t;
+
+	typedef half_extent_i32_t quadtree_half_extent_t;
+	typedef rect_extent_i32_t quadtree_rect_extent_t;
+
+	#define quadtree_coord_from_f32(value)						\
+	((quadtree_coord_t)(										\
+		(value) * (float)(1 << quadtree_fixed_fraction_bits) +	\
+		((value) < 0 ? -0.5f : 0.5f)))
+
+	#define quadtree_coord_to_f32(coord)	\
+	((float)(coord) / (float)(1 << quadtree_fixed_fraction_bits))
+#else
+	#error "Unknown quadtree_coord"
+#endif
+
 
 typedef enum quadtree_node_type
 {
@@ -52,7 +109,7 @@ quadtree_node_t;
 
 	typedef struct quadtree_entity_data
 	{
-		rect_extent_t rect_extent;
+		quadtree_rect_extent_t rect_extent;
 	}
 	quadtree_entity_data_t;
 
@@ -98,7 +155,7 @@ quadtree_get_entity_data_rect_extent((entity)->data)
 typedef struct quadtree_node_info
 {
 	uint32_t node_idx;
-	half_extent_t extent;
+	quadtree_half_extent_t extent;
 }
 quadtree_node_info_t;
 
@@ -219,7 +276,7 @@ struct quadtree
 	uint32_t max_depth;
 	uint32_t dfs_length;
 	uint32_t merge_ht_size;
-	float min_size;
+	quadtree_coord_t min_size;
 
 	quadtree_node_t* nodes;
 	quadtree_node_entities_t node_entities;
@@ -233,6 +290,15 @@ struct quadtree
 	quadtree_reinsertion_t* reinsertions;
 	uint32_t* merge_ht;
 
+	/* Kept across calls so that a steady state tree does not allocate */
+	quadtree_node_t* spare_nodes;
+	quadtree_node_entities_t spare_node_entities;
+	quadtree_entity_t* spare_entities;
+	uint32_t* entity_map;
+#if QUADTREE_DEDUPE_COLLISIONS == 1
+	uint32_t* ht;
+#endif
+
 	uint32_t nodes_used;
 	uint32_t nodes_size;
 
@@ -259,14 +325,22 @@ struct quadtree
 	uint32_t reinsertions_used;
 	uint32_t reinsertions_size;
 
+	uint32_t spare_nodes_size;
+	uint32_t spare_node_entities_size;
+	uint32_t spare_entities_size;
+	uint32_t entity_map_size;
+#if QUADTREE_DEDUPE_COLLISIONS == 1
+	uint32_t ht_size;
+#endif
+
 	uint32_t query_tick;
 	uint8_t update_tick;
 
 	quadtree_normalized_t normalization;
 	bool merge_threshold_set;
 
-	rect_extent_t rect_extent;
-	half_extent_t half_extent;
+	quadtree_rect_extent_t rect_extent;
+	quadtree_half_extent_t half_extent;
 };
 
 
@@ -313,7 +387,7 @@ quadtree_update(
 extern void
 quadtree_query_rect(
 	quadtree_t* qt,
-	rect_extent_t extent,
+	quadtree_rect_extent_t extent,
 	quadtree_query_fn_t query_fn,
 	void* user_data
 	);
@@ -322,18 +396,36 @@ quadtree_query_rect(
 extern void
 quadtree_query_circle(
 	quadtree_t* qt,
-	float x,
-	float y,
-	float radius,
+	quadtree_coord_t x,
+	quadtree_coord_t y,
+	quadtree_coord_t radius,
 	quadtree_query_fn_t query_fn,
 	void* user_data
 	);
 
 
+#ifdef quadtree_get_entity_data_idx
+	/*
+	 * Entities that overlapped the extent at a past tick, as recorded in
+	 * the history under the index quadtree_get_entity_data_idx() returns.
+	 * Only entities still in the tree are found.
+	 */
+	extern void
+	quadtree_query_rect_at(
+		quadtree_t* qt,
+		const history_t* history,
+		uint64_t tick,
+		quadtree_rect_extent_t extent,
+		quadtree_query_fn_t query_fn,
+		void* user_data
+		);
+#endif
+
+
 extern void
 quadtree_query_nodes_rect(
 	quadtree_t* qt,
-	rect_extent_t extent,
+	quadtree_rect_extent_t extent,
 	quadtree_node_query_fn_t node_query_fn,
 	void* user_data
 	);
@@ -342,9 +434,9 @@ quadtree_query_nodes_rect(
 extern void
 quadtree_query_nodes_circle(
 	quadtree_t* qt,
-	float x,
-	float y,
-	float radius,
+	quadtree_coord_t x,
+	quadtree_coord_t y,
+	quadtree_coord_t radius,
 	quadtree_node_query_fn_t node_query_fn,
 	void* user_data
 	);
@@ -364,10 +456,17 @@ quadtree_depth(
 	);
 
 
+/* Bytes held by the tree's buffers, which only ever grow */
+extern uint64_t
+quadtree_memory_usage(
+	const quadtree_t* qt
+	);
+
+
 extern void
 quadtree_nearest_rect(
 	quadtree_t* qt,
-	rect_extent_t extent,
+	quadtree_rect_extent_t extent,
 	uint32_t max_results,
 	quadtree_query_fn_t query_fn,
 	void* user_data
@@ -377,9 +476,9 @@ quadtree_nearest_rect(
 extern void
 quadtree_nearest_circle(
 	quadtree_t* qt,
-	float x,
-	float y,
-	float max_distance,
+	quadtree_coord_t x,
+	quadtree_coord_t y,
+	quadtree_coord_t max_distance,
 	uint32_t max_results,
 	quadtree_query_fn_t query_fn,
 	void* user_data
@@ -389,10 +488,10 @@ quadtree_nearest_circle(
 extern void
 quadtree_raycast(
 	quadtree_t* qt,
-	float x,
-	float y,
-	float dx,
-	float dy,
+	quadtree_coord_t x,
+	quadtree_coord_t y,
+	quadtree_coord_t dx,
+	quadtree_coord_t dy,
 	quadtree_query_fn_t query_fn,
 	void* user_data
 	);
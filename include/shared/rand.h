@@ -25,6 +25,12 @@ rand_set_seed(
 	);
 
 
+extern uint32_t
+rand_get_seed(
+	void
+	);
+
+
 extern uint32_t
 rand_u32(
 	void
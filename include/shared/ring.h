@@ -0,0 +1,159 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+
+typedef struct ring
+{
+	uint8_t* data;
+	uint32_t size;
+	uint32_t head;
+	uint32_t tail;
+	bool mirrored;
+}
+ring_t;
+
+
+typedef struct ring_segment
+{
+	uint8_t* data;
+	uint32_t len;
+}
+ring_segment_t;
+
+
+extern void
+ring_init(
+	ring_t* ring,
+	uint32_t size
+	);
+
+
+extern void
+ring_init_mirrored(
+	ring_t* ring,
+	uint32_t size
+	);
+
+
+extern void
+ring_free(
+	ring_t* ring
+	);
+
+
+extern void
+ring_reset(
+	ring_t* ring
+	);
+
+
+extern uint32_t
+ring_used(
+	ring_t* ring
+	);
+
+
+extern uint32_t
+ring_available(
+	ring_t* ring
+	);
+
+
+extern void
+ring_write(
+	ring_t* ring,
+	const void* data,
+	uint32_t len
+	);
+
+
+extern void
+ring_write_safe(
+	ring_t* ring,
+	const void* data,
+	uint32_t len,
+	bool* status
+	);
+
+
+extern void
+ring_peek(
+	ring_t* ring,
+	void* data,
+	uint32_t len
+	);
+
+
+extern void
+ring_read(
+	ring_t* ring,
+	void* data,
+	uint32_t len
+	);
+
+
+extern void
+ring_read_safe(
+	ring_t* ring,
+	void* data,
+	uint32_t len,
+	bool* status
+	);
+
+
+extern void
+ring_consume(
+	ring_t* ring,
+	uint32_t len
+	);
+
+
+extern void
+ring_produce(
+	ring_t* ring,
+	uint32_t len
+	);
+
+
+extern uint32_t
+ring_read_segments(
+	ring_t* ring,
+	ring_segment_t segments[2]
+	);
+
+
+extern uint32_t
+ring_write_segments(
+	ring_t* ring,
+	ring_segment_t segments[2]
+	);
+
+
+extern uint8_t*
+ring_read_ptr(
+	ring_t* ring
+	);
+
+
+extern uint8_t*
+ring_write_ptr(
+	ring_t* ring
+	);
@@ -0,0 +1,69 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__AVX2__)
+	#define SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(__ARM_NEON)
+	#define SIMD_WIDTH 4
+#else
+	#define SIMD_WIDTH 1
+#endif
+
+
+typedef float simd_f32_t __attribute__((vector_size(SIMD_WIDTH * 4), aligned(4), may_alias));
+typedef int32_t simd_i32_t __attribute__((vector_size(SIMD_WIDTH * 4), aligned(4), may_alias));
+typedef uint32_t simd_u32_t __attribute__((vector_size(SIMD_WIDTH * 4), aligned(4), may_alias));
+
+
+extern void
+simd_sincos(
+	const float* angle,
+	float* sin,
+	float* cos,
+	uint32_t count
+	);
+
+
+extern void
+simd_lerp(
+	float* value,
+	const float* target,
+	float by,
+	uint32_t count
+	);
+
+
+extern void
+simd_lerp_to(
+	float* value,
+	float target,
+	float by,
+	uint32_t count
+	);
+
+
+extern void
+simd_clamp(
+	float* value,
+	float min,
+	float max,
+	uint32_t count
+	);
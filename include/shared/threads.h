@@ -120,6 +120,13 @@ thread_sleep(
 	);
 
 
+extern bool
+thread_set_affinity(
+	thread_t thread,
+	uint32_t cpu
+	);
+
+
 typedef struct threads
 {
 	thread_t* threads;
@@ -100,6 +100,12 @@ time_get(
 	);
 
 
+extern uint64_t
+time_get_monotonic(
+	void
+	);
+
+
 extern uint64_t
 time_get_with_sec(
 	uint64_t sec
@@ -124,6 +130,45 @@ time_get_with_ns(
 	);
 
 
+typedef enum time_catch_up : uint8_t
+{
+	TIME_CATCH_UP_SKIP,
+	TIME_CATCH_UP_BOUNDED
+}
+time_catch_up_t;
+
+
+typedef struct time_scheduler
+{
+	uint64_t interval;
+	uint64_t spin;
+	uint32_t max_catch_up;
+	time_catch_up_t catch_up;
+
+	uint64_t next;
+	uint64_t ticks;
+	uint64_t overruns;
+	uint64_t skipped;
+}
+time_scheduler_t;
+
+
+extern void
+time_scheduler_init(
+	time_scheduler_t* scheduler,
+	uint64_t interval,
+	time_catch_up_t catch_up,
+	uint32_t max_catch_up,
+	uint64_t spin
+	);
+
+
+extern uint64_t
+time_scheduler_wait(
+	time_scheduler_t* scheduler
+	);
+
+
 typedef struct time_timer
 {
 	uint32_t idx;
@@ -0,0 +1,131 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+
+typedef struct uring
+{
+	int fd;
+
+	void* ring;
+	uint64_t ring_size;
+	void* sqes;
+	uint64_t sqes_size;
+
+	uint32_t* sq_head;
+	uint32_t* sq_tail;
+	uint32_t sq_mask;
+	uint32_t sq_pending;
+
+	uint32_t* cq_head;
+	uint32_t* cq_tail;
+	uint32_t cq_mask;
+	void* cqes;
+
+	void* buf_ring;
+	uint64_t buf_ring_size;
+	uint8_t* bufs;
+	uint32_t buf_count;
+	uint32_t buf_size;
+}
+uring_t;
+
+
+typedef struct uring_event
+{
+	uint64_t user_data;
+	int32_t res;
+
+	bool more;
+
+	uint8_t* buf;
+	uint16_t buf_id;
+}
+uring_event_t;
+
+
+extern bool
+uring_init(
+	uring_t* uring,
+	uint32_t entries,
+	uint32_t buf_count,
+	uint32_t buf_size
+	);
+
+
+extern void
+uring_free(
+	uring_t* uring
+	);
+
+
+extern bool
+uring_accept_multishot(
+	uring_t* uring,
+	int fd,
+	uint64_t user_data
+	);
+
+
+extern bool
+uring_recv_multishot(
+	uring_t* uring,
+	int fd,
+	uint64_t user_data
+	);
+
+
+extern bool
+uring_send(
+	uring_t* uring,
+	int fd,
+	const void* data,
+	uint32_t len,
+	uint64_t user_data
+	);
+
+
+extern bool
+uring_cancel(
+	uring_t* uring,
+	uint64_t target_user_data,
+	uint64_t user_data
+	);
+
+
+extern uint32_t
+uring_submit(
+	uring_t* uring,
+	uint32_t wait
+	);
+
+
+extern bool
+uring_next_event(
+	uring_t* uring,
+	uring_event_t* event
+	);
+
+
+extern void
+uring_return_buf(
+	uring_t* uring,
+	uint16_t buf_id
+	);
@@ -28,4 +28,5 @@ typedef struct qt_dyn_test_entity_data
 qt_dyn_test_entity_data_t;
 
 #define quadtree_entity_data qt_dyn_test_entity_data_t
+#define quadtree_get_entity_data_idx(entity) (entity).idx
 #include <shared/quadtree.h>
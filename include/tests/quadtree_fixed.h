@@ -0,0 +1,30 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <shared/extent.h>
+
+typedef struct qt_fixed_test_entity_data
+{
+	rect_extent_i32_t rect_extent;
+	uint32_t idx;
+}
+qt_fixed_test_entity_data_t;
+
+#define quadtree_coord QUADTREE_COORD_FIXED
+#define quadtree_entity_data qt_fixed_test_entity_data_t
+#include <shared/quadtree.h>
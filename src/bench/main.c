@@ -0,0 +1,467 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/rand.h>
+#include <shared/simd.h>
+#include <shared/time.h>
+#include <shared/debug.h>
+#include <shared/history.h>
+#include <shared/bit_buffer.h>
+#include <shared/options.h>
+#include <shared/alloc_ext.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+
+typedef struct bench
+{
+	const char* name;
+	void (*fn)(uint32_t count);
+}
+bench_t;
+
+
+private float* bench_in;
+private float* bench_out_a;
+private float* bench_out_b;
+private uint32_t bench_iterations;
+private volatile float bench_sink;
+
+
+private void
+bench_report(
+	const char* name,
+	const char* variant,
+	uint64_t ns,
+	uint32_t count,
+	uint64_t baseline_ns
+	)
+{
+	double per_element = (double) ns / ((double) count * bench_iterations);
+
+	if(baseline_ns)
+	{
+		printf("%-12s %-10s %8.3f ns/elem %7.2fx\n", name, variant, per_element, (double) baseline_ns / ns);
+	}
+	else
+	{
+		printf("%-12s %-10s %8.3f ns/elem\n", name, variant, per_element);
+	}
+}
+
+
+private void
+bench_report_bits(
+	const char* name,
+	const char* variant,
+	uint64_t ns,
+	uint32_t count,
+	uint64_t bits
+	)
+{
+	double per_element = (double) ns / ((double) count * bench_iterations);
+	double per_ns = (double) bits * bench_iterations / ns;
+
+	printf("%-12s %-10s %8.3f ns/elem %7.2f bits/ns\n", name, variant, per_element, per_ns);
+}
+
+
+private void
+bench_fill(
+	uint32_t count,
+	float range
+	)
+{
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		bench_in[i] = (rand_f32() * 2.0f - 1.0f) * range;
+		bench_out_a[i] = bench_in[i];
+		bench_out_b[i] = bench_in[i];
+	}
+}
+
+
+private void
+bench_sincos(
+	uint32_t count
+	)
+{
+	bench_fill(count, M_PI);
+
+	uint64_t start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			bench_out_a[i] = sinf(bench_in[i]);
+			bench_out_b[i] = cosf(bench_in[i]);
+		}
+
+		bench_sink = bench_out_a[j % count] + bench_out_b[j % count];
+	}
+
+	uint64_t libm_ns = time_get_monotonic() - start;
+	bench_report("sincos", "libm", libm_ns, count, 0);
+
+	start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		simd_sincos(bench_in, bench_out_a, bench_out_b, count);
+
+		bench_sink = bench_out_a[j % count] + bench_out_b[j % count];
+	}
+
+	bench_report("sincos", "simd", time_get_monotonic() - start, count, libm_ns);
+}
+
+
+private void
+bench_lerp(
+	uint32_t count
+	)
+{
+	bench_fill(count, 1000.0f);
+
+	uint64_t start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			bench_out_a[i] += (bench_in[i] - bench_out_a[i]) * 0.095f;
+		}
+
+		bench_sink = bench_out_a[j % count];
+	}
+
+	uint64_t scalar_ns = time_get_monotonic() - start;
+	bench_report("lerp", "scalar", scalar_ns, count, 0);
+
+	start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		simd_lerp(bench_out_b, bench_in, 0.095f, count);
+
+		bench_sink = bench_out_b[j % count];
+	}
+
+	bench_report("lerp", "simd", time_get_monotonic() - start, count, scalar_ns);
+}
+
+
+private void
+bench_clamp(
+	uint32_t count
+	)
+{
+	bench_fill(count, 1000.0f);
+
+	uint64_t start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			bench_out_a[i] = fminf(fmaxf(bench_in[i], -500.0f), 500.0f);
+		}
+
+		bench_sink = bench_out_a[j % count];
+	}
+
+	uint64_t scalar_ns = time_get_monotonic() - start;
+	bench_report("clamp", "scalar", scalar_ns, count, 0);
+
+	start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		(void) memcpy(bench_out_b, bench_in, sizeof(float) * count);
+		simd_clamp(bench_out_b, -500.0f, 500.0f, count);
+
+		bench_sink = bench_out_b[j % count];
+	}
+
+	bench_report("clamp", "simd+copy", time_get_monotonic() - start, count, scalar_ns);
+}
+
+
+private void
+bench_history(
+	uint32_t count
+	)
+{
+	bench_fill(count, 1000.0f);
+
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		bench_out_b[i] = 10.0f + fabsf(bench_in[i]) * 0.01f;
+	}
+
+	history_t history;
+	history_init(&history, 32, count);
+
+	uint64_t start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		bench_in[j % count] += 1.0f;
+		history_record(&history, j + 1, bench_in, bench_out_a, bench_out_b, bench_out_b, count);
+	}
+
+	bench_report("history", "record", time_get_monotonic() - start, count, 0);
+
+	rect_extent_t extent =
+	{
+		.min_x = -100.0f,
+		.min_y = -100.0f,
+		.max_x = 100.0f,
+		.max_y = 100.0f
+	};
+
+	uint32_t hits = 0;
+	start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		uint64_t tick = history.tick - j % history.recorded;
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			hits += history_intersects(&history, tick, i, extent);
+		}
+	}
+
+	bench_sink = hits;
+	bench_report("history", "filter", time_get_monotonic() - start, count, 0);
+
+	history_free(&history);
+}
+
+
+private void
+bench_bit_buffer(
+	uint32_t count
+	)
+{
+	/* Roughly what a snapshot mixes: flags, ids, quantized coords, sizes */
+	static const uint8_t widths[] = { 1, 2, 4, 7, 8, 12, 16, 21, 32, 64 };
+
+	uint8_t* field_bits = alloc_malloc(field_bits, count);
+	assert_not_null(field_bits);
+
+	uint64_t* values = alloc_malloc(values, count);
+	assert_not_null(values);
+
+	uint64_t total_bits = 0;
+
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		field_bits[i] = widths[rand_u32() % MACRO_ARRAY_LEN(widths)];
+		values[i] = ((uint64_t) rand_u32() << 32) | rand_u32();
+		total_bits += field_bits[i];
+	}
+
+	uint64_t len = MACRO_TO_BYTES(total_bits);
+	uint8_t* data = alloc_malloc(data, len);
+	assert_not_null(data);
+
+	bit_buffer_t buffer;
+	bit_buffer_set(&buffer, data, len);
+
+	uint64_t start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		/* Writes OR into the buffer, so it has to start out zeroed */
+		(void) memset(data, 0, len);
+		bit_buffer_reset(&buffer);
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			bit_buffer_set_bits(&buffer, values[i], field_bits[i]);
+		}
+	}
+
+	bench_report_bits("bit_buffer", "write", time_get_monotonic() - start, count, total_bits);
+
+	uint64_t sum = 0;
+	start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		bit_buffer_reset(&buffer);
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			sum += bit_buffer_get_bits(&buffer, field_bits[i]);
+		}
+	}
+
+	bench_sink = sum;
+	bench_report_bits("bit_buffer", "read", time_get_monotonic() - start, count, total_bits);
+
+	alloc_free(data, len);
+	alloc_free(values, count);
+	alloc_free(field_bits, count);
+}
+
+
+private void
+bench_bit_columns(
+	uint32_t count
+	)
+{
+	/* A column of coordinates, one field after another or all at once */
+	const uint64_t integer_bits = 14;
+	const uint64_t fraction_bits = 4;
+
+	bench_fill(count, 8000.0f);
+
+	uint64_t total_bits = bit_buffer_len_signed_fixed_point_array(count, integer_bits, fraction_bits);
+	uint64_t len = MACRO_TO_BYTES(total_bits);
+	uint8_t* data = alloc_malloc(data, len);
+	assert_not_null(data);
+
+	bit_buffer_t buffer;
+	bit_buffer_set(&buffer, data, len);
+
+	uint64_t start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		(void) memset(data, 0, len);
+		bit_buffer_reset(&buffer);
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			bit_buffer_set_signed_fixed_point(&buffer, bench_in[i], integer_bits, fraction_bits);
+		}
+	}
+
+	bench_report_bits("bit_columns", "write", time_get_monotonic() - start, count, total_bits);
+
+	start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		(void) memset(data, 0, len);
+		bit_buffer_reset(&buffer);
+
+		bit_buffer_set_signed_fixed_point_array(&buffer, bench_in, count, integer_bits, fraction_bits);
+	}
+
+	bench_report_bits("bit_columns", "write_arr", time_get_monotonic() - start, count, total_bits);
+
+	start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		bit_buffer_reset(&buffer);
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			bench_out_a[i] = bit_buffer_get_signed_fixed_point(&buffer, integer_bits, fraction_bits);
+		}
+	}
+
+	bench_report_bits("bit_columns", "read", time_get_monotonic() - start, count, total_bits);
+
+	start = time_get_monotonic();
+
+	for(uint32_t j = 0; j < bench_iterations; ++j)
+	{
+		bit_buffer_reset(&buffer);
+
+		bit_buffer_get_signed_fixed_point_array(&buffer, bench_out_b, count, integer_bits, fraction_bits);
+	}
+
+	bench_report_bits("bit_columns", "read_arr", time_get_monotonic() - start, count, total_bits);
+
+	hard_assert_false(memcmp(bench_out_a, bench_out_b, sizeof(*bench_out_a) * count));
+	bench_sink = bench_out_b[count - 1];
+
+	alloc_free(data, len);
+}
+
+
+private const bench_t benches[] =
+{
+	{ "sincos", bench_sincos },
+	{ "lerp", bench_lerp },
+	{ "clamp", bench_clamp },
+	{ "history", bench_history },
+	{ "bit_buffer", bench_bit_buffer },
+	{ "bit_columns", bench_bit_columns }
+};
+
+
+int
+main(
+	int argc,
+	char** argv
+	)
+{
+	global_options = options_init(argc, (void*) argv);
+
+	int64_t count = 4096;
+	(void) options_get_i64(global_options, "count", 1, 1 << 24, &count);
+
+	int64_t iterations = 10000;
+	(void) options_get_i64(global_options, "iterations", 1, UINT32_MAX, &iterations);
+	bench_iterations = iterations;
+
+	const char* filter = NULL;
+	str_t filter_str;
+	if(options_get_str(global_options, "filter", &filter_str) && filter_str)
+	{
+		filter = filter_str->str;
+	}
+
+	rand_set_seed(time_get());
+
+	bench_in = alloc_malloc(bench_in, count);
+	assert_not_null(bench_in);
+
+	bench_out_a = alloc_malloc(bench_out_a, count);
+	assert_not_null(bench_out_a);
+
+	bench_out_b = alloc_malloc(bench_out_b, count);
+	assert_not_null(bench_out_b);
+
+	printf("%ld elements, %u iterations, %d lanes\n", count, bench_iterations, SIMD_WIDTH);
+
+	for(uint32_t i = 0; i < MACRO_ARRAY_LEN(benches); ++i)
+	{
+		if(!filter || strstr(benches[i].name, filter))
+		{
+			benches[i].fn(count);
+		}
+	}
+
+	alloc_free(bench_in, count);
+	alloc_free(bench_out_a, count);
+	alloc_free(bench_out_b, count);
+
+	options_free(global_options);
+
+	return 0;
+}
@@ -19,9 +19,6 @@
 #include "../include/socket.h"
 #include "../include/debug.h"
 
-#include <stdlib.h> // todo alloc_ext.h
-#include <string.h>
-
 #ifdef _WIN32
 	#include <ws2tcpip.h>
 #else
@@ -63,32 +60,25 @@ TcpSocketThreadFN(
 
 	while(1)
 	{
-		int bytes = recv(id, (void*)(Socket->buffer + Socket->BufferUsed), Socket->BufferSize - Socket->BufferUsed, 0);
+		int bytes = recv(id, (void*) ring_write_ptr(&Socket->Buffer), ring_available(&Socket->Buffer), 0);
 
 		if(bytes <= 0)
 		{
 			goto goto_close;
 		}
 
-		Socket->BufferUsed += bytes;
+		ring_produce(&Socket->Buffer, bytes);
 
-		while(1)
+		while(ring_used(&Socket->Buffer))
 		{
-			uint32_t Read = Socket->Read(Socket->buffer, Socket->BufferUsed);
+			uint32_t Read = Socket->Read(ring_read_ptr(&Socket->Buffer), ring_used(&Socket->Buffer));
 
 			if(Read == 0)
 			{
 				break;
 			}
 
-			Socket->BufferUsed -= Read;
-
-			if(!Socket->BufferUsed)
-			{
-				break;
-			}
-
-			(void) memmove(Socket->buffer, Socket->buffer + Read, Socket->BufferUsed);
+			ring_consume(&Socket->Buffer, Read);
 		}
 	}
 
@@ -116,9 +106,7 @@ SocketInit(
 		assert_unreachable();
 	}
 
-	Socket->BufferUsed = 0;
-	Socket->buffer = malloc(Socket->BufferSize);
-	assert_not_null(Socket->buffer);
+	ring_init_mirrored(&Socket->Buffer, Socket->BufferSize);
 
 	thread_init(&Socket->thread, TcpSocketThreadFN, Socket);
 }
@@ -138,7 +126,7 @@ SocketFree(
 
 	thread_free(Socket->thread);
 
-	free(Socket->buffer);
+	ring_free(&Socket->Buffer);
 }
 
 
@@ -0,0 +1,1194 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/base.h>
+#include <shared/rand.h>
+#include <shared/ring.h>
+#include <shared/time.h>
+#include <shared/debug.h>
+#include <shared/options.h>
+#include <shared/channel.h>
+#include <shared/alloc_ext.h>
+#include <shared/bit_buffer.h>
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define LOADGEN_RECV_SIZE (GAME_CONST_SERVER_PACKET_SIZE << 1)
+#define LOADGEN_ENTITIES (1 << 14)
+#define LOADGEN_SIZE_BUCKETS 18
+
+
+typedef struct loadgen_entity
+{
+	uint32_t index;
+	uint8_t type;
+	uint8_t subtype;
+	uint32_t hp;
+	int32_t x;
+	int32_t y;
+}
+loadgen_entity_t;
+
+
+typedef struct loadgen_snapshot
+{
+	uint16_t seq;
+	bool valid;
+	uint32_t first;
+	uint32_t count;
+}
+loadgen_snapshot_t;
+
+
+typedef struct loadgen_stats
+{
+	uint64_t bytes;
+	uint64_t updates;
+	uint64_t records;
+	uint64_t decode_errors;
+	uint64_t send_drops;
+	uint64_t missed;
+
+	uint64_t rtt_count;
+	uint64_t rtt_sum;
+	uint64_t rtt_min;
+	uint64_t rtt_max;
+
+	uint64_t sizes[LOADGEN_SIZE_BUCKETS];
+}
+loadgen_stats_t;
+
+
+typedef struct loadgen_conn
+{
+	int fd;
+	uint32_t id;
+	bool connected;
+	bool closed;
+	bool spectator;
+	bool spectating;
+
+	ring_t inbound;
+	channel_t* channel;
+
+	loadgen_snapshot_t snapshots[GAME_CONST_SNAPSHOT_HISTORY];
+	loadgen_entity_t* entities;
+	uint32_t entities_head;
+
+	uint32_t keys;
+	uint64_t next_input_at;
+	uint64_t next_keys_at;
+
+	loadgen_stats_t stats;
+}
+loadgen_conn_t;
+
+
+private loadgen_conn_t* conns;
+private uint32_t conn_count;
+private bool circle;
+private uint64_t input_interval;
+private bool datagrams;
+private float loss;
+
+
+private uint64_t
+loadgen_get_bits(
+	bit_buffer_t* buffer,
+	uint64_t bits,
+	bool* status
+	)
+{
+	if(!bits)
+	{
+		*status = true;
+		return 0;
+	}
+
+	return bit_buffer_get_bits_safe(buffer, bits, status);
+}
+
+
+/*
+ * Over datagrams, every message rides behind a channel header, which
+ * also carries any reliable messages not yet acked. The simulated loss
+ * drops the datagram only after the channel has counted it as sent.
+ */
+private void
+loadgen_send(
+	loadgen_conn_t* conn,
+	bit_buffer_t* buffer
+	)
+{
+	uint32_t len = bit_buffer_consumed_bytes(buffer);
+	const void* data = buffer->data;
+
+	uint8_t datagram_data[CHANNEL_LINK_MTU];
+
+	if(conn->channel)
+	{
+		(void) memset(datagram_data, 0, sizeof(datagram_data));
+
+		bit_buffer_t datagram;
+		bit_buffer_set(&datagram, datagram_data, sizeof(datagram_data));
+
+		(void) channel_write_header(conn->channel, &datagram, sizeof(datagram_data) - CHANNEL_HEADER_SIZE - len);
+		bit_buffer_set_bytes(&datagram, buffer->data, len);
+
+		data = datagram_data;
+		len = bit_buffer_consumed_bytes(&datagram);
+
+		if(rand_f32() < loss)
+		{
+			return;
+		}
+	}
+
+	ssize_t bytes = send(conn->fd, data, len, MSG_NOSIGNAL);
+
+	if(bytes != len)
+	{
+		++conn->stats.send_drops;
+	}
+}
+
+
+/* Events have to arrive, over datagrams they go through the reliable channel */
+private void
+loadgen_send_event(
+	loadgen_conn_t* conn,
+	bit_buffer_t* buffer
+	)
+{
+	if(!conn->channel)
+	{
+		loadgen_send(conn, buffer);
+
+		return;
+	}
+
+	bool status;
+	channel_send_reliable(conn->channel, buffer->data, bit_buffer_consumed_bytes(buffer), &status);
+
+	if(!status)
+	{
+		++conn->stats.send_drops;
+	}
+}
+
+
+private void
+loadgen_send_input(
+	loadgen_conn_t* conn,
+	uint64_t now
+	)
+{
+	uint32_t keys;
+
+	if(circle)
+	{
+		static const uint32_t steps[] =
+		{
+			WINDOW_KEY_BUTTON_W,
+			WINDOW_KEY_BUTTON_D,
+			WINDOW_KEY_BUTTON_S,
+			WINDOW_KEY_BUTTON_A
+		};
+
+		keys = 1 << steps[(time_ns_to_sec(now) + conn->id) % MACRO_ARRAY_LEN(steps)];
+	}
+	else
+	{
+		if(now >= conn->next_keys_at)
+		{
+			conn->keys = rand_u32() & 0xF;
+			conn->next_keys_at = now + time_ms_to_ns(500 + rand_u32() % 1500);
+		}
+
+		keys = conn->keys;
+	}
+
+	uint8_t data[16] = {0};
+	bit_buffer_t buffer;
+
+	bit_buffer_set(&buffer, data, sizeof(data));
+	bit_buffer_set_bits(&buffer, CLIENT_OPCODE_INPUT, CLIENT_OPCODE__BITS);
+	bit_buffer_set_bits(&buffer, rand_u32() % 1921, FIELD_SIZE_MOUSE_X);
+	bit_buffer_set_bits(&buffer, rand_u32() % 1081, FIELD_SIZE_MOUSE_Y);
+	bit_buffer_set_bits(&buffer, keys, WINDOW_KEY_BUTTON__BITS);
+	loadgen_send(conn, &buffer);
+
+	(void) memset(data, 0, sizeof(data));
+	bit_buffer_set(&buffer, data, sizeof(data));
+	bit_buffer_set_bits(&buffer, CLIENT_OPCODE_PING, CLIENT_OPCODE__BITS);
+	bit_buffer_set_bits(&buffer, now, FIELD_SIZE_PING_TIME);
+	loadgen_send(conn, &buffer);
+}
+
+
+private void
+loadgen_send_ack(
+	loadgen_conn_t* conn,
+	uint16_t seq
+	)
+{
+	uint8_t data[4] = {0};
+	bit_buffer_t buffer;
+
+	bit_buffer_set(&buffer, data, sizeof(data));
+	bit_buffer_set_bits(&buffer, CLIENT_OPCODE_ACK, CLIENT_OPCODE__BITS);
+	bit_buffer_set_bits(&buffer, seq, FIELD_SIZE_SNAPSHOT_SEQ);
+	loadgen_send(conn, &buffer);
+}
+
+
+/* Follows the lowest indexed tank, which all spectators agree on */
+private void
+loadgen_send_spectate(
+	loadgen_conn_t* conn,
+	uint32_t first,
+	uint32_t head
+	)
+{
+	for(uint32_t pos = first; pos != head; ++pos)
+	{
+		const loadgen_entity_t* entity = conn->entities + (pos % LOADGEN_ENTITIES);
+
+		if(entity->type != ENTITY_TYPE_TANK)
+		{
+			continue;
+		}
+
+		uint8_t data[8] = {0};
+		bit_buffer_t buffer;
+
+		bit_buffer_set(&buffer, data, sizeof(data));
+		bit_buffer_set_bits(&buffer, CLIENT_OPCODE_SPECTATE, CLIENT_OPCODE__BITS);
+		bit_buffer_set_bits(&buffer, entity->index, FIELD_SIZE_ENTITY_INDEX);
+		loadgen_send_event(conn, &buffer);
+
+		conn->spectating = true;
+
+		break;
+	}
+}
+
+
+private bool
+loadgen_decode_creation(
+	bit_buffer_t* buffer,
+	loadgen_entity_t* entity
+	)
+{
+	bool status;
+
+	entity->type = loadgen_get_bits(buffer, ENTITY_TYPE__BITS, &status);
+	if(!status || entity->type >= ENTITY_TYPE__COUNT)
+	{
+		return false;
+	}
+
+	entity->subtype = loadgen_get_bits(buffer, TypeToSubtypeBits[entity->type], &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	if(entity->type == ENTITY_TYPE_SHAPE && entity->subtype >= SHAPE__COUNT)
+	{
+		return false;
+	}
+
+	entity->x = bit_buffer_get_signed_bits_safe(buffer, FIELD_SIZE_POSITION, &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	entity->y = bit_buffer_get_signed_bits_safe(buffer, FIELD_SIZE_POSITION, &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	if(entity->type == ENTITY_TYPE_TANK)
+	{
+		(void) bit_buffer_get_fixed_point_safe(buffer, FIXED_POINT(RADIUS), &status);
+		if(!status)
+		{
+			return false;
+		}
+	}
+
+	bool write_hp = loadgen_get_bits(buffer, 1, &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	(void) loadgen_get_bits(buffer, 1, &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	entity->hp = ShapeMaxHP[entity->subtype];
+
+	if(write_hp)
+	{
+		entity->hp = loadgen_get_bits(buffer, ShapeHPBits[entity->subtype], &status);
+		if(!status)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+private bool
+loadgen_decode_update(
+	bit_buffer_t* buffer,
+	loadgen_entity_t* entity
+	)
+{
+	bool status;
+
+	bool moved = loadgen_get_bits(buffer, 1, &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	if(moved)
+	{
+		entity->x += bit_buffer_get_signed_bits_var_safe(buffer, FIELD_SIZE_POSITION_DELTA, &status);
+		if(!status)
+		{
+			return false;
+		}
+
+		entity->y += bit_buffer_get_signed_bits_var_safe(buffer, FIELD_SIZE_POSITION_DELTA, &status);
+		if(!status)
+		{
+			return false;
+		}
+	}
+
+	bool update_hp = loadgen_get_bits(buffer, 1, &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	if(update_hp)
+	{
+		entity->hp = loadgen_get_bits(buffer, ShapeHPBits[entity->subtype], &status);
+		if(!status)
+		{
+			return false;
+		}
+	}
+
+	(void) loadgen_get_bits(buffer, 1, &status);
+
+	return status;
+}
+
+
+private bool
+loadgen_decode_snapshot(
+	loadgen_conn_t* conn,
+	bit_buffer_t* buffer
+	)
+{
+	bool status;
+
+	(void) bit_buffer_get_bits_safe(buffer, FIELD_SIZE_TICK_DURATION, &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	(void) bit_buffer_get_fixed_point_safe(buffer, FIXED_POINT(FOV), &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	(void) bit_buffer_get_signed_fixed_point_safe(buffer, FIXED_POINT(POS), &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	(void) bit_buffer_get_signed_fixed_point_safe(buffer, FIXED_POINT(POS), &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	uint16_t seq = bit_buffer_get_bits_safe(buffer, FIELD_SIZE_SNAPSHOT_SEQ, &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	bool has_baseline = bit_buffer_get_bits_safe(buffer, 1, &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	uint32_t base = 0;
+	uint32_t base_end = 0;
+
+	if(has_baseline)
+	{
+		uint16_t base_seq = bit_buffer_get_bits_safe(buffer, FIELD_SIZE_SNAPSHOT_SEQ, &status);
+		if(!status)
+		{
+			return false;
+		}
+
+		loadgen_snapshot_t* baseline = conn->snapshots + (base_seq % GAME_CONST_SNAPSHOT_HISTORY);
+
+		if(!baseline->valid || baseline->seq != base_seq ||
+			conn->entities_head - baseline->first > LOADGEN_ENTITIES)
+		{
+			/* Spectators get deltas against the previous broadcast, so a
+			   lost datagram leaves them waiting for the next keyframe */
+			if(conn->channel && conn->spectating)
+			{
+				++conn->stats.missed;
+				bit_buffer_skip_bits(buffer, bit_buffer_available_bits(buffer));
+
+				return true;
+			}
+
+			return false;
+		}
+
+		base = baseline->first;
+		base_end = base + baseline->count;
+	}
+
+	uint64_t count = bit_buffer_get_bits_var_safe(buffer, FIELD_SIZE_RECORD_COUNT, &status);
+	if(!status)
+	{
+		return false;
+	}
+
+	uint32_t first = conn->entities_head;
+	uint32_t head = first;
+	uint32_t oldest = has_baseline ? base : first;
+	uint32_t next_index = 0;
+
+#define loadgen_entity_at(pos) (conn->entities + ((pos) % LOADGEN_ENTITIES))
+
+#define loadgen_entity_append()										\
+({																	\
+	if(head - oldest >= LOADGEN_ENTITIES)							\
+	{																\
+		return false;												\
+	}																\
+																	\
+	loadgen_entity_at(head++);										\
+})
+
+	for(uint64_t i = 0; i < count; ++i)
+	{
+		uint64_t delta = bit_buffer_get_bits_var_safe(buffer, FIELD_SIZE_INDEX_DELTA, &status);
+		if(!status || delta > UINT32_MAX - next_index)
+		{
+			return false;
+		}
+
+		uint32_t index = next_index + delta;
+
+		EntityRecord kind = loadgen_get_bits(buffer, ENTITY_RECORD__BITS, &status);
+		if(!status)
+		{
+			return false;
+		}
+
+		while(base != base_end && loadgen_entity_at(base)->index < index)
+		{
+			*loadgen_entity_append() = *loadgen_entity_at(base++);
+		}
+
+		const loadgen_entity_t* old = NULL;
+
+		if(base != base_end && loadgen_entity_at(base)->index == index)
+		{
+			old = loadgen_entity_at(base++);
+		}
+
+		switch(kind)
+		{
+
+		case ENTITY_RECORD_CREATE:
+		case ENTITY_RECORD_REPLACE:
+		{
+			if(!old != (kind == ENTITY_RECORD_CREATE))
+			{
+				return false;
+			}
+
+			loadgen_entity_t* entity = loadgen_entity_append();
+			entity->index = index;
+
+			if(!loadgen_decode_creation(buffer, entity))
+			{
+				return false;
+			}
+
+			break;
+		}
+
+		case ENTITY_RECORD_UPDATE:
+		{
+			if(!old)
+			{
+				return false;
+			}
+
+			loadgen_entity_t* entity = loadgen_entity_append();
+			*entity = *old;
+
+			if(!loadgen_decode_update(buffer, entity))
+			{
+				return false;
+			}
+
+			break;
+		}
+
+		case ENTITY_RECORD_REMOVE:
+		{
+			if(!old)
+			{
+				return false;
+			}
+
+			break;
+		}
+
+		default: return false;
+
+		}
+
+		next_index = index + 1;
+	}
+
+	while(base != base_end)
+	{
+		*loadgen_entity_append() = *loadgen_entity_at(base++);
+	}
+
+#undef loadgen_entity_append
+#undef loadgen_entity_at
+
+	loadgen_snapshot_t* snapshot = conn->snapshots + (seq % GAME_CONST_SNAPSHOT_HISTORY);
+	*snapshot =
+	(loadgen_snapshot_t)
+	{
+		.seq = seq,
+		.valid = true,
+		.first = first,
+		.count = head - first
+	};
+
+	conn->entities_head = head;
+	conn->stats.records += count;
+
+	loadgen_send_ack(conn, seq);
+
+	if(conn->spectator && !conn->spectating)
+	{
+		loadgen_send_spectate(conn, first, head);
+	}
+
+	return true;
+}
+
+
+private uint32_t
+loadgen_read(
+	loadgen_conn_t* conn,
+	uint8_t* data,
+	uint32_t len
+	)
+{
+	bit_buffer_t buffer;
+	bit_buffer_set(&buffer, data, len);
+
+	bool status;
+	ServerOpCode opcode = loadgen_get_bits(&buffer, SERVER_OPCODE__BITS, &status);
+	if(!status)
+	{
+		return 0;
+	}
+
+	switch(opcode)
+	{
+
+	case SERVER_OPCODE_UPDATE:
+	{
+		uint32_t size = bit_buffer_get_bits_safe(&buffer, GAME_CONST_SERVER_PACKET_SIZE__BITS, &status);
+		if(!status || size > len)
+		{
+			return 0;
+		}
+
+		if(size < bit_buffer_consumed_bytes(&buffer))
+		{
+			++conn->stats.decode_errors;
+			conn->closed = true;
+
+			return 0;
+		}
+
+		buffer.len = size;
+
+		++conn->stats.updates;
+		++conn->stats.sizes[MACRO_MIN(MACRO_GET_BITS(size), LOADGEN_SIZE_BUCKETS - 1)];
+
+		if(!loadgen_decode_snapshot(conn, &buffer) || bit_buffer_consumed_bytes(&buffer) != size)
+		{
+			++conn->stats.decode_errors;
+		}
+
+		return size;
+	}
+
+	case SERVER_OPCODE_PONG:
+	{
+		uint64_t sent_at = bit_buffer_get_bits_safe(&buffer, FIELD_SIZE_PING_TIME, &status);
+		if(!status)
+		{
+			return 0;
+		}
+
+		uint64_t rtt = time_get() - sent_at;
+
+		loadgen_stats_t* stats = &conn->stats;
+		stats->rtt_min = stats->rtt_count ? MACRO_MIN(stats->rtt_min, rtt) : rtt;
+		stats->rtt_max = MACRO_MAX(stats->rtt_max, rtt);
+		stats->rtt_sum += rtt;
+		++stats->rtt_count;
+
+		return bit_buffer_consumed_bytes(&buffer);
+	}
+
+	default:
+	{
+		++conn->stats.decode_errors;
+		conn->closed = true;
+
+		return 0;
+	}
+
+	}
+}
+
+
+private void
+loadgen_parse(
+	loadgen_conn_t* conn
+	)
+{
+	while(!conn->closed && ring_used(&conn->inbound))
+	{
+		uint32_t read = loadgen_read(conn, ring_read_ptr(&conn->inbound), ring_used(&conn->inbound));
+
+		if(!read)
+		{
+			break;
+		}
+
+		ring_consume(&conn->inbound, read);
+	}
+}
+
+
+/*
+ * Only the newest datagram's messages are read, older ones that arrive
+ * late are already superseded. Nothing is carried over to the next one.
+ */
+private void
+loadgen_recv_datagrams(
+	loadgen_conn_t* conn
+	)
+{
+	uint8_t data[GAME_CONST_SERVER_PACKET_SIZE + CHANNEL_HEADER_SIZE];
+
+	while(!conn->closed)
+	{
+		ssize_t bytes = recv(conn->fd, data, sizeof(data), 0);
+
+		/* Refused until the server is up, there is no connection to lose */
+		if(bytes < 0)
+		{
+			break;
+		}
+
+		if(rand_f32() < loss)
+		{
+			continue;
+		}
+
+		conn->stats.bytes += bytes;
+
+		bit_buffer_t buffer;
+		bit_buffer_set(&buffer, data, bytes);
+
+		channel_packet_info_t info;
+		bool status;
+		channel_read_header(conn->channel, &buffer, &info, &status);
+
+		if(!status)
+		{
+			++conn->stats.decode_errors;
+			conn->closed = true;
+
+			break;
+		}
+
+		if(!info.fresh)
+		{
+			continue;
+		}
+
+		uint32_t len = MACRO_MIN(bit_buffer_available_bits(&buffer) >> 3, ring_available(&conn->inbound));
+		bit_buffer_get_bytes(&buffer, ring_write_ptr(&conn->inbound), len);
+		ring_produce(&conn->inbound, len);
+
+		loadgen_parse(conn);
+		ring_consume(&conn->inbound, ring_used(&conn->inbound));
+	}
+}
+
+
+private void
+loadgen_recv(
+	loadgen_conn_t* conn
+	)
+{
+	if(conn->channel)
+	{
+		loadgen_recv_datagrams(conn);
+
+		return;
+	}
+
+	while(!conn->closed)
+	{
+		ssize_t bytes = recv(conn->fd, ring_write_ptr(&conn->inbound), ring_available(&conn->inbound), 0);
+
+		if(bytes <= 0)
+		{
+			if(bytes == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+			{
+				conn->closed = true;
+			}
+
+			break;
+		}
+
+		conn->stats.bytes += bytes;
+		ring_produce(&conn->inbound, bytes);
+
+		loadgen_parse(conn);
+	}
+}
+
+
+private void
+loadgen_connect(
+	loadgen_conn_t* conn,
+	int epoll_fd,
+	const struct sockaddr_in* addr
+	)
+{
+	if(datagrams)
+	{
+		conn->fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+		hard_assert_neq(conn->fd, -1);
+
+		/* Only filters what is received, the first input is the handshake */
+		int status = connect(conn->fd, (const struct sockaddr*) addr, sizeof(*addr));
+		hard_assert_neq(status, -1);
+
+		conn->channel = alloc_malloc(conn->channel, 1);
+		assert_not_null(conn->channel);
+
+		channel_init(conn->channel);
+		conn->connected = true;
+
+		struct epoll_event event =
+		{
+			.events = EPOLLIN,
+			.data =
+			{
+				.ptr = conn
+			}
+		};
+
+		status = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conn->fd, &event);
+		hard_assert_neq(status, -1);
+
+		return;
+	}
+
+	conn->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP);
+	hard_assert_neq(conn->fd, -1);
+
+	int one = 1;
+	(void) setsockopt(conn->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+	int status = connect(conn->fd, (const struct sockaddr*) addr, sizeof(*addr));
+	if(status == -1 && errno != EINPROGRESS)
+	{
+		conn->closed = true;
+
+		return;
+	}
+
+	struct epoll_event event =
+	{
+		.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP,
+		.data =
+		{
+			.ptr = conn
+		}
+	};
+
+	status = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conn->fd, &event);
+	hard_assert_neq(status, -1);
+}
+
+
+private void
+loadgen_event(
+	loadgen_conn_t* conn,
+	int epoll_fd,
+	uint32_t events
+	)
+{
+	if(!conn->connected && (events & EPOLLOUT))
+	{
+		int error = 0;
+		socklen_t len = sizeof(error);
+		(void) getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &error, &len);
+
+		if(error)
+		{
+			conn->closed = true;
+
+			return;
+		}
+
+		conn->connected = true;
+
+		struct epoll_event event =
+		{
+			.events = EPOLLIN | EPOLLRDHUP,
+			.data =
+			{
+				.ptr = conn
+			}
+		};
+
+		(void) epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conn->fd, &event);
+	}
+
+	if(events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+	{
+		loadgen_recv(conn);
+	}
+}
+
+
+private void
+loadgen_stats_add(
+	loadgen_stats_t* total,
+	const loadgen_stats_t* stats
+	)
+{
+	total->bytes += stats->bytes;
+	total->updates += stats->updates;
+	total->records += stats->records;
+	total->decode_errors += stats->decode_errors;
+	total->send_drops += stats->send_drops;
+	total->missed += stats->missed;
+
+	if(stats->rtt_count)
+	{
+		total->rtt_min = total->rtt_count ? MACRO_MIN(total->rtt_min, stats->rtt_min) : stats->rtt_min;
+		total->rtt_max = MACRO_MAX(total->rtt_max, stats->rtt_max);
+		total->rtt_sum += stats->rtt_sum;
+		total->rtt_count += stats->rtt_count;
+	}
+
+	for(uint32_t i = 0; i < LOADGEN_SIZE_BUCKETS; ++i)
+	{
+		total->sizes[i] += stats->sizes[i];
+	}
+}
+
+
+private void
+loadgen_stats_print(
+	const char* name,
+	const loadgen_stats_t* stats,
+	double seconds
+	)
+{
+	double rtt_avg = stats->rtt_count ? (double) stats->rtt_sum / stats->rtt_count : 0.0;
+
+	printf("%-8s %10.0f B/s %8lu updates %10lu records %6lu errors %6lu drops %6lu missed"
+		"  rtt ms min %7.3f avg %7.3f max %7.3f\n",
+		name, stats->bytes / seconds, stats->updates, stats->records,
+		stats->decode_errors, stats->send_drops, stats->missed,
+		stats->rtt_min / 1e6, rtt_avg / 1e6, stats->rtt_max / 1e6);
+}
+
+
+private void
+loadgen_histogram_print(
+	const loadgen_stats_t* stats
+	)
+{
+	puts("update packet sizes:");
+
+	for(uint32_t i = 0; i < LOADGEN_SIZE_BUCKETS; ++i)
+	{
+		if(!stats->sizes[i])
+		{
+			continue;
+		}
+
+		uint32_t max = UINT32_C(1) << i;
+
+		printf("  <= %6u B: %10lu (%5.1f%%)\n", max, stats->sizes[i], stats->sizes[i] * 100.0 / stats->updates);
+	}
+}
+
+
+int
+main(
+	int argc,
+	char** argv
+	)
+{
+	global_options = options_init(argc, (void*) argv);
+
+	int64_t connections = 100;
+	(void) options_get_i64(global_options, "connections", 1, 65535, &connections);
+
+	int64_t duration = 30;
+	(void) options_get_i64(global_options, "duration", 1, INT32_MAX, &duration);
+
+	int64_t port = GAME_CONST_PORT;
+	(void) options_get_i64(global_options, "port", 1, UINT16_MAX, &port);
+
+	int64_t spectators = 0;
+	(void) options_get_i64(global_options, "spectators", 0, connections, &spectators);
+
+	int64_t input_ms = GAME_CONST_TICK_RATE_MS;
+	(void) options_get_i64(global_options, "input-ms", 1, 10000, &input_ms);
+
+	int64_t seed = time_get();
+	(void) options_get_i64(global_options, "seed", 0, UINT32_MAX, &seed);
+
+	(void) options_get_boolean(global_options, "circle", &circle);
+
+	bool quiet = false;
+	(void) options_get_boolean(global_options, "quiet", &quiet);
+
+	str_t transport;
+	if(options_get_str(global_options, "transport", &transport) && transport)
+	{
+		if(!strcmp(transport->str, "udp"))
+		{
+			datagrams = true;
+		}
+		else
+		{
+			hard_assert_eq(strcmp(transport->str, "tcp"), 0);
+		}
+	}
+
+	/* In percent, of the datagrams sent and received each */
+	float loss_percent = 0;
+	(void) options_get_f32(global_options, "loss", 0, 100, &loss_percent);
+	loss = loss_percent / 100;
+
+	const char* host = "127.0.0.1";
+	str_t host_str;
+	if(options_get_str(global_options, "host", &host_str) && host_str)
+	{
+		host = host_str->str;
+	}
+
+	struct sockaddr_in addr =
+	{
+		.sin_family = AF_INET,
+		.sin_port = htons(port)
+	};
+	hard_assert_eq(inet_pton(AF_INET, host, &addr.sin_addr), 1);
+
+	rand_set_seed(seed);
+	input_interval = time_ms_to_ns(input_ms);
+
+	int epoll_fd = epoll_create1(0);
+	hard_assert_neq(epoll_fd, -1);
+
+	conn_count = connections;
+	conns = alloc_calloc(conns, conn_count);
+	assert_not_null(conns);
+
+	uint64_t start = time_get();
+
+	for(uint32_t i = 0; i < conn_count; ++i)
+	{
+		loadgen_conn_t* conn = conns + i;
+
+		conn->id = i;
+		conn->spectator = i >= conn_count - spectators;
+		ring_init_mirrored(&conn->inbound, LOADGEN_RECV_SIZE);
+		conn->entities = alloc_malloc(conn->entities, LOADGEN_ENTITIES);
+		assert_not_null(conn->entities);
+
+		/* Spread inputs evenly over the interval */
+		conn->next_input_at = start + input_interval * i / conn_count;
+
+		loadgen_connect(conn, epoll_fd, &addr);
+	}
+
+	struct epoll_event events[256];
+	uint64_t end = start + time_sec_to_ns(duration);
+	uint64_t next_report = start + time_sec_to_ns(1);
+	loadgen_stats_t last = {0};
+
+	while(1)
+	{
+		uint64_t now = time_get();
+		if(now >= end)
+		{
+			break;
+		}
+
+		int count = epoll_wait(epoll_fd, events, MACRO_ARRAY_LEN(events), 1);
+
+		for(int i = 0; i < count; ++i)
+		{
+			loadgen_event(events[i].data.ptr, epoll_fd, events[i].events);
+		}
+
+		now = time_get();
+
+		for(uint32_t i = 0; i < conn_count; ++i)
+		{
+			loadgen_conn_t* conn = conns + i;
+
+			if(conn->closed && conn->fd != -1)
+			{
+				(void) close(conn->fd);
+				conn->fd = -1;
+			}
+
+			if(!conn->connected || conn->closed || now < conn->next_input_at)
+			{
+				continue;
+			}
+
+			loadgen_send_input(conn, now);
+			conn->next_input_at += input_interval;
+		}
+
+		if(now >= next_report)
+		{
+			loadgen_stats_t total = {0};
+			uint32_t open = 0;
+
+			for(uint32_t i = 0; i < conn_count; ++i)
+			{
+				loadgen_stats_add(&total, &conns[i].stats);
+				open += conns[i].connected && !conns[i].closed;
+			}
+
+			printf("[%3lus] %u/%u open, %lu B/s, %lu updates/s, %lu decode errors\n",
+				time_ns_to_sec(now - start), open, conn_count,
+				total.bytes - last.bytes, total.updates - last.updates, total.decode_errors);
+
+			last = total;
+			next_report += time_sec_to_ns(1);
+		}
+	}
+
+	double seconds = (time_get() - start) / 1e9;
+	loadgen_stats_t total = {0};
+
+	for(uint32_t i = 0; i < conn_count; ++i)
+	{
+		loadgen_conn_t* conn = conns + i;
+
+		if(!quiet)
+		{
+			char name[16];
+			(void) snprintf(name, sizeof(name), "#%u", conn->id);
+
+			loadgen_stats_print(name, &conn->stats, seconds);
+		}
+
+		loadgen_stats_add(&total, &conn->stats);
+
+		if(conn->fd != -1)
+		{
+			(void) close(conn->fd);
+		}
+
+		ring_free(&conn->inbound);
+		alloc_free(conn->entities, LOADGEN_ENTITIES);
+
+		if(conn->channel)
+		{
+			alloc_free(conn->channel, 1);
+		}
+	}
+
+	loadgen_stats_print("total", &total, seconds);
+	loadgen_histogram_print(&total);
+
+	alloc_free(conns, conn_count);
+	(void) close(epoll_fd);
+
+	options_free(global_options);
+
+	return total.decode_errors ? 1 : 0;
+}
@@ -1,19 +1,69 @@
-#include "../include/quadtree.h"
-#include "../include/shared.h"
-#include "../include/debug.h"
-#include "../include/rand.h"
-#include "../include/sort.h"
-#include "../include/io.h"
+#include <shared/base.h>
+#include <shared/ring.h>
+#include <shared/rand.h>
+#include <shared/uring.h>
+#include <shared/arena.h>
+#include <shared/atomic.h>
+#include <shared/bitset.h>
+#include <shared/channel.h>
+#include <shared/threads.h>
+#include <shared/alloc_ext.h>
+#include <shared/histogram.h>
+#include <shared/history.h>
+#include <shared/options.h>
+#include <shared/time.h>
+#include <shared/simd.h>
+#include <shared/file.h>
+#include <shared/debug.h>
+#include <shared/extent.h>
+#include <shared/bit_buffer.h>
+#include <server/sort.h>
+#include <server/quadtree.h>
 
 #include <math.h>
 #include <time.h>
+#include <stdio.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/uio.h>
 #include <sys/epoll.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <sys/un.h>
+
+#include <zstd.h>
+
+
+typedef struct SnapshotEntity
+{
+	uint32_t Index;
+	uint16_t Generation;
+	uint32_t HP;
+	int32_t X;
+	int32_t Y;
+}
+SnapshotEntity;
+
+
+typedef struct Snapshot
+{
+	uint16_t Seq;
+	uint8_t Valid;
+	uint32_t First;
+	uint32_t Count;
+}
+Snapshot;
+
+
+typedef struct BroadcastPacket
+{
+	uint8_t* Data;
+	uint32_t Len;
+	uint32_t Refs;
+}
+BroadcastPacket;
 
 
 typedef struct GameClient
@@ -21,6 +71,10 @@ typedef struct GameClient
 	int FD;
 	uint32_t next;
 
+	/* Only set for datagram clients, which share their arena's socket */
+	struct sockaddr_in6 Peer;
+	channel_t* Channel;
+
 	uint64_t ConnectionIdle;
 	uint64_t ActionIdle;
 
@@ -38,749 +92,4155 @@ typedef struct GameClient
 
 	uint32_t BodyIndex;
 
-	uint8_t buffer[GAME_CONST_CLIENT_PACKET_SIZE];
-	uint32_t BufferUsed;
+	ring_t Inbound;
 
 	uint8_t Valid:1;
-
-	uint8_t* EntityBits;
-	uint16_t* EntitiesInView;
-	uint16_t EntitiesInViewCount;
+	uint8_t WantsWrite:1;
+	uint8_t Closing:1;
+	uint8_t RecvArmed:1;
+	uint8_t SendInFlight:1;
+	uint8_t Acked:1;
+	uint8_t Spectating:1;
+	uint8_t Resync:1;
+
+	uint32_t Generation;
+
+	ring_t Outbound;
+	uint32_t SnapshotPending;
+	uint32_t StaleTicks;
+
+	uint32_t Broadcast;
+	BroadcastPacket* Shared;
+	uint32_t SharedSent;
+
+	bitset_t View;
+	bitset_t BaselineView;
+	uint32_t EntitiesInViewCount;
+
+	uint16_t SnapshotSeq;
+	uint16_t AckedSeq;
+	Snapshot Snapshots[GAME_CONST_SNAPSHOT_HISTORY];
+	SnapshotEntity* SnapshotEntities;
+	uint32_t SnapshotEntitiesHead;
+
+	uint32_t Budget;
+	float* Priority;
 }
 GameClient;
 
 
-private GameClient Clients[GAME_CONST_MAX_PLAYERS];
-private uint32_t ClientsUsed = 0;
-private uint32_t FreeClient = -1;
+/*
+ * A camera following one entity, shared by all of its spectators. The
+ * viewer is serialized like a client would be, once per tick, and the
+ * resulting packet is referenced by every subscriber instead of copied.
+ */
+typedef struct GameBroadcast
+{
+	GameClient Viewer;
+
+	uint32_t Target;
+	uint16_t TargetGeneration;
 
-private uint8_t* EntityBits;
-private uint16_t* EntitiesInView;
-private uint16_t EntitiesInViewCount;
+	uint32_t Subscribers;
+	uint32_t Ready;
+	uint32_t Waiting;
+	uint8_t Keyframe;
+	uint64_t LastKeyframe;
 
-private GameClient* Client = NULL;
-private uint64_t CurrentTick = 0;
-private uint64_t LastTickAt;
-private uint64_t CurrentTickAt;
+	BroadcastPacket Packets[GAME_CONST_BROADCAST_PACKETS];
+	BroadcastPacket* Current;
+}
+GameBroadcast;
 
-private QUADTREE Quadtree = {0};
 
-typedef struct GameEntity
+private int ServerFD;
+private uint8_t Datagrams;
+
+typedef enum UringOp
 {
-	EntityType type;
-	uint32_t Subtype;
+	URING_OP_ACCEPT = 1,
+	URING_OP_RECV,
+	URING_OP_SEND,
+	URING_OP_CANCEL
+}
+UringOp;
 
-	float VX;
-	float VY;
+typedef enum ProfilePhase
+{
+	PROFILE_PHASE_READ,
+	PROFILE_PHASE_ACCEPT,
+	PROFILE_PHASE_MOVEMENT,
+	PROFILE_PHASE_QUADTREE_UPDATE,
+	PROFILE_PHASE_QUADTREE_COLLIDE,
+	PROFILE_PHASE_QUERY,
+	PROFILE_PHASE_SORT,
+	PROFILE_PHASE_PACK,
+	PROFILE_PHASE_SEND,
+	PROFILE_PHASE_SERIALIZE,
+	PROFILE_PHASE_FANOUT,
+	PROFILE_PHASE_TICK,
+	PROFILE_PHASE_JITTER,
+	PROFILE_PHASE__COUNT
+}
+ProfilePhase;
 
-	float ColVX;
-	float ColVY;
+private const char* ProfilePhaseNames[] =
+{
+	[PROFILE_PHASE_READ] = "read",
+	[PROFILE_PHASE_ACCEPT] = "accept",
+	[PROFILE_PHASE_MOVEMENT] = "movement",
+	[PROFILE_PHASE_QUADTREE_UPDATE] = "quadtree_update",
+	[PROFILE_PHASE_QUADTREE_COLLIDE] = "quadtree_collide",
+	[PROFILE_PHASE_QUERY] = "query",
+	[PROFILE_PHASE_SORT] = "sort",
+	[PROFILE_PHASE_PACK] = "pack",
+	[PROFILE_PHASE_SEND] = "send",
+	[PROFILE_PHASE_SERIALIZE] = "serialize",
+	[PROFILE_PHASE_FANOUT] = "fanout",
+	[PROFILE_PHASE_TICK] = "tick",
+	[PROFILE_PHASE_JITTER] = "jitter"
+};
+
+private uint8_t Profiling;
+private FILE* ProfileFile;
+private thread_local histogram_t* Profile;
+
+typedef enum StatsCounter
+{
+	STATS_COUNTER_BYTES_IN,
+	STATS_COUNTER_BYTES_OUT,
+	STATS_COUNTER_COLLISIONS,
+	STATS_COUNTER_QUERY_HITS,
+	STATS_COUNTER__COUNT
+}
+StatsCounter;
+
+/* One per thread, each written by its owner only, a cache line apart */
+typedef struct __attribute__((aligned(64))) GameStats
+{
+	_Atomic uint64_t Counters[STATS_COUNTER__COUNT];
+	_Atomic uint64_t FramePeak;
+}
+GameStats;
+
+typedef enum StatsField
+{
+	STATS_FIELD_TICK,
+	STATS_FIELD_CLIENTS,
+	STATS_FIELD_SPECTATORS,
+	STATS_FIELD_ENTITIES,
+	STATS_FIELD_ENTITY_CAPACITY,
+	STATS_FIELD_TICK_P50_US,
+	STATS_FIELD_TICK_P99_US,
+	STATS_FIELD_TICK_MAX_US,
+	STATS_FIELD_OVERRUNS,
+	STATS_FIELD_BYTES_IN_PER_SEC,
+	STATS_FIELD_BYTES_OUT_PER_SEC,
+	STATS_FIELD_COLLISIONS_PER_SEC,
+	STATS_FIELD_QUERY_HITS_PER_SEC,
+	STATS_FIELD_ALLOC_CALLS,
+	STATS_FIELD_EXEMPT_ALLOC_CALLS,
+	STATS_FIELD_FRAME_ARENA_PEAK,
+	STATS_FIELD_FRAME_ARENA_SIZE,
+	STATS_FIELD__COUNT
+}
+StatsField;
+
+private const char* StatsFieldNames[] =
+{
+	[STATS_FIELD_TICK] = "tick",
+	[STATS_FIELD_CLIENTS] = "clients",
+	[STATS_FIELD_SPECTATORS] = "spectators",
+	[STATS_FIELD_ENTITIES] = "entities",
+	[STATS_FIELD_ENTITY_CAPACITY] = "entity_capacity",
+	[STATS_FIELD_TICK_P50_US] = "tick_p50_us",
+	[STATS_FIELD_TICK_P99_US] = "tick_p99_us",
+	[STATS_FIELD_TICK_MAX_US] = "tick_max_us",
+	[STATS_FIELD_OVERRUNS] = "overruns",
+	[STATS_FIELD_BYTES_IN_PER_SEC] = "bytes_in_per_sec",
+	[STATS_FIELD_BYTES_OUT_PER_SEC] = "bytes_out_per_sec",
+	[STATS_FIELD_COLLISIONS_PER_SEC] = "collisions_per_sec",
+	[STATS_FIELD_QUERY_HITS_PER_SEC] = "query_hits_per_sec",
+	[STATS_FIELD_ALLOC_CALLS] = "alloc_calls",
+	[STATS_FIELD_EXEMPT_ALLOC_CALLS] = "exempt_alloc_calls",
+	[STATS_FIELD_FRAME_ARENA_PEAK] = "frame_arena_peak",
+	[STATS_FIELD_FRAME_ARENA_SIZE] = "frame_arena_size"
+};
+
+private const char* StatsPath;
+private int StatsFD;
+private thread_t StatsThread;
+private thread_local GameStats* Stats;
+
+typedef enum RecordType
+{
+	RECORD_TYPE_CONNECT,
+	RECORD_TYPE_DISCONNECT,
+	RECORD_TYPE_MESSAGE
+}
+RecordType;
+
+typedef struct RecordHeader
+{
+	uint32_t Magic;
+	uint32_t Seed;
+}
+RecordHeader;
+
+typedef struct RecordEvent
+{
+	uint64_t Tick;
+	uint16_t Slot;
+	uint16_t Len;
+	uint8_t Type;
+}
+RecordEvent;
+
+#define RECORD_MAGIC 0x31434552 /* "REC1" */
 
+private FILE* RecordFile;
+private FILE* ReplayFile;
+
+typedef struct CheckpointHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint64_t Tick;
+	uint32_t Seed;
+	uint32_t EntityCount;
+	uint32_t BodyCount;
+	uint32_t Bodies[GAME_CONST_MAX_PLAYERS];
+}
+CheckpointHeader;
+
+typedef struct CheckpointEntity
+{
+	uint32_t Index;
+	uint32_t Type;
+	uint32_t Subtype;
+
+	float X;
+	float Y;
+	float W;
+	float H;
+	float Speed;
 	float Angle;
-	float AngleDir;
+	float Spin;
+	float ColVX;
+	float ColVY;
 
 	uint32_t HP;
 	uint32_t MaxHP;
+	uint32_t Flags;
 
 	uint64_t DamagedAt;
-
-	uint32_t ConstrainToArena:1;
-	uint32_t ResetPX:1;
-	uint32_t ResetNX:1;
-	uint32_t ResetPY:1;
-	uint32_t ResetNY:1;
-
-	uint32_t UpdateHP:1;
-	uint32_t TookDamage:1;
 }
-GameEntity;
+CheckpointEntity;
 
-private GameEntity* Entities = NULL;
+#define CHECKPOINT_MAGIC 0x31504B43 /* "CKP1" */
+#define CHECKPOINT_VERSION 2
 
+private const char* CheckpointPrefix;
+private uint64_t CheckpointTicks;
 
-private GameEntity*
-GetEntity(
-	const QUADTREE_ENTITY* Entity
-	)
+private thread_local GameClient* Client = NULL;
+
+typedef struct GameEntity
 {
-	uint32_t idx = QuadtreeInsert(&Quadtree, Entity);
-	assert_eq(Quadtree.EntitiesSize, GAME_CONST_MAX_ENTITIES);
+	EntityType type;
+	uint32_t Subtype;
 
-	GameEntity* Ret = Entities + idx;
-	*Ret = (GameEntity){ 0 };
+	uint32_t TookDamage:1;
 
-	return Ret;
+	uint16_t Generation;
+	uint32_t Next;
 }
+GameEntity;
 
-
-private void
-RetEntity(
-	const GameEntity* Entity
-	)
+typedef enum EntityFlag
 {
-	QuadtreeRemove(&Quadtree, Entity - Entities);
+	ENTITY_FLAG_CONSTRAIN = 1 << 0,
+	ENTITY_FLAG_RESET_PX = 1 << 1,
+	ENTITY_FLAG_RESET_NX = 1 << 2,
+	ENTITY_FLAG_RESET_PY = 1 << 3,
+	ENTITY_FLAG_RESET_NY = 1 << 4,
+	ENTITY_FLAG_MOVED = 1 << 5
 }
+EntityFlag;
+
+/*
+ * Hot per-entity state, one array per field, so that the per-tick
+ * integration step can run over it in whole vectors. Positions here
+ * are authoritative, the quadtree's copy is synced when it updates.
+ */
+typedef struct EntityStore
+{
+	float* X;
+	float* Y;
+	float* W;
+	float* H;
 
+	float* VX;
+	float* VY;
+	float* Speed;
+	float* Angle;
+	float* Spin;
 
-private GameClient*
-GetClient(
-	void
-	)
-{
-	GameClient* Ret = Clients;
+	float* ColVX;
+	float* ColVY;
 
-	if(FreeClient != -1)
-	{
-		Ret += FreeClient;
-		FreeClient = Ret->next;
-	}
-	else
-	{
-		Ret += ClientsUsed++;
-	}
+	uint32_t* HP;
+	uint32_t* MaxHP;
+	uint32_t* DamagedAt;
 
-	*Ret = (GameClient){ 0 };
-	Ret->Valid = 1;
+	uint32_t* Flags;
 
-	return Ret;
+	uint32_t Count;
 }
+EntityStore;
 
+private const float ShapeSpeed = 0.3f;
+private const float ShapeSpin = 0.0005f;
 
-private void
-RetClient(
-	void
-	)
+typedef struct EntityEncoding
 {
-	Client->next = FreeClient;
-	Client->Valid = 0;
-	FreeClient = Client - Clients;
-}
+	uint64_t Tick;
 
+	uint8_t Prefix[8];
+	uint8_t CreateSuffix[8];
 
-private float
-LerpF(
-	float old,
-	float New,
-	float By
-	)
+	uint8_t PrefixBits;
+	uint8_t CreateSuffixBits;
+}
+EntityEncoding;
+
+typedef struct ViewRecord
 {
-	return old + (New - old) * By;
+	uint32_t Index;
+	uint8_t Kind;
+	uint8_t Selected;
+	uint32_t Bits;
+	uint32_t Base;
 }
+ViewRecord;
 
+typedef struct GameWorker
+{
+	struct GameArena* Arena;
+	arena_t* FrameArena;
+	uint32_t Index;
+	alloc_t AllocCalls;
+}
+GameWorker;
 
-private void
-GetSpawnCoords(
-	QUADTREE_ENTITY* QTEntity
-	)
+typedef struct GameArena
 {
-	QTEntity->x = rand_f32() * (GAME_CONST_HALF_ARENA_SIZE * 2 - QTEntity->w) - GAME_CONST_HALF_ARENA_SIZE + QTEntity->w;
-	QTEntity->y = rand_f32() * (GAME_CONST_HALF_ARENA_SIZE * 2 - QTEntity->h) - GAME_CONST_HALF_ARENA_SIZE + QTEntity->h;
+	uint32_t Id;
+	thread_t Thread;
+	uint32_t Seed;
+
+	GameClient Clients[GAME_CONST_MAX_PLAYERS];
+	uint32_t ClientsUsed;
+	uint32_t FreeClient;
+	_Atomic uint32_t Load;
+
+	GameBroadcast Broadcasts[GAME_CONST_MAX_BROADCASTS];
+	uint32_t BroadcastsUsed;
+
+	quadtree_t Quadtree;
+	GameEntity* Entities;
+	uint32_t EntitiesUsed;
+	uint32_t FreeEntity;
+	EntityStore Store;
+	EntityEncoding* EntityEncodings;
+
+	uint32_t EntityCapacity;
+	bitset_t Alive;
+	history_t History;
+
+	uint64_t CurrentTick;
+	uint64_t LastTickAt;
+	uint64_t CurrentTickAt;
+	time_scheduler_t Scheduler;
+
+	arena_t* FrameArenas;
+	alloc_t TickAllocCalls;
+	alloc_t ExemptAllocCalls;
+
+	threads_t Workers;
+	GameWorker* WorkerData;
+	uint32_t WorkerCount;
+	sync_sem_t WorkStart;
+	sync_sem_t WorkDone;
+	_Atomic uint32_t NextClient;
+
+	int EpollFD;
+	struct epoll_event Events[GAME_CONST_MAX_PLAYERS];
+	int DatagramFD;
+
+	uring_t Uring;
+	uint8_t UseUring;
+	uint8_t AcceptArmed;
+	uint8_t Accepts;
+
+	sync_mtx_t PendingLock;
+	int Pending[GAME_CONST_MAX_PLAYERS];
+	uint32_t PendingCount;
+
+	char CheckpointPath[256];
+	thread_t CheckpointThread;
+	sync_sem_t CheckpointStart;
+	_Atomic uint8_t CheckpointBusy;
+	uint8_t* CheckpointData;
+	uint32_t CheckpointCapacity;
+	uint64_t CheckpointsSkipped;
+
+	GameStats* StatsSets;
+	histogram_t StatsTicks;
+	uint64_t StatsWindowAt;
+	uint64_t StatsTotals[STATS_COUNTER__COUNT];
+	uint64_t StatsOverruns;
+	uint64_t StatsAllocCalls;
+	uint64_t StatsExemptAllocCalls;
+	_Atomic uint32_t StatsSeq;
+	_Atomic uint64_t StatsPublished[STATS_FIELD__COUNT];
+
+	histogram_t* ProfileSets;
+	histogram_t ProfileMerged;
+	uint64_t ProfileTicks;
+	uint64_t ProfileOverruns;
 }
+GameArena;
 
+private GameArena* Arenas;
+private uint32_t ArenaCount;
 
-private void
-SpawnShape(
-	Shape Subtype
+private time_catch_up_t CatchUp = TIME_CATCH_UP_BOUNDED;
+private uint32_t MaxCatchUp;
+private uint64_t SpinTime;
+private thread_local GameArena* Arena;
+
+
+private uint64_t
+ProfileStart(
+	void
 	)
 {
-	QUADTREE_ENTITY QTEntity =
+	if(!Profiling)
 	{
-		.w = ShapeHitbox[Subtype],
-		.h = ShapeHitbox[Subtype]
-	};
-
-	GetSpawnCoords(&QTEntity);
-
-	GameEntity* Entity = GetEntity(&QTEntity);
+		return 0;
+	}
 
-	Entity->type = ENTITY_TYPE_SHAPE;
-	Entity->Subtype = Subtype;
-	Entity->Angle = rand_angle();
-	Entity->AngleDir = rand_bool() ? -1 : 1;
-	Entity->MaxHP = ShapeMaxHP[Subtype];
-	Entity->HP = MACRO_MIN(Entity->MaxHP, rand_f32() * Entity->MaxHP * 6);
-	Entity->ConstrainToArena = 1;
+	return time_get_monotonic();
 }
 
 
-private int
-QuadtreeUpdateFN(
-	QUADTREE* Quadtree,
-	uint32_t EntityIdx
+private uint64_t
+ProfileEnd(
+	ProfilePhase Phase,
+	uint64_t Start
 	)
 {
-	QUADTREE_ENTITY* QTEntity = Quadtree->Entities + EntityIdx;
-	GameEntity* Entity = Entities + EntityIdx;
-
-	switch(Entity->type)
+	if(!Profiling)
 	{
-
-	case ENTITY_TYPE_TANK:
-	{
-		break;
+		return 0;
 	}
 
-	case ENTITY_TYPE_SHAPE:
-	{
-		Entity->VX = cosf(Entity->Angle) * 0.3f;
-		Entity->VY = sinf(Entity->Angle) * 0.3f;
-		Entity->Angle += 0.0005f * Entity->AngleDir;
-
-		break;
-	}
+	uint64_t Now = time_get_monotonic();
+	histogram_record(Profile + Phase, Now - Start);
 
-	default: __builtin_unreachable();
+	return Now;
+}
 
-	}
 
-	QTEntity->x += Entity->ColVX;
-	QTEntity->y += Entity->ColVY;
+private void
+ProfileDump(
+	void
+	)
+{
+	uint32_t Sets = Arena->WorkerCount + 1;
 
-	Entity->ColVX = LerpF(Entity->ColVX, 0, 0.095f);
-	Entity->ColVY = LerpF(Entity->ColVY, 0, 0.095f);
+	flockfile(ProfileFile);
 
-	QTEntity->x += Entity->VX;
-	QTEntity->y += Entity->VY;
+	fprintf(ProfileFile, "arena %u tick %lu: %lu ticks, %lu overruns of %d ms (%lu started late, %lu skipped in total), %lu checkpoints skipped\n",
+		Arena->Id, Arena->CurrentTick, Arena->ProfileTicks, Arena->ProfileOverruns, GAME_CONST_TICK_RATE_MS,
+		Arena->Scheduler.overruns, Arena->Scheduler.skipped, Arena->CheckpointsSkipped);
+	fprintf(ProfileFile, "%-18s %10s %10s %10s %10s %10s %10s (us)\n",
+		"phase", "count", "mean", "p50", "p99", "p999", "max");
 
-	if(Entity->ConstrainToArena)
+	for(uint32_t Phase = 0; Phase < PROFILE_PHASE__COUNT; ++Phase)
 	{
-		float Limit = GAME_CONST_HALF_ARENA_SIZE + GAME_CONST_BORDER_PADDING;
+		histogram_reset(&Arena->ProfileMerged);
 
-		if(QTEntity->x - QTEntity->w < -Limit)
-		{
-			QTEntity->x = -Limit + QTEntity->w;
-			Entity->ResetNX = 1;
-		}
-		else if(QTEntity->x + QTEntity->w > Limit)
-		{
-			QTEntity->x = Limit - QTEntity->w;
-			Entity->ResetPX = 1;
-		}
-		else
+		for(uint32_t i = 0; i < Sets; ++i)
 		{
-			Entity->ResetPX = 0;
-			Entity->ResetNX = 0;
-		}
+			histogram_t* Histogram = Arena->ProfileSets + i * PROFILE_PHASE__COUNT + Phase;
 
-		if(QTEntity->y - QTEntity->h < -Limit)
-		{
-			QTEntity->y = -Limit + QTEntity->h;
-			Entity->ResetNY = 1;
+			histogram_merge(&Arena->ProfileMerged, Histogram);
+			histogram_reset(Histogram);
 		}
-		else if(QTEntity->y + QTEntity->h > Limit)
-		{
-			QTEntity->y = Limit - QTEntity->h;
-			Entity->ResetPY = 1;
-		}
-		else
-		{
-			Entity->ResetPY = 0;
-			Entity->ResetNY = 0;
-		}
-	}
-
-	Entity->UpdateHP = 0;
-	Entity->TookDamage = 0;
 
-	if(Entity->HP != Entity->MaxHP && CurrentTick - Entity->DamagedAt >= 200)
-	{
-		Entity->HP = MACRO_MIN(Entity->MaxHP, Entity->HP + 1);
-		Entity->UpdateHP = 1;
+		fprintf(ProfileFile, "%-18s %10lu %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+			ProfilePhaseNames[Phase], Arena->ProfileMerged.count,
+			histogram_mean(&Arena->ProfileMerged) / 1000.0,
+			histogram_percentile(&Arena->ProfileMerged, 50.0) / 1000.0,
+			histogram_percentile(&Arena->ProfileMerged, 99.0) / 1000.0,
+			histogram_percentile(&Arena->ProfileMerged, 99.9) / 1000.0,
+			Arena->ProfileMerged.max / 1000.0);
 	}
 
-	return 1;
-}
-
-
-private int
-QuadtreeIsCollidingFN(
-	const QUADTREE* Quadtree,
-	uint32_t EntityIdxA,
-	uint32_t EntityIdxB
-	)
-{
-	QUADTREE_ENTITY* QTEntityA = Quadtree->Entities + EntityIdxA;
-	QUADTREE_ENTITY* QTEntityB = Quadtree->Entities + EntityIdxB;
+	fputc('\n', ProfileFile);
+	fflush(ProfileFile);
 
-	float DiffX = QTEntityA->x - QTEntityB->x;
-	float DiffY = QTEntityA->y - QTEntityB->y;
-	float SumR = QTEntityA->r + QTEntityB->r;
+	funlockfile(ProfileFile);
 
-	return DiffX * DiffX + DiffY * DiffY < SumR * SumR;
+	Arena->ProfileTicks = 0;
+	Arena->ProfileOverruns = 0;
 }
 
 
 private void
-QuadtreeCollideFN(
-	QUADTREE* Quadtree,
-	uint32_t EntityIdxA,
-	uint32_t EntityIdxB
+ProfileTick(
+	uint64_t TickStart
 	)
 {
-	QUADTREE_ENTITY* QTEntityA = Quadtree->Entities + EntityIdxA;
-	GameEntity* EntityA = Entities + EntityIdxA;
-
-	QUADTREE_ENTITY* QTEntityB = Quadtree->Entities + EntityIdxB;
-	GameEntity* EntityB = Entities + EntityIdxB;
-
-	float DiffX = QTEntityA->x - QTEntityB->x;
-	float DiffY = QTEntityA->y - QTEntityB->y;
-
-	float Dist = sqrtf(DiffX * DiffX + DiffY * DiffY);
-
-	if(!Dist)
+	if(!Profiling)
 	{
-		Dist = 1.0f;
+		return;
 	}
 
-	DiffX /= Dist;
-	DiffY /= Dist;
-
-	EntityA->ColVX += DiffX * 5.0f;
-	EntityA->ColVY += DiffY * 5.0f;
+	uint64_t TickTime = time_get_monotonic() - TickStart;
+	histogram_record(Profile + PROFILE_PHASE_TICK, TickTime);
 
-	EntityB->ColVX -= DiffX * 5.0f;
-	EntityB->ColVY -= DiffY * 5.0f;
+	++Arena->ProfileTicks;
+	Arena->ProfileOverruns += TickTime > time_ms_to_ns(GAME_CONST_TICK_RATE_MS);
 
-	if(EntityA->HP)
+	if(Arena->ProfileTicks == GAME_CONST_PROFILE_DUMP_TICKS)
 	{
-		--EntityA->HP;
+		ProfileDump();
 	}
-	EntityA->UpdateHP = 1;
-	EntityA->TookDamage = 1;
-	EntityA->DamagedAt = CurrentTick;
+}
 
-	if(EntityB->HP)
-	{
-		--EntityB->HP;
-	}
-	EntityB->UpdateHP = 1;
-	EntityB->TookDamage = 1;
-	EntityB->DamagedAt = CurrentTick;
+
+private void
+StatsAdd(
+	StatsCounter Counter,
+	uint64_t Value
+	)
+{
+	/* Single writer, so no read-modify-write is needed */
+	_Atomic uint64_t* Slot = Stats->Counters + Counter;
+	atomic_store_explicit(Slot, atomic_load_explicit(Slot, memory_order_relaxed) + Value, memory_order_relaxed);
 }
 
 
 private void
-QuadtreeViewQueryFN(
-	QUADTREE* Quadtree,
-	uint32_t EntityIdx
+StatsPeak(
+	uint64_t Value
 	)
 {
-	EntityBits[EntityIdx >> 3] |= 1 << (EntityIdx & 7);
-	EntitiesInView[EntitiesInViewCount++] = EntityIdx;
+	if(Value > atomic_load_explicit(&Stats->FramePeak, memory_order_relaxed))
+	{
+		atomic_store_explicit(&Stats->FramePeak, Value, memory_order_relaxed);
+	}
 }
 
 
 private void
-ClientChangeFoV(
-	float FoV
+RecordWrite(
+	RecordType Type,
+	const uint8_t* Data,
+	uint32_t Len
 	)
 {
-	Client->FoV = FoV;
-	Client->CameraW = 960.0f / Client->FoV + 200.0f;
-	Client->CameraH = 540.0f / Client->FoV + 200.0f;
+	if(!RecordFile)
+	{
+		return;
+	}
+
+	RecordEvent Event =
+	{
+		.Tick = Arena->CurrentTick,
+		.Slot = Client - Arena->Clients,
+		.Len = Len,
+		.Type = Type
+	};
+
+	(void) fwrite(&Event, sizeof(Event), 1, RecordFile);
+	(void) fwrite(Data, 1, Len, RecordFile);
 }
 
 
 private void
-ClientCreate(
-	void
+EntityStoreResize(
+	EntityStore* Store,
+	uint32_t OldCapacity,
+	uint32_t NewCapacity
 	)
 {
-	Client->ConnectionIdle = CurrentTick;
-	Client->ActionIdle = CurrentTick;
+	/* Integration runs whole vectors up to the highest index in use */
+	assert_eq(NewCapacity % SIMD_WIDTH, 0);
 
-	ClientChangeFoV(0.5f);
+	float** Floats[] =
+	{
+		&Store->X, &Store->Y, &Store->W, &Store->H,
+		&Store->VX, &Store->VY, &Store->Speed, &Store->Angle, &Store->Spin,
+		&Store->ColVX, &Store->ColVY
+	};
 
-	GameEntity* Body = GetEntity(&(
-		(QUADTREE_ENTITY)
-		{
-			.x = 0,
-			.y = 0,
-			.w = 70,
-			.h = 70
-		}
-	));
-	Body->ConstrainToArena = 1;
-	Body->MaxHP = 1000;
-	Body->HP = Body->MaxHP;
+	for(uint32_t i = 0; i < MACRO_ARRAY_LEN(Floats); ++i)
+	{
+		*Floats[i] = alloc_recalloc(*Floats[i], OldCapacity, NewCapacity);
+		assert_not_null(*Floats[i]);
+	}
 
-	Client->BodyIndex = Body - Entities;
+	uint32_t** Uints[] =
+	{
+		&Store->HP, &Store->MaxHP, &Store->DamagedAt, &Store->Flags
+	};
 
-	Client->EntityBits = calloc(MACRO_TO_BYTES(GAME_CONST_MAX_ENTITIES), sizeof(uint8_t));
-	assert_not_null(Client->EntityBits);
+	for(uint32_t i = 0; i < MACRO_ARRAY_LEN(Uints); ++i)
+	{
+		*Uints[i] = alloc_recalloc(*Uints[i], OldCapacity, NewCapacity);
+		assert_not_null(*Uints[i]);
+	}
 }
 
 
-private void
-ClientClose(
+private uint64_t
+FrameArenaSize(
 	void
 	)
 {
-	shutdown(Client->FD, SHUT_RDWR);
+	/* A packet, plus view records for a full baseline and a full view */
+	return GAME_CONST_SERVER_PACKET_SIZE +
+		(sizeof(ViewRecord) + sizeof(float) + sizeof(uint32_t)) * Arena->EntityCapacity * 2 + 64;
 }
 
 
 private void
-ClientSend(
-	const bit_buffer_t* buffer
+ClientEntitiesResize(
+	uint32_t OldCapacity,
+	uint32_t NewCapacity
 	)
 {
-	ssize_t bytes = send(Client->FD, buffer->buffer, buffer->len, MSG_NOSIGNAL);
+	bitset_resize(&Client->View, NewCapacity);
+	bitset_resize(&Client->BaselineView, NewCapacity);
 
-	if(bytes != buffer->len)
+	Client->Priority = alloc_recalloc(Client->Priority, OldCapacity, NewCapacity);
+	assert_not_null(Client->Priority);
+
+	/* Ring positions depend on its size, so the baselines can't be kept */
+	alloc_free(Client->SnapshotEntities, OldCapacity);
+	Client->SnapshotEntities = alloc_malloc(Client->SnapshotEntities, NewCapacity);
+	assert_not_null(Client->SnapshotEntities);
+
+	Client->SnapshotEntitiesHead = 0;
+
+	for(uint32_t i = 0; i < GAME_CONST_SNAPSHOT_HISTORY; ++i)
 	{
-		ClientClose();
+		Client->Snapshots[i].Valid = 0;
 	}
 }
 
 
-private uint32_t
-ClientRead(
+/*
+ * Doubles the entity capacity once every index is taken. Every per-entity
+ * array, including each client's, spans the same capacity. The allocations
+ * are rare and exempt from the per-tick count.
+ */
+private void
+ArenaGrowEntities(
 	void
 	)
 {
-	bit_buffer_t buffer = {0};
-	buffer.buffer = Client->buffer;
-	buffer.at = buffer.buffer;
-	buffer.len = Client->BufferUsed;
+	alloc_t AllocCalls = alloc_get_call_count();
 
-	if(buffer.len < MACRO_TO_BYTES(CLIENT_OPCODE__BITS))
+	uint32_t OldCapacity = Arena->EntityCapacity;
+	uint32_t NewCapacity = OldCapacity << 1;
+	assert_le(NewCapacity, GAME_CONST_MAX_ENTITIES);
+
+	Arena->Entities = alloc_recalloc(Arena->Entities, OldCapacity, NewCapacity);
+	assert_not_null(Arena->Entities);
+
+	Arena->EntityEncodings = alloc_recalloc(Arena->EntityEncodings, OldCapacity, NewCapacity);
+	assert_not_null(Arena->EntityEncodings);
+
+	EntityStoreResize(&Arena->Store, OldCapacity, NewCapacity);
+	bitset_resize(&Arena->Alive, NewCapacity);
+	history_resize(&Arena->History, NewCapacity);
+
+	GameClient* Current = Client;
+
+	for(uint32_t i = 0; i < Arena->ClientsUsed; ++i)
 	{
-		return 0;
-	}
+		Client = Arena->Clients + i;
 
-	uintptr_t OpCode = bit_buffer_get_bits(&buffer, CLIENT_OPCODE__BITS);
+		if(Client->Valid)
+		{
+			ClientEntitiesResize(OldCapacity, NewCapacity);
+		}
+	}
 
-	switch(OpCode)
+	for(uint32_t i = 0; i < Arena->BroadcastsUsed; ++i)
 	{
+		Client = &Arena->Broadcasts[i].Viewer;
+		ClientEntitiesResize(OldCapacity, NewCapacity);
+	}
 
-	case CLIENT_OPCODE_INPUT:
+	Client = Current;
+
+	Arena->EntityCapacity = NewCapacity;
+
+	if(Arena->FrameArenas)
 	{
-		if(buffer.len < MACRO_TO_BYTES(
-			CLIENT_OPCODE__BITS +
-			FIELD_SIZE_MOUSE_X +
-			FIELD_SIZE_MOUSE_Y +
-			WINDOW_KEY_BUTTON__BITS))
+		for(uint32_t i = 0; i <= Arena->WorkerCount; ++i)
 		{
-			break;
+			arena_free(Arena->FrameArenas + i);
+			arena_init(Arena->FrameArenas + i, FrameArenaSize());
 		}
+	}
 
-		uintptr_t MouseX = bit_buffer_get_bits(&buffer, FIELD_SIZE_MOUSE_X);
+	Arena->ExemptAllocCalls += alloc_get_call_count() - AllocCalls;
+}
+
+
+private GameEntity*
+GetEntity(
+	half_extent_t Extent
+	)
+{
+	uint32_t idx;
+
+	if(Arena->FreeEntity != -1)
+	{
+		idx = Arena->FreeEntity;
+		Arena->FreeEntity = Arena->Entities[idx].Next;
+	}
+	else
+	{
+		if(Arena->EntitiesUsed == Arena->EntityCapacity)
+		{
+			ArenaGrowEntities();
+		}
+
+		idx = Arena->EntitiesUsed++;
+	}
+
+	quadtree_insert(&Arena->Quadtree, &(
+		(GameQuadtreeEntity)
+		{
+			.rect_extent = half_to_rect_extent(Extent),
+			.Index = idx
+		}
+	));
+
+	GameEntity* Ret = Arena->Entities + idx;
+	*Ret = (GameEntity){ .Generation = Ret->Generation + 1 };
+
+	bitset_set(&Arena->Alive, idx);
+	history_spawn(&Arena->History, idx);
+
+	EntityStore* Store = &Arena->Store;
+
+	Store->X[idx] = Extent.x;
+	Store->Y[idx] = Extent.y;
+	Store->W[idx] = Extent.w;
+	Store->H[idx] = Extent.h;
+	Store->VX[idx] = 0;
+	Store->VY[idx] = 0;
+	Store->Speed[idx] = 0;
+	Store->Angle[idx] = 0;
+	Store->Spin[idx] = 0;
+	Store->ColVX[idx] = 0;
+	Store->ColVY[idx] = 0;
+	Store->HP[idx] = 0;
+	Store->MaxHP[idx] = 0;
+	Store->DamagedAt[idx] = 0;
+	Store->Flags[idx] = 0;
+
+	Store->Count = MACRO_MAX(Store->Count, idx + 1);
+
+	return Ret;
+}
+
+
+/* The quadtree drops it on its next update, only then is the index reused */
+private void
+RetEntity(
+	GameEntity* Entity
+	)
+{
+	bitset_unset(&Arena->Alive, Entity - Arena->Entities);
+}
+
+
+private GameClient*
+GetClient(
+	void
+	)
+{
+	GameClient* Ret = Arena->Clients;
+
+	if(Arena->FreeClient != -1)
+	{
+		Ret += Arena->FreeClient;
+		Arena->FreeClient = Ret->next;
+	}
+	else
+	{
+		Ret += Arena->ClientsUsed++;
+	}
+
+	*Ret = (GameClient){ .Generation = Ret->Generation + 1 };
+	Ret->Valid = 1;
+
+	atomic_fetch_add_explicit(&Arena->Load, 1, memory_order_relaxed);
+
+	return Ret;
+}
+
+
+private void
+RetClient(
+	void
+	)
+{
+	Client->next = Arena->FreeClient;
+	Client->Valid = 0;
+	Arena->FreeClient = Client - Arena->Clients;
+
+	atomic_fetch_sub_explicit(&Arena->Load, 1, memory_order_relaxed);
+}
+
+
+private float
+LerpF(
+	float old,
+	float New,
+	float By
+	)
+{
+	return old + (New - old) * By;
+}
+
+
+private void
+GetSpawnCoords(
+	half_extent_t* Extent
+	)
+{
+	Extent->x = rand_f32() * (GAME_CONST_HALF_ARENA_SIZE * 2 - Extent->w) - GAME_CONST_HALF_ARENA_SIZE + Extent->w;
+	Extent->y = rand_f32() * (GAME_CONST_HALF_ARENA_SIZE * 2 - Extent->h) - GAME_CONST_HALF_ARENA_SIZE + Extent->h;
+}
+
+
+private void
+SpawnShape(
+	Shape Subtype
+	)
+{
+	half_extent_t Extent =
+	{
+		.w = ShapeHitbox[Subtype],
+		.h = ShapeHitbox[Subtype]
+	};
+
+	GetSpawnCoords(&Extent);
+
+	GameEntity* Entity = GetEntity(Extent);
+	uint32_t EntityIdx = Entity - Arena->Entities;
+	EntityStore* Store = &Arena->Store;
+
+	Entity->type = ENTITY_TYPE_SHAPE;
+	Entity->Subtype = Subtype;
+
+	Store->Speed[EntityIdx] = ShapeSpeed;
+	Store->Angle[EntityIdx] = rand_angle();
+	Store->Spin[EntityIdx] = rand_bool() ? -ShapeSpin : ShapeSpin;
+
+	Store->MaxHP[EntityIdx] = ShapeMaxHP[Subtype];
+	Store->HP[EntityIdx] = MACRO_MIN(Store->MaxHP[EntityIdx], rand_f32() * Store->MaxHP[EntityIdx] * 6);
+	Store->Flags[EntityIdx] = ENTITY_FLAG_CONSTRAIN;
+}
+
+
+private uint64_t
+CheckpointSize(
+	uint32_t EntityCount
+	)
+{
+	return sizeof(CheckpointHeader) + sizeof(CheckpointEntity) * EntityCount;
+}
+
+
+/*
+ * Compresses and writes out whatever CheckpointSave() staged, off the
+ * arena thread. The file is replaced by a rename, so that a crash
+ * mid-write leaves the previous checkpoint intact.
+ */
+private void
+CheckpointWriterFN(
+	void* Data
+	)
+{
+	GameArena* Owner = Data;
+
+	char TempPath[sizeof(Owner->CheckpointPath) + 4];
+	(void) snprintf(TempPath, sizeof(TempPath), "%s.tmp", Owner->CheckpointPath);
+
+	while(1)
+	{
+		sync_sem_wait(&Owner->CheckpointStart);
+
+		const CheckpointHeader* Header = (void*) Owner->CheckpointData;
+		uint64_t RawSize = CheckpointSize(Header->EntityCount);
+
+		uint64_t BoundSize = ZSTD_compressBound(RawSize);
+		uint8_t* Compressed = alloc_malloc(Compressed, BoundSize);
+		assert_not_null(Compressed);
+
+		uint64_t CompressedSize = ZSTD_compress(Compressed, BoundSize, Owner->CheckpointData, RawSize, 3);
+		hard_assert_false(ZSTD_isError(CompressedSize));
+
+		bool Written = file_write(TempPath, (file_t){ .data = Compressed, .len = CompressedSize });
+		if(Written)
+		{
+			Written = !rename(TempPath, Owner->CheckpointPath);
+		}
+
+		if(!Written)
+		{
+			printf("Arena %u failed to write checkpoint %s\n", Owner->Id, Owner->CheckpointPath);
+		}
+
+		alloc_free(Compressed, BoundSize);
+
+		atomic_store_explicit(&Owner->CheckpointBusy, 0, memory_order_release);
+	}
+}
+
+
+/*
+ * Packs live entities, client bodies and the RNG state into the staging
+ * buffer and hands it to the writer thread. Skipped while the writer is
+ * still busy with the previous one, the tick never waits on the disk.
+ */
+private void
+CheckpointSave(
+	void
+	)
+{
+	if(atomic_load_explicit(&Arena->CheckpointBusy, memory_order_acquire))
+	{
+		++Arena->CheckpointsSkipped;
+		return;
+	}
+
+	if(Arena->CheckpointCapacity != Arena->EntityCapacity)
+	{
+		alloc_t AllocCalls = alloc_get_call_count();
+
+		uint64_t OldSize = Arena->CheckpointData ? CheckpointSize(Arena->CheckpointCapacity) : 0;
+
+		Arena->CheckpointData = alloc_remalloc(Arena->CheckpointData,
+			OldSize, CheckpointSize(Arena->EntityCapacity));
+		assert_not_null(Arena->CheckpointData);
+
+		Arena->CheckpointCapacity = Arena->EntityCapacity;
+		Arena->ExemptAllocCalls += alloc_get_call_count() - AllocCalls;
+	}
+
+	CheckpointHeader* Header = (void*) Arena->CheckpointData;
+	CheckpointEntity* Saved = (void*)(Arena->CheckpointData + sizeof(*Header));
+	EntityStore* Store = &Arena->Store;
+
+	*Header =
+	(CheckpointHeader)
+	{
+		.Magic = CHECKPOINT_MAGIC,
+		.Version = CHECKPOINT_VERSION,
+		.Tick = Arena->CurrentTick,
+		.Seed = rand_get_seed()
+	};
+
+	for(uint32_t EntityIdx = 0; bitset_next(&Arena->Alive, &EntityIdx); ++EntityIdx)
+	{
+		const GameEntity* Entity = Arena->Entities + EntityIdx;
+
+		Saved[Header->EntityCount++] =
+		(CheckpointEntity)
+		{
+			.Index = EntityIdx,
+			.Type = Entity->type,
+			.Subtype = Entity->Subtype,
+			.X = Store->X[EntityIdx],
+			.Y = Store->Y[EntityIdx],
+			.W = Store->W[EntityIdx],
+			.H = Store->H[EntityIdx],
+			.Speed = Store->Speed[EntityIdx],
+			.Angle = Store->Angle[EntityIdx],
+			.Spin = Store->Spin[EntityIdx],
+			.ColVX = Store->ColVX[EntityIdx],
+			.ColVY = Store->ColVY[EntityIdx],
+			.HP = Store->HP[EntityIdx],
+			.MaxHP = Store->MaxHP[EntityIdx],
+			.Flags = Store->Flags[EntityIdx],
+			/* The store keeps the low half only, the tick it ran at lends the rest */
+			.DamagedAt = Arena->CurrentTick - (uint32_t)((uint32_t) Arena->CurrentTick - Store->DamagedAt[EntityIdx])
+		};
+	}
+
+	for(uint32_t i = 0; i < Arena->ClientsUsed; ++i)
+	{
+		if(Arena->Clients[i].Valid && !Arena->Clients[i].Spectating)
+		{
+			Header->Bodies[Header->BodyCount++] = Arena->Clients[i].BodyIndex;
+		}
+	}
+
+	atomic_store_explicit(&Arena->CheckpointBusy, 1, memory_order_relaxed);
+	sync_sem_post(&Arena->CheckpointStart);
+}
+
+
+/*
+ * Rebuilds the world from the arena's checkpoint file, if there is a
+ * valid one. Entities get fresh indices. Client bodies are dropped,
+ * since their connections did not survive the restart.
+ */
+private bool
+CheckpointLoad(
+	void
+	)
+{
+	file_t File;
+	if(!file_read(Arena->CheckpointPath, &File))
+	{
+		return false;
+	}
+
+	bool Loaded = false;
+	uint8_t* Raw = NULL;
+
+	/* The size comes from the file, so it is bounded before it is allocated */
+	uint64_t RawSize = ZSTD_getFrameContentSize(File.data, File.len);
+	if(RawSize == ZSTD_CONTENTSIZE_ERROR || RawSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+		RawSize < sizeof(CheckpointHeader) || RawSize > CheckpointSize(GAME_CONST_MAX_ENTITIES))
+	{
+		goto goto_end;
+	}
+
+	Raw = alloc_malloc(Raw, RawSize);
+	assert_not_null(Raw);
+
+	if(ZSTD_decompress(Raw, RawSize, File.data, File.len) != RawSize)
+	{
+		goto goto_end;
+	}
+
+	const CheckpointHeader* Header = (void*) Raw;
+	const CheckpointEntity* Saved = (void*)(Raw + sizeof(*Header));
+
+	if(Header->Magic != CHECKPOINT_MAGIC || Header->Version != CHECKPOINT_VERSION ||
+		Header->BodyCount > GAME_CONST_MAX_PLAYERS || RawSize != CheckpointSize(Header->EntityCount))
+	{
+		goto goto_end;
+	}
+
+	for(uint32_t i = 0; i < Header->EntityCount; ++i)
+	{
+		uint32_t Type = Saved[i].Type;
+		uint32_t Subtype = Saved[i].Subtype;
+
+		if(Type >= ENTITY_TYPE__COUNT ||
+			Subtype >= (Type == ENTITY_TYPE_TANK ? TANK__COUNT : SHAPE__COUNT))
+		{
+			goto goto_end;
+		}
+	}
+
+	EntityStore* Store = &Arena->Store;
+
+	for(const CheckpointEntity* End = Saved + Header->EntityCount; Saved != End; ++Saved)
+	{
+		bool IsBody = false;
+
+		for(uint32_t i = 0; i < Header->BodyCount; ++i)
+		{
+			IsBody |= Header->Bodies[i] == Saved->Index;
+		}
+
+		if(IsBody)
+		{
+			continue;
+		}
+
+		GameEntity* Entity = GetEntity(
+			(half_extent_t)
+			{
+				.x = Saved->X,
+				.y = Saved->Y,
+				.w = Saved->W,
+				.h = Saved->H
+			}
+		);
+		uint32_t EntityIdx = Entity - Arena->Entities;
+
+		Entity->type = Saved->Type;
+		Entity->Subtype = Saved->Subtype;
+
+		Store->X[EntityIdx] = Saved->X;
+		Store->Y[EntityIdx] = Saved->Y;
+		Store->W[EntityIdx] = Saved->W;
+		Store->H[EntityIdx] = Saved->H;
+		Store->Speed[EntityIdx] = Saved->Speed;
+		Store->Angle[EntityIdx] = Saved->Angle;
+		Store->Spin[EntityIdx] = Saved->Spin;
+		Store->ColVX[EntityIdx] = Saved->ColVX;
+		Store->ColVY[EntityIdx] = Saved->ColVY;
+		Store->HP[EntityIdx] = Saved->HP;
+		Store->MaxHP[EntityIdx] = Saved->MaxHP;
+		Store->DamagedAt[EntityIdx] = Saved->DamagedAt;
+		Store->Flags[EntityIdx] = Saved->Flags;
+	}
+
+	Arena->CurrentTick = Header->Tick;
+	rand_set_seed(Header->Seed);
+
+	Loaded = true;
+
+
+	goto_end:
+
+	if(Raw)
+	{
+		alloc_free(Raw, RawSize);
+	}
+
+	file_free(File);
+
+	if(!Loaded)
+	{
+		printf("Arena %u ignoring invalid checkpoint %s\n", Arena->Id, Arena->CheckpointPath);
+	}
+
+	return Loaded;
+}
+
+
+/*
+ * Moves every entity by its own and its collision velocity, decays the
+ * latter, keeps constrained entities inside the arena and regenerates
+ * HP, a vector of entities at a time. Velocities come from the heading
+ * through one batched simd_sincos() over the whole store. Lanes of dead
+ * entities keep their values, and fully dead vectors are skipped.
+ */
+#define ENTITIES_STORE_LIVE(Field)											\
+*(__typeof__(Field)*)(Store->Field + i) = (__typeof__(Field))(			\
+	(Alive & (simd_i32_t) Field) | (~Alive & *(simd_i32_t*)(Store->Field + i)))
+
+private void
+EntitiesIntegrate(
+	void
+	)
+{
+	EntityStore* Store = &Arena->Store;
+	uint32_t Count = (Store->Count + SIMD_WIDTH - 1) & ~(SIMD_WIDTH - 1);
+
+	const float Limit = GAME_CONST_HALF_ARENA_SIZE + GAME_CONST_BORDER_PADDING;
+	const uint32_t Tick = Arena->CurrentTick;
+
+	simd_sincos(Store->Angle, Store->VY, Store->VX, Count);
+
+	simd_u32_t Lane;
+
+	for(uint32_t j = 0; j < SIMD_WIDTH; ++j)
+	{
+		Lane[j] = j;
+	}
+
+	for(uint32_t i = 0; i < Count; i += SIMD_WIDTH)
+	{
+		/* Vectors never straddle a word, the capacity is a multiple of both */
+		uint64_t Live = Arena->Alive.words[i / BITSET_WORD_BITS] >> (i % BITSET_WORD_BITS);
+		Live &= UINT64_MAX >> (BITSET_WORD_BITS - SIMD_WIDTH);
+
+		if(!Live)
+		{
+			continue;
+		}
+
+		simd_i32_t Alive = ((((simd_u32_t){} + (uint32_t) Live) >> Lane) & 1) != 0;
+
+		simd_f32_t X = *(simd_f32_t*)(Store->X + i);
+		simd_f32_t Y = *(simd_f32_t*)(Store->Y + i);
+		simd_f32_t W = *(simd_f32_t*)(Store->W + i);
+		simd_f32_t H = *(simd_f32_t*)(Store->H + i);
+		simd_f32_t VX = *(simd_f32_t*)(Store->VX + i);
+		simd_f32_t VY = *(simd_f32_t*)(Store->VY + i);
+		simd_f32_t Speed = *(simd_f32_t*)(Store->Speed + i);
+		simd_f32_t Angle = *(simd_f32_t*)(Store->Angle + i);
+		simd_f32_t Spin = *(simd_f32_t*)(Store->Spin + i);
+		simd_f32_t ColVX = *(simd_f32_t*)(Store->ColVX + i);
+		simd_f32_t ColVY = *(simd_f32_t*)(Store->ColVY + i);
+		simd_u32_t HP = *(simd_u32_t*)(Store->HP + i);
+		simd_u32_t MaxHP = *(simd_u32_t*)(Store->MaxHP + i);
+		simd_u32_t DamagedAt = *(simd_u32_t*)(Store->DamagedAt + i);
+		simd_u32_t Flags = *(simd_u32_t*)(Store->Flags + i);
+
+		simd_f32_t OldX = X;
+		simd_f32_t OldY = Y;
+
+		VX *= Speed;
+		VY *= Speed;
+
+		X += ColVX;
+		Y += ColVY;
+
+		X += VX;
+		Y += VY;
+
+		/* Keep headings within [-pi, pi], well inside simd_sincos()'s accurate range */
+		Angle += Spin;
+		simd_i32_t Wrap = Angle > (float) M_PI;
+		Angle -= (simd_f32_t)(Wrap & (simd_i32_t)((simd_f32_t){} + (float)(M_PI * 2.0)));
+		Wrap = Angle < (float) -M_PI;
+		Angle += (simd_f32_t)(Wrap & (simd_i32_t)((simd_f32_t){} + (float)(M_PI * 2.0)));
+
+		simd_i32_t Constrain = (simd_i32_t)(Flags & ENTITY_FLAG_CONSTRAIN) != 0;
+
+		simd_i32_t NX = Constrain & (X - W < -Limit);
+		simd_i32_t PX = Constrain & ~NX & (X + W > Limit);
+		simd_i32_t NY = Constrain & (Y - H < -Limit);
+		simd_i32_t PY = Constrain & ~NY & (Y + H > Limit);
+
+		/* The masks are exclusive, so blending the three choices is just an or */
+		X = (simd_f32_t)((NX & (simd_i32_t)(W - Limit)) | (PX & (simd_i32_t)(Limit - W)) | (~(NX | PX) & (simd_i32_t) X));
+		Y = (simd_f32_t)((NY & (simd_i32_t)(H - Limit)) | (PY & (simd_i32_t)(Limit - H)) | (~(NY | PY) & (simd_i32_t) Y));
+
+		simd_i32_t Moved = (X != OldX) | (Y != OldY);
+
+		Flags = (Flags & ENTITY_FLAG_CONSTRAIN) |
+			((simd_u32_t) NX & ENTITY_FLAG_RESET_NX) |
+			((simd_u32_t) PX & ENTITY_FLAG_RESET_PX) |
+			((simd_u32_t) NY & ENTITY_FLAG_RESET_NY) |
+			((simd_u32_t) PY & ENTITY_FLAG_RESET_PY) |
+			((simd_u32_t) Moved & ENTITY_FLAG_MOVED);
+
+		/* Masks are all ones, so subtracting one adds a point of HP */
+		HP -= (simd_u32_t)((HP < MaxHP) & (Tick - DamagedAt >= 200));
+
+		ENTITIES_STORE_LIVE(X);
+		ENTITIES_STORE_LIVE(Y);
+		ENTITIES_STORE_LIVE(VX);
+		ENTITIES_STORE_LIVE(VY);
+		ENTITIES_STORE_LIVE(Angle);
+		ENTITIES_STORE_LIVE(HP);
+		ENTITIES_STORE_LIVE(Flags);
+	}
+
+	simd_lerp_to(Store->ColVX, 0.0f, 0.095f, Count);
+	simd_lerp_to(Store->ColVY, 0.0f, 0.095f, Count);
+}
+
+#undef ENTITIES_STORE_LIVE
+
+
+/*
+ * Retired entities are taken out here, since only the quadtree knows where
+ * they are, and their index becomes free once they are.
+ */
+private quadtree_status_t
+QuadtreeUpdateFN(
+	quadtree_t* Quadtree,
+	quadtree_entity_info_t Info,
+	void* UserData
+	)
+{
+	uint32_t EntityIdx = Info.data->Index;
+	GameEntity* Entity = Arena->Entities + EntityIdx;
+
+	if(!bitset_get(&Arena->Alive, EntityIdx))
+	{
+		quadtree_remove(Quadtree, Info.idx);
+
+		Entity->Next = Arena->FreeEntity;
+		Arena->FreeEntity = EntityIdx;
+
+		return QUADTREE_STATUS_NOT_CHANGED;
+	}
+
+	const EntityStore* Store = &Arena->Store;
+
+	Entity->TookDamage = 0;
+
+	if(!(Store->Flags[EntityIdx] & ENTITY_FLAG_MOVED))
+	{
+		return QUADTREE_STATUS_NOT_CHANGED;
+	}
+
+	Info.data->rect_extent = half_to_rect_extent(
+		(half_extent_t)
+		{
+			.x = Store->X[EntityIdx],
+			.y = Store->Y[EntityIdx],
+			.w = Store->W[EntityIdx],
+			.h = Store->H[EntityIdx]
+		}
+	);
+
+	return QUADTREE_STATUS_CHANGED;
+}
+
+
+/* Bounds only overlap, entities are circles as wide as their bounds */
+private void
+QuadtreeCollideFN(
+	const quadtree_t* Quadtree,
+	quadtree_entity_info_t InfoA,
+	quadtree_entity_info_t InfoB,
+	void* UserData
+	)
+{
+	uint32_t EntityIdxA = InfoA.data->Index;
+	GameEntity* EntityA = Arena->Entities + EntityIdxA;
+
+	uint32_t EntityIdxB = InfoB.data->Index;
+	GameEntity* EntityB = Arena->Entities + EntityIdxB;
+
+	EntityStore* Store = &Arena->Store;
+
+	float DiffX = Store->X[EntityIdxA] - Store->X[EntityIdxB];
+	float DiffY = Store->Y[EntityIdxA] - Store->Y[EntityIdxB];
+	float SumR = Store->W[EntityIdxA] + Store->W[EntityIdxB];
+
+	if(DiffX * DiffX + DiffY * DiffY >= SumR * SumR)
+	{
+		return;
+	}
+
+	StatsAdd(STATS_COUNTER_COLLISIONS, 1);
+
+	float Dist = sqrtf(DiffX * DiffX + DiffY * DiffY);
+
+	if(!Dist)
+	{
+		Dist = 1.0f;
+	}
+
+	DiffX /= Dist;
+	DiffY /= Dist;
+
+	Store->ColVX[EntityIdxA] += DiffX * 5.0f;
+	Store->ColVY[EntityIdxA] += DiffY * 5.0f;
+
+	Store->ColVX[EntityIdxB] -= DiffX * 5.0f;
+	Store->ColVY[EntityIdxB] -= DiffY * 5.0f;
+
+	if(Store->HP[EntityIdxA])
+	{
+		--Store->HP[EntityIdxA];
+	}
+	EntityA->TookDamage = 1;
+	Store->DamagedAt[EntityIdxA] = Arena->CurrentTick;
+
+	if(Store->HP[EntityIdxB])
+	{
+		--Store->HP[EntityIdxB];
+	}
+	EntityB->TookDamage = 1;
+	Store->DamagedAt[EntityIdxB] = Arena->CurrentTick;
+}
+
+
+private quadtree_status_t
+QuadtreeViewQueryFN(
+	quadtree_t* Quadtree,
+	quadtree_entity_info_t Info,
+	void* UserData
+	)
+{
+	StatsAdd(STATS_COUNTER_QUERY_HITS, 1);
+	bitset_set(&Client->View, Info.data->Index);
+
+	return QUADTREE_STATUS_NOT_CHANGED;
+}
+
+
+private void
+ClientChangeFoV(
+	float FoV
+	)
+{
+	Client->FoV = FoV;
+	Client->CameraW = 960.0f / Client->FoV + 200.0f;
+	Client->CameraH = 540.0f / Client->FoV + 200.0f;
+}
+
+
+private void
+ClientViewInit(
+	void
+	)
+{
+	ClientChangeFoV(0.5f);
+
+	bitset_init(&Client->View, Arena->EntityCapacity);
+	bitset_init(&Client->BaselineView, Arena->EntityCapacity);
+
+	Client->SnapshotEntities = alloc_malloc(Client->SnapshotEntities, Arena->EntityCapacity);
+	assert_not_null(Client->SnapshotEntities);
+
+	Client->Budget = GAME_CONST_SNAPSHOT_BUDGET;
+	Client->Priority = alloc_calloc(Client->Priority, Arena->EntityCapacity);
+	assert_not_null(Client->Priority);
+}
+
+
+private void
+ClientCreate(
+	void
+	)
+{
+	Client->ConnectionIdle = Arena->CurrentTick;
+	Client->ActionIdle = Arena->CurrentTick;
+
+	RecordWrite(RECORD_TYPE_CONNECT, NULL, 0);
+
+	/* Allocated first, so that the body's spawn can grow them with the arena */
+	ClientViewInit();
+
+	GameEntity* Body = GetEntity(
+		(half_extent_t)
+		{
+			.x = 0,
+			.y = 0,
+			.w = 70,
+			.h = 70
+		}
+	);
+	Client->BodyIndex = Body - Arena->Entities;
+
+	Arena->Store.Flags[Client->BodyIndex] = ENTITY_FLAG_CONSTRAIN;
+	Arena->Store.MaxHP[Client->BodyIndex] = 1000;
+	Arena->Store.HP[Client->BodyIndex] = 1000;
+
+	ring_init_mirrored(&Client->Outbound, GAME_CONST_SERVER_OUTBOUND_SIZE);
+	ring_init_mirrored(&Client->Inbound, GAME_CONST_CLIENT_PACKET_SIZE);
+}
+
+
+private void
+ClientClose(
+	void
+	)
+{
+	if(ReplayFile)
+	{
+		return;
+	}
+
+	/* The arena's socket is shared, the client is dropped on the next poll */
+	if(Client->Channel)
+	{
+		Client->Closing = 1;
+
+		return;
+	}
+
+	shutdown(Client->FD, SHUT_RDWR);
+}
+
+
+private void
+ClientWantWrite(
+	uint8_t WantsWrite
+	)
+{
+	if(Client->WantsWrite == WantsWrite)
+	{
+		return;
+	}
+
+	Client->WantsWrite = WantsWrite;
+
+	struct epoll_event Event =
+	{
+		.events = EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLRDHUP | (WantsWrite ? EPOLLOUT : 0),
+		.data =
+		{
+			.ptr = Client
+		}
+	};
+	(void) epoll_ctl(Arena->EpollFD, EPOLL_CTL_MOD, Client->FD, &Event);
+}
+
+
+private void
+ClientReleaseShared(
+	void
+	)
+{
+	if(Client->Shared)
+	{
+		--Client->Shared->Refs;
+		Client->Shared = NULL;
+	}
+}
+
+
+/* A shared packet is always queued ahead of the outbound ring */
+private void
+ClientConsume(
+	uint32_t Bytes
+	)
+{
+	StatsAdd(STATS_COUNTER_BYTES_OUT, Bytes);
+
+	if(Client->Shared)
+	{
+		uint32_t SharedBytes = MACRO_MIN(Bytes, Client->Shared->Len - Client->SharedSent);
+
+		Client->SharedSent += SharedBytes;
+		Bytes -= SharedBytes;
+
+		if(Client->SharedSent == Client->Shared->Len)
+		{
+			ClientReleaseShared();
+		}
+	}
+
+	ring_consume(&Client->Outbound, Bytes);
+	Client->SnapshotPending -= MACRO_MIN(Bytes, Client->SnapshotPending);
+}
+
+
+private void
+ClientFlush(
+	void
+	)
+{
+	struct iovec Vec[3];
+	uint32_t Count = 0;
+
+	if(Client->Shared)
+	{
+		Vec[Count].iov_base = Client->Shared->Data + Client->SharedSent;
+		Vec[Count].iov_len = Client->Shared->Len - Client->SharedSent;
+		++Count;
+	}
+
+	ring_segment_t Segments[2];
+	uint32_t SegmentCount = ring_read_segments(&Client->Outbound, Segments);
+
+	for(uint32_t i = 0; i < SegmentCount; ++i)
+	{
+		Vec[Count].iov_base = Segments[i].data;
+		Vec[Count].iov_len = Segments[i].len;
+		++Count;
+	}
+
+	if(Count)
+	{
+		struct msghdr Message =
+		{
+			.msg_iov = Vec,
+			.msg_iovlen = Count
+		};
+
+		ssize_t bytes = sendmsg(Client->FD, &Message, MSG_NOSIGNAL);
+
+		if(bytes >= 0)
+		{
+			ClientConsume(bytes);
+		}
+		else if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+		{
+			ClientClose();
+		}
+	}
+
+	ClientWantWrite(Client->Shared || ring_used(&Client->Outbound));
+}
+
+
+/*
+ * Every message goes out in a datagram of its own, behind the channel's
+ * header. Nothing is queued, so a lost snapshot is simply superseded by
+ * the next one, which is delta encoded against whatever was acked.
+ */
+private void
+ClientSendDatagram(
+	const bit_buffer_t* buffer
+	)
+{
+	uint8_t Data[GAME_CONST_SERVER_PACKET_SIZE + CHANNEL_HEADER_SIZE];
+	uint32_t Len = CHANNEL_HEADER_SIZE + buffer->len;
+
+	if(Len > sizeof(Data))
+	{
+		ClientClose();
+
+		return;
+	}
+
+	(void) memset(Data, 0, Len);
+
+	bit_buffer_t Datagram;
+	bit_buffer_set(&Datagram, Data, Len);
+
+	/* The server has no events of its own, the header only carries acks */
+	(void) channel_write_header(Client->Channel, &Datagram, 0);
+	bit_buffer_set_bytes(&Datagram, buffer->data, buffer->len);
+
+	ssize_t Bytes = sendto(Client->FD, Data, bit_buffer_consumed_bytes(&Datagram), MSG_NOSIGNAL,
+		(const struct sockaddr*) &Client->Peer, sizeof(Client->Peer));
+
+	if(Bytes > 0)
+	{
+		StatsAdd(STATS_COUNTER_BYTES_OUT, Bytes);
+	}
+}
+
+
+/*
+ * Snapshots are only ever queued last, so everything up to the end of
+ * the newest one is still a snapshot's worth of unsent bytes. Smaller
+ * messages queued after it, like pongs, don't count towards that.
+ */
+private void
+ClientSend(
+	const bit_buffer_t* buffer,
+	bool Snapshot
+	)
+{
+	if(ReplayFile)
+	{
+		return;
+	}
+
+	if(Client->Channel)
+	{
+		ClientSendDatagram(buffer);
+
+		return;
+	}
+
+	bool Status;
+	ring_write_safe(&Client->Outbound, buffer->data, buffer->len, &Status);
+
+	if(!Status)
+	{
+		ClientClose();
+
+		return;
+	}
+
+	if(Snapshot)
+	{
+		Client->SnapshotPending = ring_used(&Client->Outbound);
+	}
+
+	if(!Arena->UseUring)
+	{
+		ClientFlush();
+	}
+}
+
+
+private void
+ClientPong(
+	uint64_t Time
+	)
+{
+	uint8_t Data[MACRO_TO_BYTES(SERVER_OPCODE__BITS + FIELD_SIZE_PING_TIME)] = {0};
+
+	bit_buffer_t buffer;
+	bit_buffer_set(&buffer, Data, sizeof(Data));
+
+	bit_buffer_set_bits(&buffer, SERVER_OPCODE_PONG, SERVER_OPCODE__BITS);
+	bit_buffer_set_bits(&buffer, Time, FIELD_SIZE_PING_TIME);
+
+	ClientSend(&buffer, false);
+}
+
+
+private void
+BroadcastInit(
+	GameBroadcast* Broadcast
+	)
+{
+	GameClient* Current = Client;
+	Client = &Broadcast->Viewer;
+
+	ClientViewInit();
+
+	Client = Current;
+
+	for(uint32_t i = 0; i < GAME_CONST_BROADCAST_PACKETS; ++i)
+	{
+		Broadcast->Packets[i].Data = alloc_calloc(Broadcast->Packets[i].Data, GAME_CONST_SERVER_PACKET_SIZE);
+		assert_not_null(Broadcast->Packets[i].Data);
+	}
+}
+
+
+/*
+ * Moves the client into the broadcast following the given entity, giving
+ * up its body if it was still playing. Broadcasts without subscribers are
+ * kept and reused, since their packets may still be in flight.
+ */
+private void
+BroadcastSubscribe(
+	uint32_t Target
+	)
+{
+	if(Target >= Arena->EntityCapacity || !bitset_get(&Arena->Alive, Target) ||
+		(!Client->Spectating && Target == Client->BodyIndex))
+	{
+		return;
+	}
+
+	uint16_t Generation = Arena->Entities[Target].Generation;
+	GameBroadcast* Idle = NULL;
+
+	GameBroadcast* Broadcast = Arena->Broadcasts;
+	GameBroadcast* BroadcastEnd = Arena->Broadcasts + Arena->BroadcastsUsed;
+
+	for(; Broadcast != BroadcastEnd; ++Broadcast)
+	{
+		if(!Broadcast->Subscribers)
+		{
+			Idle = Idle ? Idle : Broadcast;
+			continue;
+		}
+
+		if(Broadcast->Target == Target && Broadcast->TargetGeneration == Generation)
+		{
+			break;
+		}
+	}
+
+	if(Broadcast == BroadcastEnd)
+	{
+		if(Idle)
+		{
+			Broadcast = Idle;
+
+			for(uint32_t i = 0; i < Arena->EntityCapacity; ++i)
+			{
+				Broadcast->Viewer.Priority[i] = 0.0f;
+			}
+		}
+		else if(Arena->BroadcastsUsed != GAME_CONST_MAX_BROADCASTS)
+		{
+			Broadcast = Arena->Broadcasts + Arena->BroadcastsUsed++;
+			BroadcastInit(Broadcast);
+		}
+		else
+		{
+			return;
+		}
+
+		Broadcast->Target = Target;
+		Broadcast->TargetGeneration = Generation;
+		Broadcast->Viewer.Acked = 0;
+	}
+
+	uint32_t Index = Broadcast - Arena->Broadcasts;
+
+	if(Client->Spectating)
+	{
+		if(Client->Broadcast == Index)
+		{
+			return;
+		}
+
+		--Arena->Broadcasts[Client->Broadcast].Subscribers;
+	}
+	else
+	{
+		RetEntity(Arena->Entities + Client->BodyIndex);
+		Client->Spectating = 1;
+	}
+
+	++Broadcast->Subscribers;
+
+	Client->Broadcast = Index;
+	Client->Resync = 1;
+	Client->StaleTicks = 0;
+}
+
+
+private uint32_t
+ClientRead(
+	void
+	)
+{
+	bit_buffer_t buffer;
+	bit_buffer_set(&buffer, ring_read_ptr(&Client->Inbound), ring_used(&Client->Inbound));
+
+	if(buffer.len < MACRO_TO_BYTES(CLIENT_OPCODE__BITS))
+	{
+		return 0;
+	}
+
+	uintptr_t OpCode = bit_buffer_get_bits(&buffer, CLIENT_OPCODE__BITS);
+
+	switch(OpCode)
+	{
+
+	case CLIENT_OPCODE_INPUT:
+	{
+		if(buffer.len < MACRO_TO_BYTES(
+			CLIENT_OPCODE__BITS +
+			FIELD_SIZE_MOUSE_X +
+			FIELD_SIZE_MOUSE_Y +
+			WINDOW_KEY_BUTTON__BITS))
+		{
+			break;
+		}
+
+		uintptr_t MouseX = bit_buffer_get_bits(&buffer, FIELD_SIZE_MOUSE_X);
 		if(MouseX > 1920)
 		{
-			ClientClose();
-			break;
+			ClientClose();
+			break;
+		}
+
+		uintptr_t MouseY = bit_buffer_get_bits(&buffer, FIELD_SIZE_MOUSE_Y);
+		if(MouseY > 1080)
+		{
+			ClientClose();
+			break;
+		}
+
+		uintptr_t Keys = bit_buffer_get_bits(&buffer, WINDOW_KEY_BUTTON__BITS);
+
+		float Vertical = 0;
+		float Horizontal = 0;
+
+		if(Keys & MACRO_POWER_OF_2(WINDOW_KEY_BUTTON_W))
+		{
+			--Vertical;
+		}
+
+		if(Keys & MACRO_POWER_OF_2(WINDOW_KEY_BUTTON_A))
+		{
+			--Horizontal;
+		}
+
+		if(Keys & MACRO_POWER_OF_2(WINDOW_KEY_BUTTON_S))
+		{
+			++Vertical;
+		}
+
+		if(Keys & MACRO_POWER_OF_2(WINDOW_KEY_BUTTON_D))
+		{
+			++Horizontal;
+		}
+
+		if(Vertical || Horizontal)
+		{
+			float Dist = 1 / sqrtf(Vertical * Vertical + Horizontal * Horizontal);
+
+			Vertical *= Dist;
+			Horizontal *= Dist;
+		}
+
+		Client->Vertical = Vertical * GAME_CONST_MAX_MOVEMENT_SPEED;
+		Client->Horizontal = Horizontal * GAME_CONST_MAX_MOVEMENT_SPEED;
+
+		return bit_buffer_consumed_bytes(&buffer);
+	}
+
+	case CLIENT_OPCODE_ACK:
+	{
+		if(buffer.len < MACRO_TO_BYTES(
+			CLIENT_OPCODE__BITS +
+			FIELD_SIZE_SNAPSHOT_SEQ))
+		{
+			break;
+		}
+
+		uint16_t Seq = bit_buffer_get_bits(&buffer, FIELD_SIZE_SNAPSHOT_SEQ);
+
+		/* Broadcasts assume delivery, the spectator's own acks are moot */
+		if(Client->Spectating)
+		{
+			return bit_buffer_consumed_bytes(&buffer);
+		}
+
+		/* Acks for snapshots not yet sent are bogus, stale ones are harmless */
+		if((int16_t)(Seq - Client->SnapshotSeq) >= 0)
+		{
+			ClientClose();
+			break;
+		}
+
+		if(!Client->Acked || (int16_t)(Seq - Client->AckedSeq) > 0)
+		{
+			Client->AckedSeq = Seq;
+			Client->Acked = 1;
+		}
+
+		return bit_buffer_consumed_bytes(&buffer);
+	}
+
+	case CLIENT_OPCODE_PING:
+	{
+		if(buffer.len < MACRO_TO_BYTES(
+			CLIENT_OPCODE__BITS +
+			FIELD_SIZE_PING_TIME))
+		{
+			break;
+		}
+
+		ClientPong(bit_buffer_get_bits(&buffer, FIELD_SIZE_PING_TIME));
+
+		return bit_buffer_consumed_bytes(&buffer);
+	}
+
+	case CLIENT_OPCODE_SPECTATE:
+	{
+		if(buffer.len < MACRO_TO_BYTES(
+			CLIENT_OPCODE__BITS +
+			FIELD_SIZE_ENTITY_INDEX))
+		{
+			break;
+		}
+
+		BroadcastSubscribe(bit_buffer_get_bits(&buffer, FIELD_SIZE_ENTITY_INDEX));
+
+		return bit_buffer_consumed_bytes(&buffer);
+	}
+
+	default:
+	{
+		ClientClose();
+
+		break;
+	}
+
+	}
+
+	return 0;
+}
+
+
+private void
+ClientParse(
+	void
+	)
+{
+	while(ring_used(&Client->Inbound))
+	{
+		uint32_t Read = ClientRead();
+
+		if(Read == 0)
+		{
+			break;
+		}
+
+		RecordWrite(RECORD_TYPE_MESSAGE, ring_read_ptr(&Client->Inbound), Read);
+
+		ring_consume(&Client->Inbound, Read);
+	}
+}
+
+
+private void
+ClientReceive(
+	const uint8_t* Data,
+	uint32_t Len
+	)
+{
+	StatsAdd(STATS_COUNTER_BYTES_IN, Len);
+
+	while(Len)
+	{
+		uint32_t Chunk = MACRO_MIN(Len, ring_available(&Client->Inbound));
+
+		if(!Chunk)
+		{
+			ClientClose();
+
+			return;
+		}
+
+		ring_write(&Client->Inbound, Data, Chunk);
+
+		Data += Chunk;
+		Len -= Chunk;
+
+		ClientParse();
+	}
+}
+
+
+private void
+ClientDrop(
+	void
+	)
+{
+	RecordWrite(RECORD_TYPE_DISCONNECT, NULL, 0);
+
+	Client->Valid = 0;
+
+	if(Client->Spectating)
+	{
+		--Arena->Broadcasts[Client->Broadcast].Subscribers;
+	}
+	else
+	{
+		RetEntity(Arena->Entities + Client->BodyIndex);
+	}
+}
+
+
+private void
+ClientFree(
+	void
+	)
+{
+	bitset_free(&Client->View);
+	bitset_free(&Client->BaselineView);
+	alloc_free(Client->SnapshotEntities, Arena->EntityCapacity);
+	alloc_free(Client->Priority, Arena->EntityCapacity);
+
+	ClientReleaseShared();
+
+	ring_free(&Client->Outbound);
+	ring_free(&Client->Inbound);
+
+	if(Client->Channel)
+	{
+		alloc_free(Client->Channel, 1);
+	}
+}
+
+
+private void
+ClientDestroy(
+	void
+	)
+{
+	ClientDrop();
+	ClientFree();
+}
+
+
+private void
+EntityEncode(
+	uint32_t EntityIdx
+	)
+{
+	EntityEncoding* Encoding = Arena->EntityEncodings + EntityIdx;
+
+	if(Encoding->Tick == Arena->CurrentTick)
+	{
+		return;
+	}
+
+	Encoding->Tick = Arena->CurrentTick;
+
+	GameEntity* Entity = Arena->Entities + EntityIdx;
+
+	bit_buffer_t buffer;
+
+
+	(void) memset(Encoding->Prefix, 0, sizeof(Encoding->Prefix));
+	bit_buffer_set(&buffer, Encoding->Prefix, sizeof(Encoding->Prefix));
+
+	bit_buffer_set_bits(&buffer, Entity->type, ENTITY_TYPE__BITS);
+	bit_buffer_set_bits(&buffer, Entity->Subtype, TypeToSubtypeBits[Entity->type]);
+
+	Encoding->PrefixBits = bit_buffer_consumed_bits(&buffer);
+
+
+	(void) memset(Encoding->CreateSuffix, 0, sizeof(Encoding->CreateSuffix));
+	bit_buffer_set(&buffer, Encoding->CreateSuffix, sizeof(Encoding->CreateSuffix));
+
+	switch(Entity->type)
+	{
+
+	case ENTITY_TYPE_TANK:
+	{
+		bit_buffer_set_fixed_point(&buffer, Arena->Store.W[EntityIdx], FIXED_POINT(RADIUS));
+
+		break;
+	}
+
+	case ENTITY_TYPE_SHAPE:
+	{
+		break;
+	}
+
+	default: __builtin_unreachable();
+
+	}
+
+
+	switch(Entity->type)
+	{
+
+	case ENTITY_TYPE_TANK:
+	case ENTITY_TYPE_SHAPE:
+	{
+		uint32_t HP = Arena->Store.HP[EntityIdx];
+
+		int WriteHP = HP != Arena->Store.MaxHP[EntityIdx];
+		bit_buffer_set_bits(&buffer, WriteHP, 1);
+
+		bit_buffer_set_bits(&buffer, Entity->TookDamage, 1);
+
+		if(WriteHP)
+		{
+			bit_buffer_set_bits(&buffer, HP, ShapeHPBits[Entity->Subtype]);
+		}
+
+		break;
+	}
+
+	default: __builtin_unreachable();
+
+	}
+
+	Encoding->CreateSuffixBits = bit_buffer_consumed_bits(&buffer);
+}
+
+
+private void
+EncodingSplice(
+	bit_buffer_t* buffer,
+	const uint8_t* Data,
+	uint8_t Bits
+	)
+{
+	bit_buffer_t Segment;
+	bit_buffer_set(&Segment, (uint8_t*) Data, MACRO_TO_BYTES(Bits));
+
+	bit_buffer_copy_bits(buffer, &Segment, Bits);
+}
+
+
+private void
+ClientFollow(
+	uint32_t EntityIdx
+	)
+{
+	Client->CameraX = Arena->Store.X[EntityIdx];
+	Client->CameraY = Arena->Store.Y[EntityIdx];
+}
+
+
+private void
+ClientQueryView(
+	void
+	)
+{
+	bitset_clear(&Client->View);
+
+	quadtree_query_rect(&Arena->Quadtree, half_to_rect_extent(
+		(half_extent_t)
+		{
+			.x = Client->CameraX,
+			.y = Client->CameraY,
+			.w = Client->CameraW,
+			.h = Client->CameraH
+		}
+		), QuadtreeViewQueryFN, NULL);
+
+	Client->EntitiesInViewCount = bitset_count(&Client->View);
+
+	for(uint32_t EntityIdx = 0; bitset_next(&Client->View, &EntityIdx); ++EntityIdx)
+	{
+		EntityEncode(EntityIdx);
+	}
+}
+
+
+private int32_t
+QuantizePosition(
+	float Position
+	)
+{
+	return lroundf(Position * (1 << FIXED_POINT_FRACTION_POS));
+}
+
+
+private const Snapshot*
+ClientBaseline(
+	void
+	)
+{
+	if(!Client->Acked)
+	{
+		return NULL;
+	}
+
+	if((uint16_t)(Client->SnapshotSeq - Client->AckedSeq) >= GAME_CONST_SNAPSHOT_HISTORY)
+	{
+		return NULL;
+	}
+
+	const Snapshot* Baseline = Client->Snapshots + (Client->AckedSeq % GAME_CONST_SNAPSHOT_HISTORY);
+
+	if(!Baseline->Valid || Baseline->Seq != Client->AckedSeq)
+	{
+		return NULL;
+	}
+
+	/*
+	 * The new snapshot's entities must not overwrite the baseline's while
+	 * they are being diffed against each other. Unsent removals carry the
+	 * baseline's entities over, so the new one can hold both sets.
+	 */
+	if(Client->SnapshotEntitiesHead - Baseline->First + Baseline->Count +
+		Client->EntitiesInViewCount > Arena->EntityCapacity)
+	{
+		return NULL;
+	}
+
+	return Baseline;
+}
+
+
+private void
+SnapshotEntityFill(
+	SnapshotEntity* Entry,
+	uint32_t EntityIdx
+	)
+{
+	GameEntity* Entity = Arena->Entities + EntityIdx;
+
+	*Entry =
+	(SnapshotEntity)
+	{
+		.Index = EntityIdx,
+		.Generation = Entity->Generation,
+		.HP = Arena->Store.HP[EntityIdx],
+		.X = QuantizePosition(Arena->Store.X[EntityIdx]),
+		.Y = QuantizePosition(Arena->Store.Y[EntityIdx])
+	};
+}
+
+
+private uint32_t
+EntityCreationBits(
+	uint32_t EntityIdx
+	)
+{
+	const EntityEncoding* Encoding = Arena->EntityEncodings + EntityIdx;
+
+	return Encoding->PrefixBits + FIELD_SIZE_POSITION * 2 + Encoding->CreateSuffixBits;
+}
+
+
+private void
+EntityCreationWrite(
+	bit_buffer_t* buffer,
+	const SnapshotEntity* NewEntity
+	)
+{
+	const EntityEncoding* Encoding = Arena->EntityEncodings + NewEntity->Index;
+
+	EncodingSplice(buffer, Encoding->Prefix, Encoding->PrefixBits);
+
+	bit_buffer_set_signed_bits(buffer, NewEntity->X, FIELD_SIZE_POSITION);
+	bit_buffer_set_signed_bits(buffer, NewEntity->Y, FIELD_SIZE_POSITION);
+
+	EncodingSplice(buffer, Encoding->CreateSuffix, Encoding->CreateSuffixBits);
+}
+
+
+private uint32_t
+EntityUpdateBits(
+	const SnapshotEntity* OldEntity,
+	const SnapshotEntity* NewEntity
+	)
+{
+	GameEntity* Entity = Arena->Entities + NewEntity->Index;
+
+	int32_t DeltaX = NewEntity->X - OldEntity->X;
+	int32_t DeltaY = NewEntity->Y - OldEntity->Y;
+
+	uint8_t Moved = DeltaX || DeltaY;
+	uint8_t UpdateHP = NewEntity->HP != OldEntity->HP;
+
+	if(!Moved && !UpdateHP && !Entity->TookDamage)
+	{
+		return 0;
+	}
+
+	uint32_t Bits = 3;
+
+	if(Moved)
+	{
+		Bits += bit_buffer_len_signed_bits_var(DeltaX, FIELD_SIZE_POSITION_DELTA);
+		Bits += bit_buffer_len_signed_bits_var(DeltaY, FIELD_SIZE_POSITION_DELTA);
+	}
+
+	if(UpdateHP)
+	{
+		Bits += ShapeHPBits[Entity->Subtype];
+	}
+
+	return Bits;
+}
+
+
+private void
+EntityUpdateWrite(
+	bit_buffer_t* buffer,
+	const SnapshotEntity* OldEntity,
+	const SnapshotEntity* NewEntity
+	)
+{
+	GameEntity* Entity = Arena->Entities + NewEntity->Index;
+
+	int32_t DeltaX = NewEntity->X - OldEntity->X;
+	int32_t DeltaY = NewEntity->Y - OldEntity->Y;
+
+	uint8_t Moved = DeltaX || DeltaY;
+	uint8_t UpdateHP = NewEntity->HP != OldEntity->HP;
+
+	bit_buffer_set_bits(buffer, Moved, 1);
+
+	if(Moved)
+	{
+		bit_buffer_set_signed_bits_var(buffer, DeltaX, FIELD_SIZE_POSITION_DELTA);
+		bit_buffer_set_signed_bits_var(buffer, DeltaY, FIELD_SIZE_POSITION_DELTA);
+	}
+
+	bit_buffer_set_bits(buffer, UpdateHP, 1);
+
+	if(UpdateHP)
+	{
+		bit_buffer_set_bits(buffer, Arena->Store.HP[NewEntity->Index], ShapeHPBits[Entity->Subtype]);
+	}
+
+	bit_buffer_set_bits(buffer, Entity->TookDamage, 1);
+}
+
+
+private float
+EntityPriority(
+	uint32_t EntityIdx,
+	float Change
+	)
+{
+	GameEntity* Entity = Arena->Entities + EntityIdx;
+	const EntityStore* Store = &Arena->Store;
+
+	float DX = (Store->X[EntityIdx] - Client->CameraX) * Client->FoV;
+	float DY = (Store->Y[EntityIdx] - Client->CameraY) * Client->FoV;
+
+	float Priority = 256.0f / (256.0f + sqrtf(DX * DX + DY * DY));
+	Priority *= 1.0f + Store->W[EntityIdx] * Client->FoV / 64.0f;
+	Priority *= 1.0f + Change;
+
+	if(Entity->type == ENTITY_TYPE_TANK)
+	{
+		Priority *= 2.0f;
+	}
+
+	return Priority;
+}
+
+
+/* Writes the client's next snapshot into zeroed Data, returns its length */
+private uint32_t
+ClientSerialize(
+	arena_t* FrameArena,
+	uint8_t* Data
+	)
+{
+	uint64_t PackStart = ProfileStart();
+	uint64_t SortTime = 0;
+
+	bit_buffer_t buffer;
+	bit_buffer_set(&buffer, Data, GAME_CONST_SERVER_PACKET_SIZE);
+
+	bit_buffer_set_bits(&buffer, SERVER_OPCODE_UPDATE, SERVER_OPCODE__BITS);
+
+	bit_buffer_ctx_t PacketLength = bit_buffer_save(&buffer);
+	bit_buffer_skip_bits(&buffer, GAME_CONST_SERVER_PACKET_SIZE__BITS);
+
+	bit_buffer_set_bits(&buffer, (Arena->CurrentTickAt - Arena->LastTickAt) / 10000, FIELD_SIZE_TICK_DURATION);
+
+	bit_buffer_set_fixed_point(&buffer, Client->FoV, FIXED_POINT(FOV));
+	bit_buffer_set_signed_fixed_point(&buffer, Client->CameraX, FIXED_POINT(POS));
+	bit_buffer_set_signed_fixed_point(&buffer, Client->CameraY, FIXED_POINT(POS));
+
+	const Snapshot* Baseline = ClientBaseline();
+
+	bit_buffer_set_bits(&buffer, Client->SnapshotSeq, FIELD_SIZE_SNAPSHOT_SEQ);
+	bit_buffer_set_bits(&buffer, !!Baseline, 1);
+
+	uint32_t BaseEntity = 0;
+	uint32_t BaseEntityEnd = 0;
+
+	if(Baseline)
+	{
+		bit_buffer_set_bits(&buffer, Baseline->Seq, FIELD_SIZE_SNAPSHOT_SEQ);
+
+		BaseEntity = Baseline->First;
+		BaseEntityEnd = BaseEntity + Baseline->Count;
+	}
+
+
+	/*
+	 * Baseline entities are stored in index order, so walking the union of
+	 * both views in index order pairs every stayed or left entity with the
+	 * next baseline entry.
+	 */
+	bitset_clear(&Client->BaselineView);
+
+	for(uint32_t Base = BaseEntity; Base != BaseEntityEnd; ++Base)
+	{
+		bitset_set(&Client->BaselineView, Client->SnapshotEntities[Base % Arena->EntityCapacity].Index);
+	}
+
+	bitset_diff_iter_t ViewDiff;
+	bitset_diff_init(&ViewDiff, &Client->BaselineView, &Client->View);
+
+	uint32_t EntityIdx;
+	bitset_change_t Change;
+
+	uint32_t MaxRecords = BaseEntityEnd - BaseEntity + Client->EntitiesInViewCount;
+	ViewRecord* Records = arena_alloc_arr(FrameArena, Records, MaxRecords);
+	float* Priorities = arena_alloc_arr(FrameArena, Priorities, MaxRecords);
+	uint32_t* Order = arena_alloc_arr(FrameArena, Order, MaxRecords);
+	uint32_t RecordCount = 0;
+	uint32_t OrderCount = 0;
+
+	while(bitset_diff_next(&ViewDiff, &EntityIdx, &Change))
+	{
+		const SnapshotEntity* OldEntity = NULL;
+
+		if(Change != BITSET_CHANGE_ENTERED)
+		{
+			OldEntity = Client->SnapshotEntities + (BaseEntity % Arena->EntityCapacity);
+			assert_eq(OldEntity->Index, EntityIdx);
+		}
+
+		ViewRecord* Record = Records + RecordCount;
+		float Priority;
+
+		if(Change == BITSET_CHANGE_LEFT)
+		{
+			*Record =
+			(ViewRecord)
+			{
+				.Index = OldEntity->Index,
+				.Kind = ENTITY_RECORD_REMOVE,
+				.Bits = ENTITY_RECORD__BITS,
+				.Base = BaseEntity
+			};
+
+			Priority = 1.0f;
+
+			++BaseEntity;
+		}
+		else
+		{
+			*Record =
+			(ViewRecord)
+			{
+				.Index = EntityIdx,
+				.Base = -1
+			};
+
+			if(!OldEntity)
+			{
+				Record->Kind = ENTITY_RECORD_CREATE;
+				Record->Bits = ENTITY_RECORD__BITS + EntityCreationBits(EntityIdx);
+
+				Priority = EntityPriority(EntityIdx, 4.0f);
+			}
+			else
+			{
+				Record->Base = BaseEntity++;
+
+				if(OldEntity->Generation != Arena->Entities[EntityIdx].Generation)
+				{
+					Record->Kind = ENTITY_RECORD_REPLACE;
+					Record->Bits = ENTITY_RECORD__BITS + EntityCreationBits(EntityIdx);
+
+					Priority = EntityPriority(EntityIdx, 4.0f);
+				}
+				else
+				{
+					SnapshotEntity NewEntity;
+					SnapshotEntityFill(&NewEntity, EntityIdx);
+
+					Record->Kind = ENTITY_RECORD_UPDATE;
+					Record->Bits = EntityUpdateBits(OldEntity, &NewEntity);
+
+					if(Record->Bits)
+					{
+						Record->Bits += ENTITY_RECORD__BITS;
+					}
+
+					float DX = NewEntity.X - OldEntity->X;
+					float DY = NewEntity.Y - OldEntity->Y;
+					float Moved = sqrtf(DX * DX + DY * DY) / (1 << FIXED_POINT_FRACTION_POS);
+
+					Priority = EntityPriority(EntityIdx, Moved * Client->FoV / 32.0f +
+						(NewEntity.HP != OldEntity->HP) + Arena->Entities[EntityIdx].TookDamage);
+				}
+			}
+		}
+
+		if(Record->Bits)
+		{
+			Client->Priority[Record->Index] += Priority;
+
+			Priorities[RecordCount] = Client->Priority[Record->Index];
+			Order[OrderCount++] = RecordCount;
+		}
+		else
+		{
+			Client->Priority[Record->Index] = 0.0f;
+		}
+
+		++RecordCount;
+	}
+
+
+	/*
+	 * Greedily fill the budget in priority order. Index deltas aren't known
+	 * until the selected records are laid out, so the exact size is checked
+	 * once more while writing them.
+	 */
+	uint64_t SortStart = ProfileStart();
+	QuickSortByKey(Order, Priorities, OrderCount);
+	SortTime += ProfileStart() - SortStart;
+
+	uint64_t Budget = (uint64_t) Client->Budget << 3;
+	uint32_t* RecordOrder = Order;
+	uint32_t* RecordOrderEnd = RecordOrder + OrderCount;
+
+	while(RecordOrder != RecordOrderEnd)
+	{
+		ViewRecord* Record = Records + *RecordOrder;
+
+		if(Record->Bits <= Budget)
+		{
+			Record->Selected = 1;
+			Budget -= Record->Bits;
+		}
+
+		++RecordOrder;
+	}
+
+
+	Budget = (uint64_t) Client->Budget << 3;
+
+	uint32_t Count = 0;
+	uint32_t NextIndex = 0;
+
+	ViewRecord* Record = Records;
+	ViewRecord* RecordEnd = Record + RecordCount;
+
+	for(; Record != RecordEnd; ++Record)
+	{
+		if(!Record->Selected)
+		{
+			continue;
+		}
+
+		uint32_t Bits = Record->Bits + bit_buffer_len_bits_var(Record->Index - NextIndex, FIELD_SIZE_INDEX_DELTA);
+
+		if(Bits > Budget)
+		{
+			Record->Selected = 0;
+			continue;
+		}
+
+		Budget -= Bits;
+		NextIndex = Record->Index + 1;
+		++Count;
+	}
+
+	bit_buffer_set_bits_var(&buffer, Count, FIELD_SIZE_RECORD_COUNT);
+
+
+	uint32_t Capacity = Arena->EntityCapacity;
+	uint32_t First = Client->SnapshotEntitiesHead;
+	uint32_t Head = First;
+	NextIndex = 0;
+
+	for(Record = Records; Record != RecordEnd; ++Record)
+	{
+		const SnapshotEntity* OldEntity = NULL;
+
+		if(Record->Base != (uint32_t) -1)
+		{
+			OldEntity = Client->SnapshotEntities + (Record->Base % Capacity);
+		}
+
+		if(!Record->Selected)
+		{
+			/* The client keeps whatever it had in the baseline */
+
+			if(OldEntity)
+			{
+				Client->SnapshotEntities[Head++ % Capacity] = *OldEntity;
+			}
+
+			continue;
+		}
+
+		bit_buffer_set_bits_var(&buffer, Record->Index - NextIndex, FIELD_SIZE_INDEX_DELTA);
+		bit_buffer_set_bits(&buffer, Record->Kind, ENTITY_RECORD__BITS);
+
+		NextIndex = Record->Index + 1;
+		Client->Priority[Record->Index] = 0.0f;
+
+		if(Record->Kind == ENTITY_RECORD_REMOVE)
+		{
+			continue;
+		}
+
+		SnapshotEntity* NewEntity = Client->SnapshotEntities + (Head++ % Capacity);
+		SnapshotEntityFill(NewEntity, Record->Index);
+
+		if(Record->Kind == ENTITY_RECORD_UPDATE)
+		{
+			EntityUpdateWrite(&buffer, OldEntity, NewEntity);
+		}
+		else
+		{
+			EntityCreationWrite(&buffer, NewEntity);
+		}
+	}
+
+	Snapshot* NewSnapshot = Client->Snapshots + (Client->SnapshotSeq % GAME_CONST_SNAPSHOT_HISTORY);
+	*NewSnapshot =
+	(Snapshot)
+	{
+		.Seq = Client->SnapshotSeq,
+		.Valid = 1,
+		.First = First,
+		.Count = Head - First
+	};
+
+	++Client->SnapshotSeq;
+	Client->SnapshotEntitiesHead = Head;
+
+	buffer.len = bit_buffer_consumed_bytes(&buffer);
+
+	bit_buffer_restore(&buffer, &PacketLength);
+	bit_buffer_set_bits(&buffer, buffer.len, GAME_CONST_SERVER_PACKET_SIZE__BITS);
+
+	ProfileEnd(PROFILE_PHASE_PACK, PackStart + SortTime);
+
+	if(Profiling)
+	{
+		histogram_record(Profile + PROFILE_PHASE_SORT, SortTime);
+	}
+
+	return buffer.len;
+}
+
+
+/*
+ * Decides who can take this tick's broadcast packets. Subscribers still
+ * sending an older one are left out, like players with a queued snapshot.
+ */
+private void
+BroadcastPrepare(
+	void
+	)
+{
+	GameBroadcast* Broadcast = Arena->Broadcasts;
+	GameBroadcast* BroadcastEnd = Arena->Broadcasts + Arena->BroadcastsUsed;
+
+	for(; Broadcast != BroadcastEnd; ++Broadcast)
+	{
+		Broadcast->Ready = 0;
+		Broadcast->Waiting = 0;
+		Broadcast->Current = NULL;
+	}
+
+	Client = Arena->Clients;
+	GameClient* ClientEnd = Arena->Clients + Arena->ClientsUsed;
+
+	for(; Client != ClientEnd; ++Client)
+	{
+		if(!Client->Valid || !Client->Spectating)
+		{
+			continue;
+		}
+
+		if(Client->Shared || Client->SnapshotPending)
+		{
+			if(++Client->StaleTicks > GAME_CONST_MAX_STALE_TICKS)
+			{
+				ClientClose();
+			}
+
+			continue;
+		}
+
+		Client->StaleTicks = 0;
+
+		Broadcast = Arena->Broadcasts + Client->Broadcast;
+
+		if(Client->Resync)
+		{
+			++Broadcast->Waiting;
+		}
+		else
+		{
+			++Broadcast->Ready;
+		}
+	}
+}
+
+
+/*
+ * Every subscriber that got the previous packet is known to have it, TCP
+ * delivers it, so it is the baseline of the next one. Those that missed a
+ * packet wait for a keyframe, sent once in a while or when nobody else is
+ * listening anyway.
+ */
+private void
+BroadcastSerialize(
+	GameBroadcast* Broadcast,
+	arena_t* FrameArena
+	)
+{
+	if(!Broadcast->Ready && !Broadcast->Waiting)
+	{
+		return;
+	}
+
+	BroadcastPacket* Packet = Broadcast->Packets;
+	BroadcastPacket* PacketEnd = Broadcast->Packets + GAME_CONST_BROADCAST_PACKETS;
+
+	while(Packet != PacketEnd && Packet->Refs)
+	{
+		++Packet;
+	}
+
+	if(Packet == PacketEnd)
+	{
+		return;
+	}
+
+	Client = &Broadcast->Viewer;
+
+	if(Broadcast->Waiting && (!Broadcast->Ready ||
+		Arena->CurrentTick - Broadcast->LastKeyframe >= GAME_CONST_BROADCAST_KEYFRAME_TICKS))
+	{
+		Client->Acked = 0;
+	}
+
+	Broadcast->Keyframe = !ClientBaseline();
+
+	if(Broadcast->Keyframe)
+	{
+		Broadcast->LastKeyframe = Arena->CurrentTick;
+	}
+
+	(void) memset(Packet->Data, 0, Packet->Len);
+
+	arena_reset(FrameArena);
+	Packet->Len = ClientSerialize(FrameArena, Packet->Data);
+
+	Client->AckedSeq = Client->SnapshotSeq - 1;
+	Client->Acked = 1;
+
+	Broadcast->Current = Packet;
+}
+
+
+/*
+ * Hands each subscriber a reference to its broadcast's packet instead of
+ * a copy, unless smaller messages are queued already. A subscriber that
+ * misses one can't apply the deltas after it.
+ */
+private void
+BroadcastFanOut(
+	void
+	)
+{
+	Client = Arena->Clients;
+	GameClient* ClientEnd = Arena->Clients + Arena->ClientsUsed;
+
+	for(; Client != ClientEnd; ++Client)
+	{
+		if(!Client->Valid || !Client->Spectating)
+		{
+			continue;
+		}
+
+		GameBroadcast* Broadcast = Arena->Broadcasts + Client->Broadcast;
+		BroadcastPacket* Packet = Broadcast->Current;
+
+		if(!Packet)
+		{
+			continue;
+		}
+
+		if(Client->Shared || Client->SnapshotPending || (Client->Resync && !Broadcast->Keyframe))
+		{
+			Client->Resync = 1;
+
+			continue;
+		}
+
+		Client->Resync = 0;
+
+		if(ReplayFile)
+		{
+			continue;
+		}
+
+		/* Can't go ahead of a smaller message that may be partially sent,
+		   and datagrams are built per client anyway */
+		if(ring_used(&Client->Outbound) || Client->Channel)
+		{
+			bit_buffer_t buffer;
+			bit_buffer_set(&buffer, Packet->Data, Packet->Len);
+
+			ClientSend(&buffer, true);
+
+			continue;
+		}
+
+		Client->Shared = Packet;
+		Client->SharedSent = 0;
+		++Packet->Refs;
+
+		if(!Arena->UseUring)
+		{
+			ClientFlush();
+		}
+	}
+}
+
+
+private void
+SerializeClients(
+	arena_t* FrameArena
+	)
+{
+	while(1)
+	{
+		uint32_t Idx = atomic_fetch_add_explicit(&Arena->NextClient, 1, memory_order_relaxed);
+
+		if(Idx >= Arena->ClientsUsed + Arena->BroadcastsUsed)
+		{
+			break;
+		}
+
+		if(Idx >= Arena->ClientsUsed)
+		{
+			BroadcastSerialize(Arena->Broadcasts + Idx - Arena->ClientsUsed, FrameArena);
+
+			continue;
+		}
+
+		Client = Arena->Clients + Idx;
+
+		if(!Client->Valid || Client->Spectating)
+		{
+			continue;
+		}
+
+		/*
+		 * A queued snapshot may already be partially written to the stream,
+		 * so it can't be replaced. Skip building a new one instead, so that
+		 * the next one that does get built carries the newest state.
+		 */
+		if(Client->SnapshotPending)
+		{
+			if(++Client->StaleTicks > GAME_CONST_MAX_STALE_TICKS)
+			{
+				ClientClose();
+			}
+
+			continue;
+		}
+
+		Client->StaleTicks = 0;
+
+		arena_reset(FrameArena);
+
+		uint8_t* Data = arena_calloc_arr(FrameArena, Data, GAME_CONST_SERVER_PACKET_SIZE);
+
+		bit_buffer_t buffer;
+		bit_buffer_set(&buffer, Data, ClientSerialize(FrameArena, Data));
+		StatsPeak(FrameArenaSize() - arena_available(FrameArena));
+
+		uint64_t SendStart = ProfileStart();
+		ClientSend(&buffer, true);
+		ProfileEnd(PROFILE_PHASE_SEND, SendStart);
+	}
+}
+
+
+private void
+WorkerFN(
+	void* Data
+	)
+{
+	GameWorker* Worker = Data;
+	arena_t* FrameArena = Worker->FrameArena;
+
+	Arena = Worker->Arena;
+	Stats = Arena->StatsSets + Worker->Index;
+
+	if(Profiling)
+	{
+		Profile = Arena->ProfileSets + Worker->Index * PROFILE_PHASE__COUNT;
+	}
+
+	while(1)
+	{
+		sync_sem_wait(&Arena->WorkStart);
+
+		alloc_t AllocCalls = alloc_get_call_count();
+
+		SerializeClients(FrameArena);
+
+		/* The count is per thread, the arena thread sums them up */
+		Worker->AllocCalls = alloc_get_call_count() - AllocCalls;
+
+		sync_sem_post(&Arena->WorkDone);
+	}
+}
+
+
+private void
+GameUpdate(
+	void
+	)
+{
+	uint64_t Start = ProfileStart();
+
+	Client = Arena->Clients;
+	GameClient* ClientEnd = Arena->Clients + Arena->ClientsUsed;
+
+	for(; Client != ClientEnd; ++Client)
+	{
+		if(!Client->Valid || Client->Spectating)
+		{
+			continue;
+		}
+
+		EntityStore* Store = &Arena->Store;
+		uint32_t Flags = Store->Flags[Client->BodyIndex];
+
+		Client->MovementVX = LerpF(Client->MovementVX, Client->Horizontal, 0.095f);
+		Client->MovementVY = LerpF(Client->MovementVY, Client->Vertical, 0.095f);
+
+		if(((Flags & ENTITY_FLAG_RESET_PX) && Client->MovementVX > 0) ||
+			((Flags & ENTITY_FLAG_RESET_NX) && Client->MovementVX < 0))
+		{
+			Client->MovementVX = 0;
+		}
+
+		if(((Flags & ENTITY_FLAG_RESET_PY) && Client->MovementVY > 0) ||
+			((Flags & ENTITY_FLAG_RESET_NY) && Client->MovementVY < 0))
+		{
+			Client->MovementVY = 0;
+		}
+
+		Store->X[Client->BodyIndex] += Client->MovementVX;
+		Store->Y[Client->BodyIndex] += Client->MovementVY;
+	}
+
+	EntitiesIntegrate();
+
+	/* Dead slots are recorded too, history_spawn() tells their next owner apart */
+	EntityStore* Store = &Arena->Store;
+	history_record(&Arena->History, Arena->CurrentTick, Store->X, Store->Y, Store->W, Store->H, Store->Count);
+
+	Start = ProfileEnd(PROFILE_PHASE_MOVEMENT, Start);
+
+	/* The quadtree only allocates when its buffers have to grow */
+	uint64_t QuadtreeMemory = quadtree_memory_usage(&Arena->Quadtree);
+	alloc_t AllocCalls = alloc_get_call_count();
+
+	quadtree_update(&Arena->Quadtree, QuadtreeUpdateFN, NULL);
+	Start = ProfileEnd(PROFILE_PHASE_QUADTREE_UPDATE, Start);
+
+	quadtree_collide(&Arena->Quadtree, QuadtreeCollideFN, NULL);
+	Start = ProfileEnd(PROFILE_PHASE_QUADTREE_COLLIDE, Start);
+
+	if(quadtree_memory_usage(&Arena->Quadtree) != QuadtreeMemory)
+	{
+		Arena->ExemptAllocCalls += alloc_get_call_count() - AllocCalls;
+	}
+
+	Client = Arena->Clients;
+
+	for(; Client != ClientEnd; ++Client)
+	{
+		if(!Client->Valid || Client->Spectating)
+		{
+			continue;
+		}
+
+		ClientFollow(Client->BodyIndex);
+		ClientQueryView();
+	}
+
+	GameBroadcast* Broadcast = Arena->Broadcasts;
+	GameBroadcast* BroadcastEnd = Arena->Broadcasts + Arena->BroadcastsUsed;
+
+	for(; Broadcast != BroadcastEnd; ++Broadcast)
+	{
+		if(!Broadcast->Subscribers)
+		{
+			continue;
+		}
+
+		Client = &Broadcast->Viewer;
+
+		/* Once the target is gone, the camera stays where it last was */
+		if(bitset_get(&Arena->Alive, Broadcast->Target) &&
+			Arena->Entities[Broadcast->Target].Generation == Broadcast->TargetGeneration)
+		{
+			ClientFollow(Broadcast->Target);
+		}
+
+		ClientQueryView();
+	}
+
+	Start = ProfileEnd(PROFILE_PHASE_QUERY, Start);
+
+	BroadcastPrepare();
+
+	atomic_store_explicit(&Arena->NextClient, 0, memory_order_relaxed);
+
+	for(uint32_t i = 0; i < Arena->WorkerCount; ++i)
+	{
+		sync_sem_post(&Arena->WorkStart);
+	}
+
+	SerializeClients(Arena->FrameArenas);
+
+	for(uint32_t i = 0; i < Arena->WorkerCount; ++i)
+	{
+		sync_sem_wait(&Arena->WorkDone);
+	}
+
+	Start = ProfileEnd(PROFILE_PHASE_SERIALIZE, Start);
+
+	BroadcastFanOut();
+
+	ProfileEnd(PROFILE_PHASE_FANOUT, Start);
+}
+
+
+private bool
+ReplayNext(
+	RecordEvent* Event,
+	uint8_t* Data
+	)
+{
+	if(fread(Event, sizeof(*Event), 1, ReplayFile) != 1)
+	{
+		return false;
+	}
+
+	hard_assert_lt(Event->Slot, GAME_CONST_MAX_PLAYERS);
+	hard_assert_le(Event->Len, GAME_CONST_CLIENT_PACKET_SIZE);
+	hard_assert_le(Event->Type, RECORD_TYPE_MESSAGE);
+
+	return fread(Data, 1, Event->Len, ReplayFile) == Event->Len;
+}
+
+
+private void
+Replay(
+	void
+	)
+{
+	GameClient* Slots[GAME_CONST_MAX_PLAYERS] = {0};
+	RecordEvent Event;
+	uint8_t Data[GAME_CONST_CLIENT_PACKET_SIZE];
+
+	bool HaveEvent = ReplayNext(&Event, Data);
+	uint64_t ReplayStart = time_get_monotonic();
+
+	Arena->LastTickAt = 0;
+
+	while(HaveEvent)
+	{
+		++Arena->CurrentTick;
+		Arena->CurrentTickAt = Arena->LastTickAt + time_ms_to_ns(GAME_CONST_TICK_RATE_MS);
+
+		uint64_t TickStart = ProfileStart();
+
+		while(HaveEvent && Event.Tick <= Arena->CurrentTick)
+		{
+			Client = Slots[Event.Slot];
+
+			switch(Event.Type)
+			{
+
+			case RECORD_TYPE_CONNECT:
+			{
+				assert_null(Client);
+
+				Client = GetClient();
+				Client->FD = -1;
+
+				ClientCreate();
+
+				Slots[Event.Slot] = Client;
+
+				break;
+			}
+
+			case RECORD_TYPE_DISCONNECT:
+			{
+				assert_not_null(Client);
+
+				ClientDestroy();
+				RetClient();
+
+				Slots[Event.Slot] = NULL;
+
+				break;
+			}
+
+			case RECORD_TYPE_MESSAGE:
+			{
+				assert_not_null(Client);
+
+				ClientReceive(Data, Event.Len);
+
+				break;
+			}
+
+			default: assert_unreachable();
+
+			}
+
+			HaveEvent = ReplayNext(&Event, Data);
+		}
+
+		GameUpdate();
+
+		ProfileTick(TickStart);
+
+		Arena->LastTickAt = Arena->CurrentTickAt;
+	}
+
+	uint64_t Elapsed = time_get_monotonic() - ReplayStart;
+
+	printf("Replayed %lu ticks in %.3f s, %.1f ticks/s\n", Arena->CurrentTick,
+		Elapsed / 1e9, Arena->CurrentTick / (Elapsed / 1e9));
+}
+
+
+private void
+EpollAccept(
+	int SocketFD
+	)
+{
+	if(Arena->ClientsUsed == GAME_CONST_MAX_PLAYERS && Arena->FreeClient == -1)
+	{
+		close(SocketFD);
+
+		return;
+	}
+
+	Client = GetClient();
+	Client->FD = SocketFD;
+
+	ClientCreate();
+
+	(void) fcntl(SocketFD, F_SETFL, fcntl(SocketFD, F_GETFL, 0) | O_NONBLOCK);
+
+	struct epoll_event Event =
+	{
+		.events = EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLRDHUP,
+		.data =
+		{
+			.ptr = Client
+		}
+	};
+	epoll_ctl(Arena->EpollFD, EPOLL_CTL_ADD, SocketFD, &Event);
+}
+
+
+/* Datagrams from an unknown peer are its connection attempt */
+private GameClient*
+DatagramClient(
+	const struct sockaddr_in6* Peer
+	)
+{
+	GameClient* Current = Arena->Clients;
+	GameClient* ClientEnd = Arena->Clients + Arena->ClientsUsed;
+
+	for(; Current != ClientEnd; ++Current)
+	{
+		if(Current->Valid && Current->Channel &&
+			Current->Peer.sin6_port == Peer->sin6_port &&
+			!memcmp(&Current->Peer.sin6_addr, &Peer->sin6_addr, sizeof(Peer->sin6_addr)))
+		{
+			return Current;
+		}
+	}
+
+	if(Arena->ClientsUsed == GAME_CONST_MAX_PLAYERS && Arena->FreeClient == -1)
+	{
+		return NULL;
+	}
+
+	Client = GetClient();
+	Client->FD = Arena->DatagramFD;
+	Client->Peer = *Peer;
+
+	Client->Channel = alloc_malloc(Client->Channel, 1);
+	assert_not_null(Client->Channel);
+
+	channel_init(Client->Channel);
+
+	ClientCreate();
+
+	return Client;
+}
+
+
+/*
+ * Each datagram is parsed on its own, so that a truncated one can't
+ * leave half a message behind for the next. Reliable messages are taken
+ * in order from every datagram, the rest only from the newest one.
+ */
+private void
+DatagramReceive(
+	const struct sockaddr_in6* Peer,
+	const uint8_t* Data,
+	uint32_t Len
+	)
+{
+	Client = DatagramClient(Peer);
+
+	if(!Client || Client->Closing)
+	{
+		return;
+	}
+
+	Client->ConnectionIdle = Arena->CurrentTick;
+
+	bit_buffer_t buffer;
+	bit_buffer_set(&buffer, (void*) Data, Len);
+
+	channel_packet_info_t Info;
+	bool Status;
+	channel_read_header(Client->Channel, &buffer, &Info, &Status);
+
+	if(!Status)
+	{
+		ClientClose();
+
+		return;
+	}
+
+	uint8_t Message[GAME_CONST_SERVER_RECV_SIZE];
+	uint32_t MessageLen;
+
+	while(channel_recv_reliable(Client->Channel, Message, &MessageLen))
+	{
+		ClientReceive(Message, MessageLen);
+		ring_consume(&Client->Inbound, ring_used(&Client->Inbound));
+	}
+
+	if(!Info.fresh)
+	{
+		return;
+	}
+
+	MessageLen = MACRO_MIN(bit_buffer_available_bits(&buffer) >> 3, sizeof(Message));
+	bit_buffer_get_bytes(&buffer, Message, MessageLen);
+
+	ClientReceive(Message, MessageLen);
+	ring_consume(&Client->Inbound, ring_used(&Client->Inbound));
+}
+
+
+/* Peers never hang up, they go quiet, or get closed by the server */
+private void
+NetPollDatagrams(
+	void
+	)
+{
+	uint8_t Data[GAME_CONST_SERVER_RECV_SIZE];
+
+	while(1)
+	{
+		struct sockaddr_in6 Peer;
+		socklen_t PeerLen = sizeof(Peer);
+
+		ssize_t Bytes = recvfrom(Arena->DatagramFD, Data, sizeof(Data), 0, (struct sockaddr*) &Peer, &PeerLen);
+
+		if(Bytes < 0)
+		{
+			break;
+		}
+
+		DatagramReceive(&Peer, Data, Bytes);
+	}
+
+	Client = Arena->Clients;
+	GameClient* ClientEnd = Arena->Clients + Arena->ClientsUsed;
+
+	for(; Client != ClientEnd; ++Client)
+	{
+		if(Client->Valid && Client->Channel && (Client->Closing ||
+			Arena->CurrentTick - Client->ConnectionIdle > GAME_CONST_MAX_STALE_TICKS))
+		{
+			ClientDestroy();
+			RetClient();
+		}
+	}
+}
+
+private void
+NetPollEpoll(
+	void
+	)
+{
+	uint64_t Start = ProfileStart();
+
+	int count = epoll_wait(Arena->EpollFD, Arena->Events, GAME_CONST_MAX_PLAYERS, 0);
+
+	struct epoll_event* Event = Arena->Events;
+	struct epoll_event* EventEnd = Event + count;
+
+	for(; Event != EventEnd; ++Event)
+	{
+		uint32_t flags = Event->events;
+		Client = Event->data.ptr;
+
+		if(flags & (EPOLLHUP | EPOLLERR | EPOLLRDHUP))
+		{
+			ClientDestroy();
+
+			close(Client->FD);
+			RetClient();
+
+			continue;
 		}
 
-		uintptr_t MouseY = bit_buffer_get_bits(&buffer, FIELD_SIZE_MOUSE_Y);
-		if(MouseY > 1080)
+		if(flags & EPOLLOUT)
 		{
-			ClientClose();
-			break;
+			ClientFlush();
 		}
 
-		uintptr_t Keys = bit_buffer_get_bits(&buffer, WINDOW_KEY_BUTTON__BITS);
+		if(flags & EPOLLIN)
+		{
+			ssize_t bytes = read(Client->FD, ring_write_ptr(&Client->Inbound), ring_available(&Client->Inbound));
 
-		float Vertical = 0;
-		float Horizontal = 0;
+			if(bytes >= 0)
+			{
+				StatsAdd(STATS_COUNTER_BYTES_IN, bytes);
+				ring_produce(&Client->Inbound, bytes);
+
+				ClientParse();
+			}
+		}
+	}
+
+	if(Datagrams)
+	{
+		NetPollDatagrams();
+	}
+
+	Start = ProfileEnd(PROFILE_PHASE_READ, Start);
+
+	while(Arena->Accepts && (Arena->ClientsUsed != GAME_CONST_MAX_PLAYERS || Arena->FreeClient != -1))
+	{
+		struct sockaddr_in6 Addr;
+		socklen_t AddrLen = sizeof(Addr);
+		int SocketFD = accept(ServerFD, (struct sockaddr*) &Addr, &AddrLen);
 
-		if(Keys & SHIFT(WINDOW_KEY_BUTTON_W))
+		if(SocketFD == -1)
 		{
-			--Vertical;
+			assert_neq(errno, ENOMEM);
+			assert_neq(errno, ENFILE);
+			assert_neq(errno, EMFILE);
+			assert_neq(errno, EINVAL);
+
+			if(errno == EAGAIN)
+			{
+				break;
+			}
+
+			continue;
 		}
 
-		if(Keys & SHIFT(WINDOW_KEY_BUTTON_A))
+		EpollAccept(SocketFD);
+	}
+
+	ProfileEnd(PROFILE_PHASE_ACCEPT, Start);
+}
+
+
+private uint64_t
+UringData(
+	UringOp Op
+	)
+{
+	return ((uint64_t) Op << 48) | ((uint64_t) Client->Generation << 16) | (Client - Arena->Clients);
+}
+
+
+private void
+UringClientClose(
+	void
+	)
+{
+	if(!Client->Closing)
+	{
+		Client->Closing = 1;
+
+		ClientDrop();
+
+		(void) shutdown(Client->FD, SHUT_RDWR);
+
+		if(Client->RecvArmed)
 		{
-			--Horizontal;
+			(void) uring_cancel(&Arena->Uring, UringData(URING_OP_RECV), UringData(URING_OP_CANCEL));
+		}
+	}
+
+	if(!Client->RecvArmed && !Client->SendInFlight)
+	{
+		ClientFree();
+
+		close(Client->FD);
+		RetClient();
+	}
+}
+
+
+private void
+UringAccept(
+	int SocketFD
+	)
+{
+	if(Arena->ClientsUsed == GAME_CONST_MAX_PLAYERS && Arena->FreeClient == -1)
+	{
+		close(SocketFD);
+
+		return;
+	}
+
+	Client = GetClient();
+	Client->FD = SocketFD;
+
+	ClientCreate();
+
+	Client->RecvArmed = uring_recv_multishot(&Arena->Uring, SocketFD, UringData(URING_OP_RECV));
+
+	if(!Client->RecvArmed)
+	{
+		UringClientClose();
+	}
+}
+
+
+/* Takes over connections routed to this arena by the acceptor thread */
+private void
+NetAdoptPending(
+	void
+	)
+{
+	int Pending[GAME_CONST_MAX_PLAYERS];
+
+	sync_mtx_lock(&Arena->PendingLock);
+
+	uint32_t Count = Arena->PendingCount;
+	(void) memcpy(Pending, Arena->Pending, sizeof(*Pending) * Count);
+	Arena->PendingCount = 0;
+
+	sync_mtx_unlock(&Arena->PendingLock);
+
+	for(uint32_t i = 0; i < Count; ++i)
+	{
+		if(Arena->UseUring)
+		{
+			UringAccept(Pending[i]);
+		}
+		else
+		{
+			EpollAccept(Pending[i]);
+		}
+	}
+}
+
+
+private void
+NetPollUring(
+	void
+	)
+{
+	uring_event_t Event;
+
+	(void) uring_submit(&Arena->Uring, 0);
+
+	while(uring_next_event(&Arena->Uring, &Event))
+	{
+		UringOp Op = Event.user_data >> 48;
+
+		if(Op == URING_OP_ACCEPT)
+		{
+			if(Event.res >= 0)
+			{
+				UringAccept(Event.res);
+			}
+
+			if(!Event.more)
+			{
+				Arena->AcceptArmed = uring_accept_multishot(&Arena->Uring, ServerFD, (uint64_t) URING_OP_ACCEPT << 48);
+			}
+
+			continue;
 		}
 
-		if(Keys & SHIFT(WINDOW_KEY_BUTTON_S))
+		if(Op == URING_OP_CANCEL)
 		{
-			++Vertical;
+			continue;
 		}
 
-		if(Keys & SHIFT(WINDOW_KEY_BUTTON_D))
+		Client = Arena->Clients + (Event.user_data & 0xFFFF);
+
+		if(Client->Generation != (uint32_t)(Event.user_data >> 16))
 		{
-			++Horizontal;
+			if(Event.buf)
+			{
+				uring_return_buf(&Arena->Uring, Event.buf_id);
+			}
+
+			continue;
 		}
 
-		if(Vertical || Horizontal)
+		if(Op == URING_OP_RECV)
 		{
-			float Dist = 1 / sqrtf(Vertical * Vertical + Horizontal * Horizontal);
+			Client->RecvArmed = Event.more;
 
-			Vertical *= Dist;
-			Horizontal *= Dist;
+			if(Event.buf)
+			{
+				if(!Client->Closing)
+				{
+					ClientReceive(Event.buf, Event.res);
+				}
+
+				uring_return_buf(&Arena->Uring, Event.buf_id);
+			}
+
+			if(Client->Closing || (Event.res <= 0 && Event.res != -ENOBUFS))
+			{
+				UringClientClose();
+			}
+			else if(!Client->RecvArmed)
+			{
+				Client->RecvArmed = uring_recv_multishot(&Arena->Uring, Client->FD, UringData(URING_OP_RECV));
+			}
+		}
+		else
+		{
+			Client->SendInFlight = 0;
+
+			if(Event.res > 0)
+			{
+				ClientConsume(Event.res);
+			}
+
+			if(Client->Closing || Event.res < 0)
+			{
+				UringClientClose();
+			}
+		}
+	}
+
+	if(Arena->Accepts && !Arena->AcceptArmed)
+	{
+		Arena->AcceptArmed = uring_accept_multishot(&Arena->Uring, ServerFD, (uint64_t) URING_OP_ACCEPT << 48);
+	}
+}
+
+
+private void
+NetFlushUring(
+	void
+	)
+{
+	Client = Arena->Clients;
+	GameClient* ClientEnd = Arena->Clients + Arena->ClientsUsed;
+
+	for(; Client != ClientEnd; ++Client)
+	{
+		if(!Client->Valid || Client->SendInFlight)
+		{
+			continue;
+		}
+
+		if(Client->Shared)
+		{
+			Client->SendInFlight = uring_send(&Arena->Uring, Client->FD, Client->Shared->Data + Client->SharedSent,
+				Client->Shared->Len - Client->SharedSent, UringData(URING_OP_SEND));
+
+			continue;
+		}
+
+		uint32_t Used = ring_used(&Client->Outbound);
+
+		if(!Used)
+		{
+			continue;
+		}
+
+		/* Mirrored, so whatever is queued is contiguous and goes out at once */
+		Client->SendInFlight = uring_send(&Arena->Uring, Client->FD,
+			ring_read_ptr(&Client->Outbound), Used, UringData(URING_OP_SEND));
+	}
+
+	(void) uring_submit(&Arena->Uring, 0);
+}
+
+
+private uint64_t
+StatsRate(
+	const uint64_t* Totals,
+	StatsCounter Counter,
+	uint64_t Elapsed
+	)
+{
+	return (Totals[Counter] - Arena->StatsTotals[Counter]) * 1e9 / MACRO_MAX(Elapsed, 1);
+}
+
+
+/*
+ * Folds every thread's counters into one window and publishes it under
+ * a sequence count, the endpoint retries instead of the tick waiting.
+ */
+private void
+StatsPublish(
+	uint64_t Now
+	)
+{
+	uint64_t Totals[STATS_COUNTER__COUNT] = {0};
+	uint64_t FramePeak = 0;
+
+	for(uint32_t i = 0; i <= Arena->WorkerCount; ++i)
+	{
+		GameStats* Set = Arena->StatsSets + i;
+
+		for(uint32_t Counter = 0; Counter < STATS_COUNTER__COUNT; ++Counter)
+		{
+			Totals[Counter] += atomic_load_explicit(Set->Counters + Counter, memory_order_relaxed);
+		}
+
+		FramePeak = MACRO_MAX(FramePeak, atomic_load_explicit(&Set->FramePeak, memory_order_relaxed));
+	}
+
+	uint32_t Spectators = 0;
+
+	for(GameClient* Spectator = Arena->Clients; Spectator != Arena->Clients + Arena->ClientsUsed; ++Spectator)
+	{
+		Spectators += Spectator->Valid && Spectator->Spectating;
+	}
+
+	uint64_t Elapsed = Now - Arena->StatsWindowAt;
+
+	uint64_t Fields[STATS_FIELD__COUNT] =
+	{
+		[STATS_FIELD_TICK] = Arena->CurrentTick,
+		[STATS_FIELD_CLIENTS] = atomic_load_explicit(&Arena->Load, memory_order_relaxed) - Spectators,
+		[STATS_FIELD_SPECTATORS] = Spectators,
+		[STATS_FIELD_ENTITIES] = bitset_count(&Arena->Alive),
+		[STATS_FIELD_ENTITY_CAPACITY] = Arena->EntityCapacity,
+		[STATS_FIELD_TICK_P50_US] = histogram_percentile(&Arena->StatsTicks, 50.0) / 1000,
+		[STATS_FIELD_TICK_P99_US] = histogram_percentile(&Arena->StatsTicks, 99.0) / 1000,
+		[STATS_FIELD_TICK_MAX_US] = Arena->StatsTicks.max / 1000,
+		[STATS_FIELD_OVERRUNS] = Arena->StatsOverruns,
+		[STATS_FIELD_BYTES_IN_PER_SEC] = StatsRate(Totals, STATS_COUNTER_BYTES_IN, Elapsed),
+		[STATS_FIELD_BYTES_OUT_PER_SEC] = StatsRate(Totals, STATS_COUNTER_BYTES_OUT, Elapsed),
+		[STATS_FIELD_COLLISIONS_PER_SEC] = StatsRate(Totals, STATS_COUNTER_COLLISIONS, Elapsed),
+		[STATS_FIELD_QUERY_HITS_PER_SEC] = StatsRate(Totals, STATS_COUNTER_QUERY_HITS, Elapsed),
+		[STATS_FIELD_ALLOC_CALLS] = Arena->StatsAllocCalls,
+		[STATS_FIELD_EXEMPT_ALLOC_CALLS] = Arena->StatsExemptAllocCalls,
+		[STATS_FIELD_FRAME_ARENA_PEAK] = FramePeak,
+		[STATS_FIELD_FRAME_ARENA_SIZE] = FrameArenaSize()
+	};
+
+	uint32_t Seq = atomic_load_explicit(&Arena->StatsSeq, memory_order_relaxed);
+	atomic_store_explicit(&Arena->StatsSeq, Seq + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	for(uint32_t Field = 0; Field < STATS_FIELD__COUNT; ++Field)
+	{
+		atomic_store_explicit(Arena->StatsPublished + Field, Fields[Field], memory_order_relaxed);
+	}
+
+	atomic_store_explicit(&Arena->StatsSeq, Seq + 2, memory_order_release);
+
+	(void) memcpy(Arena->StatsTotals, Totals, sizeof(Totals));
+	histogram_reset(&Arena->StatsTicks);
+	Arena->StatsOverruns = 0;
+	Arena->StatsWindowAt = Now;
+}
+
+
+private void
+StatsTick(
+	void
+	)
+{
+	if(!StatsPath)
+	{
+		return;
+	}
+
+	uint64_t Now = time_get_monotonic();
+	uint64_t TickTime = Now - Arena->CurrentTickAt;
+
+	histogram_record(&Arena->StatsTicks, TickTime);
+	Arena->StatsOverruns += TickTime > time_ms_to_ns(GAME_CONST_TICK_RATE_MS);
+	Arena->StatsAllocCalls += Arena->TickAllocCalls;
+	Arena->StatsExemptAllocCalls += Arena->ExemptAllocCalls;
+
+	if(Arena->CurrentTick % GAME_CONST_STATS_WINDOW_TICKS == 0)
+	{
+		StatsPublish(Now);
+	}
+}
+
+
+private uint32_t
+StatsFormat(
+	char* Buffer,
+	uint32_t Size
+	)
+{
+	uint32_t Len = snprintf(Buffer, Size, "{\"arenas\":[");
+
+	for(uint32_t i = 0; i < ArenaCount; ++i)
+	{
+		GameArena* Source = Arenas + i;
+		uint64_t Fields[STATS_FIELD__COUNT];
+		uint32_t Seq;
+
+		do
+		{
+			Seq = atomic_load_explicit(&Source->StatsSeq, memory_order_acquire);
+
+			for(uint32_t Field = 0; Field < STATS_FIELD__COUNT; ++Field)
+			{
+				Fields[Field] = atomic_load_explicit(Source->StatsPublished + Field, memory_order_relaxed);
+			}
+
+			atomic_thread_fence(memory_order_acquire);
+		}
+		while((Seq & 1) || Seq != atomic_load_explicit(&Source->StatsSeq, memory_order_relaxed));
+
+		Len += snprintf(Buffer + Len, Size - Len, "%s{\"id\":%u", i ? "," : "", Source->Id);
+
+		for(uint32_t Field = 0; Field < STATS_FIELD__COUNT; ++Field)
+		{
+			Len += snprintf(Buffer + Len, Size - Len, ",\"%s\":%lu", StatsFieldNames[Field], Fields[Field]);
+		}
+
+		Len += snprintf(Buffer + Len, Size - Len, "}");
+	}
+
+	Len += snprintf(Buffer + Len, Size - Len, "]}\n");
+	assert_lt(Len, Size);
+
+	return Len;
+}
+
+
+/* Serves one snapshot per connection, away from the arena threads */
+private void
+StatsFN(
+	void* Data
+	)
+{
+	(void) Data;
+
+	uint32_t Size = 64 + ArenaCount * (32 + STATS_FIELD__COUNT * 48);
+	char* Buffer = alloc_malloc(Buffer, Size);
+	assert_not_null(Buffer);
+
+	while(1)
+	{
+		int SocketFD = accept(StatsFD, NULL, NULL);
+
+		if(SocketFD == -1)
+		{
+			continue;
 		}
 
-		Client->Vertical = Vertical * GAME_CONST_MAX_MOVEMENT_SPEED;
-		Client->Horizontal = Horizontal * GAME_CONST_MAX_MOVEMENT_SPEED;
+		uint32_t Len = StatsFormat(Buffer, Size);
+		uint32_t Sent = 0;
 
-		return BitBufferConsumed(&buffer);
-	}
+		while(Sent < Len)
+		{
+			ssize_t Bytes = send(SocketFD, Buffer + Sent, Len - Sent, MSG_NOSIGNAL);
 
-	default:
-	{
-		ClientClose();
+			if(Bytes <= 0)
+			{
+				break;
+			}
 
-		break;
-	}
+			Sent += Bytes;
+		}
 
+		close(SocketFD);
 	}
-
-	return 0;
 }
 
 
 private void
-ClientDestroy(
+StatsListen(
 	void
 	)
 {
-	RetEntity(Entities + Client->BodyIndex);
-	free(Client->EntityBits);
+	struct sockaddr_un Addr = { .sun_family = AF_UNIX };
+	hard_assert_lt(strlen(StatsPath), sizeof(Addr.sun_path));
+	(void) strcpy(Addr.sun_path, StatsPath);
+
+	StatsFD = socket(AF_UNIX, SOCK_STREAM, 0);
+	assert_neq(StatsFD, -1);
+
+	(void) unlink(StatsPath);
+
+	int Error = bind(StatsFD, (struct sockaddr*) &Addr, sizeof(Addr));
+	hard_assert_neq(Error, -1);
+
+	Error = listen(StatsFD, 16);
+	assert_neq(Error, -1);
+
+	thread_init(&StatsThread, (thread_data_t){ .fn = StatsFN });
 }
 
 
 private void
-GameUpdate(
-	void
+ArenaInit(
+	GameArena* NewArena,
+	uint32_t Id,
+	uint32_t WorkerCount,
+	uint32_t Seed
 	)
 {
-	Client = Clients;
-	GameClient* ClientEnd = Clients + ClientsUsed;
+	Arena = NewArena;
 
-	for(; Client != ClientEnd; ++Client)
+	/* Spawns here draw from this thread, the arena thread picks up where
+	 * they (or the checkpoint) left off */
+	rand_set_seed(Seed);
+
+	Arena->Id = Id;
+	Arena->FreeClient = -1;
+
+	Arena->Quadtree.half_extent =
+	(half_extent_t)
 	{
-		if(!Client->Valid)
-		{
-			continue;
-		}
+		.x = 0,
+		.y = 0,
+		.w = GAME_CONST_HALF_ARENA_SIZE + GAME_CONST_HALF_ARENA_CLEAR_ZONE,
+		.h = GAME_CONST_HALF_ARENA_SIZE + GAME_CONST_HALF_ARENA_CLEAR_ZONE
+	};
+	Arena->Quadtree.rect_extent = half_to_rect_extent(Arena->Quadtree.half_extent);
+	Arena->Quadtree.min_size = GAME_CONST_MIN_QUADTREE_NODE_SIZE;
+	quadtree_init(&Arena->Quadtree);
 
-		QUADTREE_ENTITY* QTEntity = Quadtree.Entities + Client->BodyIndex;
-		GameEntity* Entity = Entities + Client->BodyIndex;
+	Arena->FreeEntity = -1;
+	Arena->EntityCapacity = GAME_CONST_INITIAL_ENTITIES;
 
-		Client->MovementVX = LerpF(Client->MovementVX, Client->Horizontal, 0.095f);
-		Client->MovementVY = LerpF(Client->MovementVY, Client->Vertical, 0.095f);
+	Arena->Entities = alloc_calloc(Arena->Entities, Arena->EntityCapacity);
+	assert_not_null(Arena->Entities);
 
-		if((Entity->ResetPX && Client->MovementVX > 0) || (Entity->ResetNX && Client->MovementVX < 0))
-		{
-			Client->MovementVX = 0;
-		}
+	Arena->EntityEncodings = alloc_calloc(Arena->EntityEncodings, Arena->EntityCapacity);
+	assert_not_null(Arena->EntityEncodings);
 
-		if((Entity->ResetPY && Client->MovementVY > 0) || (Entity->ResetNY && Client->MovementVY < 0))
-		{
-			Client->MovementVY = 0;
-		}
+	EntityStoreResize(&Arena->Store, 0, Arena->EntityCapacity);
+	bitset_init(&Arena->Alive, Arena->EntityCapacity);
+	history_init(&Arena->History, GAME_CONST_ENTITY_HISTORY_TICKS, Arena->EntityCapacity);
+
+	Arena->WorkerCount = WorkerCount;
+
+	Arena->FrameArenas = alloc_malloc(Arena->FrameArenas, WorkerCount + 1);
+	assert_not_null(Arena->FrameArenas);
 
-		QTEntity->x += Client->MovementVX;
-		QTEntity->y += Client->MovementVY;
+	for(uint32_t i = 0; i <= WorkerCount; ++i)
+	{
+		arena_init(Arena->FrameArenas + i, FrameArenaSize());
 	}
 
-	QuadtreeUpdate(&Quadtree);
-	QuadtreeCollide(&Quadtree);
+	if(CheckpointPrefix)
+	{
+		(void) snprintf(Arena->CheckpointPath, sizeof(Arena->CheckpointPath), "%s.%u", CheckpointPrefix, Id);
 
-	Client = Clients;
-	Quadtree.Query = QuadtreeViewQueryFN;
+		sync_sem_init(&Arena->CheckpointStart, 0);
+		thread_init(&Arena->CheckpointThread, (thread_data_t){ .fn = CheckpointWriterFN, .data = Arena });
+	}
 
-	for(; Client != ClientEnd; ++Client)
+	if(!CheckpointPrefix || !CheckpointLoad())
 	{
-		if(!Client->Valid)
+		for(int i = 0; i < 600; ++i)
 		{
-			continue;
+			SpawnShape(SHAPE_SQUARE);
 		}
 
-		QUADTREE_ENTITY* QTEntity = Quadtree.Entities + Client->BodyIndex;
-
-		Client->CameraX = QTEntity->x;
-		Client->CameraY = QTEntity->y;
+		for(int i = 0; i < 300; ++i)
+		{
+			SpawnShape(SHAPE_TRIANGLE);
+		}
 
-		bit_buffer_t buffer = {0};
-		buffer.len = GAME_CONST_SERVER_PACKET_SIZE;
-		buffer.buffer = calloc(buffer.len, sizeof(uint8_t));
-		assert_not_null(buffer.buffer);
-		buffer.at = buffer.buffer;
+		for(int i = 0; i < 100; ++i)
+		{
+			SpawnShape(SHAPE_PENTAGON);
+		}
+	}
 
-		bit_buffer_set_bits(&buffer, SERVER_OPCODE_UPDATE, SERVER_OPCODE__BITS);
+	Arena->Seed = rand_get_seed();
 
-		bit_buffer_ctx_t PacketLength = bit_buffer_save(&buffer);
-		bit_buffer_skip_bits(&buffer, GAME_CONST_SERVER_PACKET_SIZE__BITS);
+	Arena->StatsSets = alloc_calloc(Arena->StatsSets, WorkerCount + 1);
+	assert_not_null(Arena->StatsSets);
 
-		bit_buffer_set_bits(&buffer, (CurrentTickAt - LastTickAt) / 10000, FIELD_SIZE_TICK_DURATION);
+	histogram_reset(&Arena->StatsTicks);
 
-		bit_buffer_set_fixed_point(&buffer, Client->FoV, FIXED_POINT(FOV));
-		bit_buffer_set_signed_fixed_point(&buffer, Client->CameraX, FIXED_POINT(POS));
-		bit_buffer_set_signed_fixed_point(&buffer, Client->CameraY, FIXED_POINT(POS));
+	if(Profiling)
+	{
+		/* One set of phases per thread, the arena thread's first */
+		Arena->ProfileSets = alloc_calloc(Arena->ProfileSets, (WorkerCount + 1) * PROFILE_PHASE__COUNT);
+		assert_not_null(Arena->ProfileSets);
 
-		bit_buffer_ctx_t EntitiesCount = bit_buffer_save(&buffer);
-		bit_buffer_skip_bits(&buffer, GAME_CONST_MAX_ENTITIES__BITS);
+		for(uint32_t i = 0; i < (WorkerCount + 1) * PROFILE_PHASE__COUNT; ++i)
+		{
+			histogram_reset(Arena->ProfileSets + i);
+		}
+	}
 
-		EntityBits = calloc(MACRO_TO_BYTES(GAME_CONST_MAX_ENTITIES), sizeof(uint8_t));
-		assert_not_null(EntityBits);
+	sync_mtx_init(&Arena->PendingLock);
+	sync_sem_init(&Arena->WorkStart, 0);
+	sync_sem_init(&Arena->WorkDone, 0);
 
-		EntitiesInViewCount = 0;
+	threads_init(&Arena->Workers);
 
-		QuadtreeQuery(&Quadtree, Client->CameraX, Client->CameraY, Client->CameraW, Client->CameraH);
+	if(WorkerCount)
+	{
+		Arena->WorkerData = alloc_malloc(Arena->WorkerData, WorkerCount);
+		assert_not_null(Arena->WorkerData);
+	}
 
-		uint16_t* NewEntitiesInView = malloc(sizeof(*NewEntitiesInView) * EntitiesInViewCount);
-		assert_not_null(NewEntitiesInView);
+	for(uint32_t i = 0; i < WorkerCount; ++i)
+	{
+		Arena->WorkerData[i] =
+		(GameWorker)
+		{
+			.Arena = Arena,
+			.FrameArena = Arena->FrameArenas + i + 1,
+			.Index = i + 1
+		};
 
-		(void) memcpy(NewEntitiesInView, EntitiesInView, sizeof(*EntitiesInView) * EntitiesInViewCount);
+		threads_add(&Arena->Workers, (thread_data_t){ .fn = WorkerFN, .data = Arena->WorkerData + i }, 1);
+	}
+}
 
-		uint32_t NewEntitiesInViewCount = EntitiesInViewCount;
 
-		uint16_t* EntityInView = Client->EntitiesInView;
-		uint16_t* EntityInViewEnd = EntityInView + Client->EntitiesInViewCount;
+private void
+ArenaPin(
+	long Cores
+	)
+{
+	/* The arena thread and its workers get a contiguous block of cores */
+	uint32_t First = Arena->Id * (Arena->WorkerCount + 1);
 
-		while(EntityInView != EntityInViewEnd)
-		{
-			if(!(EntityBits[*EntityInView >> 3] & (1 << (*EntityInView & 7))))
-			{
-				EntitiesInView[EntitiesInViewCount++] = *EntityInView;
-			}
+	(void) thread_set_affinity(thread_self(), First % Cores);
 
-			++EntityInView;
-		}
+	for(uint32_t i = 0; i < Arena->WorkerCount; ++i)
+	{
+		(void) thread_set_affinity(Arena->Workers.threads[i], (First + i + 1) % Cores);
+	}
+}
 
-		free(Client->EntitiesInView);
-		Client->EntitiesInView = NewEntitiesInView;
-		Client->EntitiesInViewCount = NewEntitiesInViewCount;
 
-		QuickSort(EntitiesInView, EntitiesInViewCount);
+private void
+ArenaRun(
+	void
+	)
+{
+	rand_set_seed(Arena->Seed);
+	Stats = Arena->StatsSets;
 
-		EntityInView = EntitiesInView;
-		EntityInViewEnd = EntityInView + EntitiesInViewCount;
+	if(Profiling)
+	{
+		Profile = Arena->ProfileSets;
+	}
 
-		while(EntityInView != EntityInViewEnd)
-		{
-			uint8_t OldSet = !!(Client->EntityBits[*EntityInView >> 3] & (1 << (*EntityInView & 7)));
-			uint8_t NewSet = !!(        EntityBits[*EntityInView >> 3] & (1 << (*EntityInView & 7)));
+	/* Datagrams are drained with plain recvfrom() calls, on the epoll path */
+	Arena->UseUring = !Datagrams && uring_init(&Arena->Uring, GAME_CONST_MAX_PLAYERS * 4,
+		GAME_CONST_SERVER_URING_BUFS, GAME_CONST_SERVER_RECV_SIZE);
 
-			bit_buffer_set_bits(&buffer, OldSet, 1);
-			bit_buffer_set_bits(&buffer, NewSet, 1);
+	if(!Arena->UseUring)
+	{
+		Arena->EpollFD = epoll_create1(0);
+		assert_neq(Arena->EpollFD, -1);
+	}
 
-			QUADTREE_ENTITY* QTEntity = Quadtree.Entities + *EntityInView;
-			GameEntity* Entity = Entities + *EntityInView;
+	if(Datagrams)
+	{
+		/* Every arena binds the same port, the kernel keeps each peer on one */
+		Arena->DatagramFD = socket(AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+		assert_neq(Arena->DatagramFD, -1);
 
-			if(!OldSet)
-			{
-				/* Creation */
+		struct sockaddr_in6 Addr = {0};
+		Addr.sin6_family = AF_INET6;
+		Addr.sin6_addr = in6addr_any;
+		Addr.sin6_port = htons(GAME_CONST_PORT);
 
-				assert_eq(!!NewSet, 1);
+		int True = 1;
+		int Error = setsockopt(Arena->DatagramFD, SOL_SOCKET, SO_REUSEPORT, &True, sizeof(True));
+		assert_neq(Error, -1);
 
-				bit_buffer_set_bits(&buffer, Entity->type, ENTITY_TYPE__BITS);
-				bit_buffer_set_bits(&buffer, Entity->Subtype, TypeToSubtypeBits[Entity->type]);
+		Error = bind(Arena->DatagramFD, (struct sockaddr*) &Addr, sizeof(Addr));
+		assert_neq(Error, -1);
+	}
 
-				bit_buffer_set_signed_fixed_point(&buffer, (QTEntity->x - Client->CameraX) * Client->FoV, FIXED_POINT(SCREEN_POS));
-				bit_buffer_set_signed_fixed_point(&buffer, (QTEntity->y - Client->CameraY) * Client->FoV, FIXED_POINT(SCREEN_POS));
+	time_scheduler_init(&Arena->Scheduler, time_ms_to_ns(GAME_CONST_TICK_RATE_MS), CatchUp, MaxCatchUp, SpinTime);
 
+	Arena->LastTickAt = time_get_monotonic() - time_ms_to_ns(GAME_CONST_TICK_RATE_MS);
+	Arena->StatsWindowAt = Arena->LastTickAt;
 
-				switch(Entity->type)
-				{
+	while(1)
+	{
+		++Arena->CurrentTick;
+		Arena->CurrentTickAt = time_get_monotonic();
 
-				case ENTITY_TYPE_TANK:
-				{
-					bit_buffer_set_fixed_point(&buffer, QTEntity->r, FIXED_POINT(RADIUS));
+		uint64_t TickStart = ProfileStart();
 
-					break;
-				}
+		if(Arena->UseUring)
+		{
+			uint64_t Start = ProfileStart();
+			NetPollUring();
+			ProfileEnd(PROFILE_PHASE_READ, Start);
+		}
+		else
+		{
+			NetPollEpoll();
+		}
 
-				case ENTITY_TYPE_SHAPE:
-				{
-					break;
-				}
+		NetAdoptPending();
 
-				default: __builtin_unreachable();
+		alloc_t AllocCalls = alloc_get_call_count();
+		Arena->ExemptAllocCalls = 0;
 
-				}
+		GameUpdate();
 
+		if(CheckpointTicks && Arena->CurrentTick % CheckpointTicks == 0)
+		{
+			CheckpointSave();
+		}
 
-				switch(Entity->type)
-				{
+		if(Arena->UseUring)
+		{
+			uint64_t Start = ProfileStart();
+			NetFlushUring();
+			ProfileEnd(PROFILE_PHASE_SEND, Start);
+		}
 
-				case ENTITY_TYPE_TANK:
-				case ENTITY_TYPE_SHAPE:
-				{
-					int WriteHP = Entity->HP != Entity->MaxHP;
-					bit_buffer_set_bits(&buffer, WriteHP, 1);
+		Arena->TickAllocCalls = alloc_get_call_count() - AllocCalls - Arena->ExemptAllocCalls;
 
-					bit_buffer_set_bits(&buffer, Entity->TookDamage, 1);
+		for(uint32_t i = 0; i < Arena->WorkerCount; ++i)
+		{
+			Arena->TickAllocCalls += Arena->WorkerData[i].AllocCalls;
+		}
 
-					if(WriteHP)
-					{
-						bit_buffer_set_bits(&buffer, Entity->HP, ShapeHPBits[Entity->Subtype]);
-					}
+		assert_eq(Arena->TickAllocCalls, 0);
 
-					break;
-				}
+		ProfileTick(TickStart);
+		StatsTick();
 
-				default: __builtin_unreachable();
+		if(RecordFile)
+		{
+			(void) fflush(RecordFile);
+		}
 
-				}
-			}
-			else if(NewSet)
-			{
-				/* Update */
+		Arena->LastTickAt = Arena->CurrentTickAt;
 
-				switch(Entity->type)
-				{
+		uint64_t Jitter = time_scheduler_wait(&Arena->Scheduler);
 
-				case ENTITY_TYPE_TANK:
-				case ENTITY_TYPE_SHAPE:
-				{
-					bit_buffer_set_signed_fixed_point(&buffer, (QTEntity->x - Client->CameraX) * Client->FoV, FIXED_POINT(SCREEN_POS));
-					bit_buffer_set_signed_fixed_point(&buffer, (QTEntity->y - Client->CameraY) * Client->FoV, FIXED_POINT(SCREEN_POS));
+		if(Profiling)
+		{
+			histogram_record(Profile + PROFILE_PHASE_JITTER, Jitter);
+		}
+	}
+}
 
-					bit_buffer_set_bits(&buffer, Entity->UpdateHP, 1);
-					bit_buffer_set_bits(&buffer, Entity->TookDamage, 1);
 
-					break;
-				}
+private void
+ArenaFN(
+	void* Data
+	)
+{
+	Arena = Data;
 
-				default: __builtin_unreachable();
+	ArenaPin(sysconf(_SC_NPROCESSORS_ONLN));
+	ArenaRun();
+}
 
-				}
 
+/* Hands every new connection to the arena with the fewest clients */
+private void
+AcceptorRun(
+	void
+	)
+{
+	while(1)
+	{
+		int SocketFD = accept(ServerFD, NULL, NULL);
 
-				switch(Entity->type)
-				{
+		if(SocketFD == -1)
+		{
+			assert_neq(errno, ENOMEM);
+			assert_neq(errno, ENFILE);
+			assert_neq(errno, EMFILE);
+			assert_neq(errno, EINVAL);
 
-				case ENTITY_TYPE_TANK:
-				case ENTITY_TYPE_SHAPE:
-				{
-					if(Entity->UpdateHP)
-					{
-						bit_buffer_set_bits(&buffer, Entity->HP, ShapeHPBits[Entity->Subtype]);
-					}
+			continue;
+		}
 
-					break;
-				}
+		GameArena* Target = NULL;
+		uint32_t TargetLoad = GAME_CONST_MAX_PLAYERS;
 
-				default: __builtin_unreachable();
+		for(GameArena* Candidate = Arenas; Candidate != Arenas + ArenaCount; ++Candidate)
+		{
+			sync_mtx_lock(&Candidate->PendingLock);
+			uint32_t Load = atomic_load_explicit(&Candidate->Load, memory_order_relaxed) + Candidate->PendingCount;
+			sync_mtx_unlock(&Candidate->PendingLock);
 
-				}
-			}
-			else
+			if(Load < TargetLoad)
 			{
-				/* Removal */
+				Target = Candidate;
+				TargetLoad = Load;
 			}
-
-			++EntityInView;
 		}
 
-		free(Client->EntityBits);
-		Client->EntityBits = EntityBits;
-
-		buffer.len = BitBufferConsumed(&buffer);
-
-		bit_buffer_restore(&buffer, &EntitiesCount);
-		bit_buffer_set_bits(&buffer, EntitiesInViewCount, GAME_CONST_MAX_ENTITIES__BITS);
+		if(!Target)
+		{
+			close(SocketFD);
 
-		bit_buffer_restore(&buffer, &PacketLength);
-		bit_buffer_set_bits(&buffer, buffer.len, GAME_CONST_SERVER_PACKET_SIZE__BITS);
+			continue;
+		}
 
-		ClientSend(&buffer);
-		free(buffer.buffer);
+		sync_mtx_lock(&Target->PendingLock);
+		Target->Pending[Target->PendingCount++] = SocketFD;
+		sync_mtx_unlock(&Target->PendingLock);
 	}
 }
 
@@ -793,183 +4253,196 @@ main(
 {
 	int Error;
 
-	Entities = calloc(GAME_CONST_MAX_ENTITIES, sizeof(*Entities));
-	assert_not_null(Entities);
-
-	Quadtree.x = 0;
-	Quadtree.y = 0;
-	Quadtree.w = GAME_CONST_HALF_ARENA_SIZE + GAME_CONST_HALF_ARENA_CLEAR_ZONE;
-	Quadtree.h = GAME_CONST_HALF_ARENA_SIZE + GAME_CONST_HALF_ARENA_CLEAR_ZONE;
-	Quadtree.MinSize = GAME_CONST_MIN_QUADTREE_NODE_SIZE;
-	Quadtree.Update = QuadtreeUpdateFN;
-	Quadtree.IsColliding = QuadtreeIsCollidingFN;
-	Quadtree.Collide = QuadtreeCollideFN;
-	Quadtree.EntitiesSize = GAME_CONST_MAX_ENTITIES;
-	QuadtreeInit(&Quadtree);
+	global_options = options_init(argc, (void*) argv);
 
-	Entities = calloc(Quadtree.EntitiesSize, sizeof(*Entities));
-	assert_not_null(Entities);
-
-	for(int i = 0; i < 600; ++i)
+	str_t ProfilePath;
+	if(options_get_str(global_options, "profile", &ProfilePath) && ProfilePath)
 	{
-		SpawnShape(SHAPE_SQUARE);
+		ProfileFile = fopen(ProfilePath->str, "w");
+		assert_not_null(ProfileFile);
+
+		Profiling = 1;
 	}
 
-	for(int i = 0; i < 300; ++i)
+	int64_t Count = 1;
+	(void) options_get_i64(global_options, "arenas", 1, GAME_CONST_MAX_ARENAS, &Count);
+	ArenaCount = Count;
+
+	str_t Transport;
+	if(options_get_str(global_options, "transport", &Transport) && Transport)
 	{
-		SpawnShape(SHAPE_TRIANGLE);
+		if(!strcmp(Transport->str, "udp"))
+		{
+			Datagrams = 1;
+		}
+		else
+		{
+			hard_assert_eq(strcmp(Transport->str, "tcp"), 0);
+		}
 	}
 
-	for(int i = 0; i < 100; ++i)
+	str_t CatchUpPolicy;
+	if(options_get_str(global_options, "catch-up", &CatchUpPolicy) && CatchUpPolicy)
 	{
-		SpawnShape(SHAPE_PENTAGON);
+		if(!strcmp(CatchUpPolicy->str, "skip"))
+		{
+			CatchUp = TIME_CATCH_UP_SKIP;
+		}
+		else
+		{
+			hard_assert_eq(strcmp(CatchUpPolicy->str, "bounded"), 0);
+		}
 	}
 
-	EntitiesInView = malloc(sizeof(*EntitiesInView) * GAME_CONST_MAX_ENTITIES);
-	assert_not_null(EntitiesInView);
-
-	int EpollFD = epoll_create1(0);
-	assert_neq(EpollFD, -1);
-
-	struct epoll_event Events[GAME_CONST_MAX_PLAYERS];
+	int64_t CatchUpTicks = GAME_CONST_TICK_MAX_CATCH_UP;
+	(void) options_get_i64(global_options, "max-catch-up", 0, UINT32_MAX, &CatchUpTicks);
+	MaxCatchUp = CatchUpTicks;
 
-	int ServerFD = socket(AF_INET6, SOCK_STREAM | SOCK_NONBLOCK, 0);
-	assert_neq(ServerFD, -1);
+	int64_t SpinUs = 0;
+	(void) options_get_i64(global_options, "spin-us", 0, GAME_CONST_TICK_RATE_MS * 1000 - 1, &SpinUs);
+	SpinTime = time_us_to_ns(SpinUs);
 
-	struct sockaddr_in6 Addr = {0};
-	Addr.sin6_family = AF_INET6;
-	Addr.sin6_addr = in6addr_any;
-	Addr.sin6_port = htons(GAME_CONST_PORT);
+	RecordHeader Header =
+	{
+		.Magic = RECORD_MAGIC,
+		.Seed = time_get()
+	};
 
-	int ReceiveBufferSize = GAME_CONST_SERVER_RECV_SIZE;
-	Error = setsockopt(ServerFD, SOL_SOCKET, SO_RCVBUF, &ReceiveBufferSize, sizeof(ReceiveBufferSize));
-	assert_neq(Error, -1);
+	int64_t Seed;
+	if(options_get_i64(global_options, "seed", 0, UINT32_MAX, &Seed))
+	{
+		Header.Seed = Seed;
+	}
 
-	int True = 1;
-	Error = setsockopt(ServerFD, SOL_SOCKET, SO_REUSEADDR, &True, sizeof(True));
-	assert_neq(Error, -1);
+	str_t CheckpointPath;
+	if(options_get_str(global_options, "checkpoint", &CheckpointPath) && CheckpointPath)
+	{
+		CheckpointPrefix = CheckpointPath->str;
 
-	Error = setsockopt(ServerFD, SOL_SOCKET, SO_REUSEPORT, &True, sizeof(True));
-	assert_neq(Error, -1);
+		int64_t CheckpointSeconds = 60;
+		(void) options_get_i64(global_options, "checkpoint-interval", 1, 86400, &CheckpointSeconds);
+		CheckpointTicks = CheckpointSeconds * 1000 / GAME_CONST_TICK_RATE_MS;
+	}
 
-	Error = bind(ServerFD, (struct sockaddr*) &Addr, sizeof(Addr));
-	assert_neq(Error, -1);
+	str_t StatsSocket;
+	if(options_get_str(global_options, "stats", &StatsSocket) && StatsSocket)
+	{
+		StatsPath = StatsSocket->str;
+	}
 
-	Error = listen(ServerFD, 64);
-	assert_neq(Error, -1);
+	str_t RecordPath;
+	if(options_get_str(global_options, "replay", &RecordPath) && RecordPath)
+	{
+		hard_assert_null(CheckpointPrefix);
+		hard_assert_null(StatsPath);
 
-	struct timespec Wait;
-	(void) clock_gettime(CLOCK_REALTIME, &Wait);
+		hard_assert_eq(ArenaCount, 1);
 
-	LastTickAt = Wait.tv_nsec + Wait.tv_sec * 1000000000 - GAME_CONST_TICK_RATE_MS * 1000000;
+		ReplayFile = fopen(RecordPath->str, "r");
+		assert_not_null(ReplayFile);
 
-	while(1)
+		hard_assert_eq(fread(&Header, sizeof(Header), 1, ReplayFile), 1);
+		hard_assert_eq(Header.Magic, RECORD_MAGIC);
+	}
+	else if(options_get_str(global_options, "record", &RecordPath) && RecordPath)
 	{
-		++CurrentTick;
+		hard_assert_null(CheckpointPrefix);
 
-		struct timespec time = {0};
-		clock_gettime(CLOCK_REALTIME, &time);
-		CurrentTickAt = time.tv_nsec + time.tv_sec * 1000000000;
+		hard_assert_eq(ArenaCount, 1);
 
-		int count = epoll_wait(EpollFD, Events, GAME_CONST_MAX_PLAYERS, 0);
+		RecordFile = fopen(RecordPath->str, "w");
+		assert_not_null(RecordFile);
 
-		struct epoll_event* Event = Events;
-		struct epoll_event* EventEnd = Event + count;
-
-		for(; Event != EventEnd; ++Event)
-		{
-			uint32_t flags = Event->events;
-			Client = Event->data.ptr;
+		(void) fwrite(&Header, sizeof(Header), 1, RecordFile);
+	}
 
-			if(flags & (EPOLLHUP | EPOLLERR | EPOLLRDHUP))
-			{
-				ClientDestroy();
+	long Cores = sysconf(_SC_NPROCESSORS_ONLN);
+	long CoresPerArena = Cores / ArenaCount;
+	uint32_t WorkerCount = CoresPerArena > 1 ? CoresPerArena - 1 : 0;
 
-				close(Client->FD);
-				RetClient();
+	Arenas = alloc_calloc(Arenas, ArenaCount);
+	assert_not_null(Arenas);
 
-				continue;
-			}
+	for(uint32_t i = 0; i < ArenaCount; ++i)
+	{
+		ArenaInit(Arenas + i, i, WorkerCount, Header.Seed + i);
+	}
 
-			if(flags & EPOLLIN)
-			{
-				ssize_t bytes = read(Client->FD, Client->buffer +
-					Client->BufferUsed, MACRO_ARRAY_LEN(Client->buffer) - Client->BufferUsed);
+	if(StatsPath)
+	{
+		StatsListen();
+	}
 
-				if(bytes >= 0)
-				{
-					Client->BufferUsed += bytes;
+	if(ReplayFile)
+	{
+		Arena = Arenas;
+		Stats = Arena->StatsSets;
 
-					while(Client->BufferUsed)
-					{
-						uint32_t Read = ClientRead();
+		if(Profiling)
+		{
+			Profile = Arena->ProfileSets;
+		}
 
-						if(Read == 0)
-						{
-							break;
-						}
+		Replay();
 
-						Client->BufferUsed -= Read;
+		return 0;
+	}
 
-						(void) memmove(Client->buffer, Client->buffer + Read, Client->BufferUsed);
-					}
-				}
-			}
+	if(Datagrams)
+	{
+		/* Arenas receive on sockets of their own, there is nothing to accept */
+		for(uint32_t i = 1; i < ArenaCount; ++i)
+		{
+			thread_init(&Arenas[i].Thread, (thread_data_t){ .fn = ArenaFN, .data = Arenas + i });
 		}
 
-		while(ClientsUsed != GAME_CONST_MAX_PLAYERS || FreeClient != -1)
-		{
-			struct sockaddr_in6 Addr;
-			socklen_t AddrLen = sizeof(Addr);
-			int SocketFD = accept(ServerFD, (struct sockaddr*) &Addr, &AddrLen);
+		Arena = Arenas;
 
-			if(SocketFD == -1)
-			{
-				assert_neq(errno, ENOMEM);
-				assert_neq(errno, ENFILE);
-				assert_neq(errno, EMFILE);
-				assert_neq(errno, EINVAL);
+		ArenaPin(Cores);
+		ArenaRun();
+	}
 
-				if(errno == EAGAIN)
-				{
-					break;
-				}
+	ServerFD = socket(AF_INET6, SOCK_STREAM | (ArenaCount == 1 ? SOCK_NONBLOCK : 0), 0);
+	assert_neq(ServerFD, -1);
 
-				continue;
-			}
+	struct sockaddr_in6 Addr = {0};
+	Addr.sin6_family = AF_INET6;
+	Addr.sin6_addr = in6addr_any;
+	Addr.sin6_port = htons(GAME_CONST_PORT);
 
-			Client = GetClient();
-			Client->FD = SocketFD;
+	int ReceiveBufferSize = GAME_CONST_SERVER_RECV_SIZE;
+	Error = setsockopt(ServerFD, SOL_SOCKET, SO_RCVBUF, &ReceiveBufferSize, sizeof(ReceiveBufferSize));
+	assert_neq(Error, -1);
 
-			ClientCreate();
+	int True = 1;
+	Error = setsockopt(ServerFD, SOL_SOCKET, SO_REUSEADDR, &True, sizeof(True));
+	assert_neq(Error, -1);
 
-			(void) fcntl(SocketFD, F_SETFL, fcntl(SocketFD, F_GETFL, 0) | O_NONBLOCK);
+	Error = setsockopt(ServerFD, SOL_SOCKET, SO_REUSEPORT, &True, sizeof(True));
+	assert_neq(Error, -1);
 
-			struct epoll_event Event =
-			{
-				.events = EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLRDHUP,
-				.data =
-				{
-					.ptr = Client
-				}
-			};
-			epoll_ctl(EpollFD, EPOLL_CTL_ADD, SocketFD, &Event);
-		}
+	Error = bind(ServerFD, (struct sockaddr*) &Addr, sizeof(Addr));
+	assert_neq(Error, -1);
 
-		GameUpdate();
+	Error = listen(ServerFD, 64);
+	assert_neq(Error, -1);
 
-		LastTickAt = CurrentTickAt;
+	if(ArenaCount == 1)
+	{
+		/* A lone arena accepts on its own, there is nothing to balance */
+		Arena = Arenas;
+		Arena->Accepts = 1;
 
-		Wait.tv_nsec += GAME_CONST_TICK_RATE_MS * 1000000;
-		if(Wait.tv_nsec >= 1000000000)
-		{
-			Wait.tv_nsec -= 1000000000;
-			++Wait.tv_sec;
-		}
+		ArenaPin(Cores);
+		ArenaRun();
+	}
 
-		Error = clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &Wait, NULL);
-		assert_neq(Error, -1);
+	for(uint32_t i = 0; i < ArenaCount; ++i)
+	{
+		thread_init(&Arenas[i].Thread, (thread_data_t){ .fn = ArenaFN, .data = Arenas + i });
 	}
 
+	AcceptorRun();
+
 	return 0;
 }
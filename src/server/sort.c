@@ -3,47 +3,48 @@
 
 
 private void
-Swap(
-	uint16_t* a,
-	uint16_t* b
+SwapIndex(
+	uint32_t* a,
+	uint32_t* b
 	)
 {
-	uint16_t Temp = *a;
+	uint32_t Temp = *a;
 	*a = *b;
 	*b = Temp;
 }
 
 
 private int32_t
-Partition(
-	uint16_t* Array,
+PartitionByKey(
+	uint32_t* Array,
+	const float* Keys,
 	int32_t Low,
 	int32_t High
 	)
 {
-	uint16_t x = Array[High];
+	float x = Keys[Array[High]];
 	int32_t j = Low - 1;
 
 	for(int32_t i = Low; i <= High - 1; ++i)
 	{
-		if(Array[i] <= x)
+		if(Keys[Array[i]] >= x)
 		{
 			++j;
-			Swap(Array + j, Array + i);
+			SwapIndex(Array + j, Array + i);
 		}
 	}
 
 	++j;
-	Swap(Array + j, Array + High);
+	SwapIndex(Array + j, Array + High);
 
 	return j;
 }
 
 
-
 void
-QuickSort(
-	uint16_t* Array,
+QuickSortByKey(
+	uint32_t* Array,
+	const float* Keys,
 	int32_t len
 	)
 {
@@ -66,7 +67,7 @@ QuickSort(
 		High = *(--top);
 		Low = *(--top);
 
-		int32_t Pivot = Partition(Array, Low, High);
+		int32_t Pivot = PartitionByKey(Array, Keys, Low, High);
 
 		if(Pivot - 1 > Low)
 		{
@@ -615,6 +615,7 @@ private alloc_t alloc_page_size;
 private alloc_t alloc_page_size_mask;
 private uint32_t alloc_page_size_shift;
 private const alloc_state_t* alloc_global_state;
+private thread_local alloc_t alloc_call_count;
 
 
 
@@ -660,6 +661,15 @@ alloc_get_global_state(
 }
 
 
+alloc_t
+alloc_get_call_count(
+	void
+	)
+{
+	return alloc_call_count;
+}
+
+
 _const_func_ alloc_t
 alloc_get_page_size(
 	void
@@ -1747,6 +1757,8 @@ alloc_alloc_uh(
 	int zero
 	)
 {
+	++alloc_call_count;
+
 	if(assert_unlikely(!size))
 	{
 		return NULL;
@@ -1806,6 +1818,8 @@ alloc_free_uh(
 	alloc_t size
 	)
 {
+	++alloc_call_count;
+
 	assert_ptr(ptr, size);
 
 	if(assert_unlikely(!ptr))
@@ -1933,6 +1947,8 @@ alloc_realloc_h(
 	int zero
 	)
 {
+	++alloc_call_count;
+
 	ALLOC_REALLOC(alloc_alloc_h, alloc_free_h);
 }
 
@@ -1947,6 +1963,8 @@ alloc_realloc_uh(
 	int zero
 	)
 {
+	++alloc_call_count;
+
 	ALLOC_REALLOC(alloc_alloc_uh, alloc_free_uh);
 }
 
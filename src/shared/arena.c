@@ -0,0 +1,157 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/arena.h>
+#include <shared/debug.h>
+#include <shared/alloc_ext.h>
+
+#include <string.h>
+
+
+void
+arena_init(
+	arena_t* arena,
+	alloc_t size
+	)
+{
+	assert_not_null(arena);
+	assert_gt(size, 0);
+
+	arena->data = alloc_malloc(arena->data, size);
+	assert_not_null(arena->data);
+
+	arena->used = 0;
+	arena->size = size;
+	arena->peak = 0;
+}
+
+
+void
+arena_free(
+	arena_t* arena
+	)
+{
+	assert_not_null(arena);
+
+	alloc_free(arena->data, arena->size);
+}
+
+
+void
+arena_reset(
+	arena_t* arena
+	)
+{
+	assert_not_null(arena);
+
+	arena->used = 0;
+}
+
+
+arena_ctx_t
+arena_save(
+	arena_t* arena
+	)
+{
+	assert_not_null(arena);
+
+	return (arena_ctx_t){ .used = arena->used };
+}
+
+
+void
+arena_restore(
+	arena_t* arena,
+	const arena_ctx_t* ctx
+	)
+{
+	assert_not_null(arena);
+	assert_not_null(ctx);
+	assert_le(ctx->used, arena->used);
+
+	arena->used = ctx->used;
+}
+
+
+alloc_t
+arena_available(
+	arena_t* arena
+	)
+{
+	assert_not_null(arena);
+
+	return arena->size - arena->used;
+}
+
+
+void*
+arena_alloc_safe(
+	arena_t* arena,
+	alloc_t size,
+	alloc_t alignment,
+	bool* status
+	)
+{
+	assert_not_null(arena);
+	assert_not_null(status);
+	assert_gt(alignment, 0);
+	assert_true(MACRO_IS_POWER_OF_2(alignment));
+
+	alloc_t start = MACRO_ALIGN_UP((alloc_t) arena->data + arena->used, alignment - 1) - (alloc_t) arena->data;
+
+	if(start > arena->size || size > arena->size - start)
+	{
+		*status = false;
+		return NULL;
+	}
+
+	arena->used = start + size;
+	arena->peak = MACRO_MAX(arena->peak, arena->used);
+
+	*status = true;
+	return arena->data + start;
+}
+
+
+void*
+arena_alloc(
+	arena_t* arena,
+	alloc_t size,
+	alloc_t alignment
+	)
+{
+	bool status;
+	void* ptr = arena_alloc_safe(arena, size, alignment, &status);
+	hard_assert_true(status);
+
+	return ptr;
+}
+
+
+void*
+arena_calloc(
+	arena_t* arena,
+	alloc_t size,
+	alloc_t alignment
+	)
+{
+	void* ptr = arena_alloc(arena, size, alignment);
+
+	(void) memset(ptr, 0, size);
+
+	return ptr;
+}
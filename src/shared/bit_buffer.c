@@ -14,11 +14,13 @@
  *  limitations under the License.
  */
 
+#include <shared/simd.h>
 #include <shared/debug.h>
 #include <shared/alloc_ext.h>
 #include <shared/bit_buffer.h>
 
 #include <math.h>
+#include <string.h>
 
 
 void
@@ -36,6 +38,8 @@ bit_buffer_set(
 
 	bit_buffer->len = len;
 	bit_buffer->bit = 0;
+
+	bit_buffer->written = data;
 }
 
 
@@ -48,6 +52,8 @@ bit_buffer_reset(
 
 	bit_buffer->at = bit_buffer->data;
 	bit_buffer->bit = 0;
+
+	bit_buffer->written = bit_buffer->data;
 }
 
 
@@ -106,6 +112,8 @@ bit_buffer_skip_bits(
 	bit_buffer->bit += bits;
 	bit_buffer->at += bit_buffer->bit >> 3;
 	bit_buffer->bit &= 7;
+
+	bit_buffer->written = MACRO_MAX(bit_buffer->written, bit_buffer->at);
 }
 
 
@@ -139,6 +147,7 @@ bit_buffer_skip_bytes(
 	assert_not_null(bit_buffer);
 
 	bit_buffer->at += bytes;
+	bit_buffer->written = MACRO_MAX(bit_buffer->written, bit_buffer->at);
 }
 
 
@@ -193,18 +202,62 @@ bit_buffer_restore(
 }
 
 
-void
-bit_buffer_set_bits(
+/*
+ * Big-endian, most significant bit first. A field that fits in a word
+ * goes through one unaligned load or store, the last few bytes of the
+ * buffer go byte by byte. Writes OR into a zeroed buffer, so past the
+ * furthest byte written only the current byte is read back, a whole
+ * word would overlap the previous store and stall store forwarding.
+ * Anything that moves past a byte, be it a read, a skip or a copy,
+ * counts it as written, since the byte may well hold data already.
+ */
+
+private uint64_t
+bit_buffer_load_word(
+	const uint8_t* at
+	)
+{
+	uint64_t word;
+	(void) memcpy(&word, at, sizeof(word));
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	word = __builtin_bswap64(word);
+#endif
+
+	return word;
+}
+
+
+private void
+bit_buffer_store_word(
+	uint8_t* at,
+	uint64_t word
+	)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	word = __builtin_bswap64(word);
+#endif
+
+	(void) memcpy(at, &word, sizeof(word));
+}
+
+
+private uint64_t
+bit_buffer_remaining(
+	bit_buffer_t* bit_buffer
+	)
+{
+	return bit_buffer->len - (bit_buffer->at - bit_buffer->data);
+}
+
+
+private void
+bit_buffer_set_bits_bytewise(
 	bit_buffer_t* bit_buffer,
 	uint64_t num,
 	uint64_t bits
 	)
 {
-	assert_not_null(bit_buffer);
-	assert_le(bits, 64);
-
-	num &= UINT64_MAX >> (64 - bits);
-
 	uint8_t* at = bit_buffer->at;
 
 	while(bits)
@@ -229,19 +282,16 @@ bit_buffer_set_bits(
 	}
 
 	bit_buffer->at = at;
+	bit_buffer->written = MACRO_MAX(bit_buffer->written, at);
 }
 
 
-uint64_t
-bit_buffer_get_bits(
+private uint64_t
+bit_buffer_get_bits_bytewise(
 	bit_buffer_t* bit_buffer,
 	uint64_t bits
 	)
 {
-	assert_not_null(bit_buffer);
-	assert_le(bits, 64);
-
-	uint64_t mask = UINT64_MAX >> (64 - bits);
 	uint64_t num = 0;
 
 	uint8_t* at = bit_buffer->at;
@@ -268,8 +318,90 @@ bit_buffer_get_bits(
 	}
 
 	bit_buffer->at = at;
+	bit_buffer->written = MACRO_MAX(bit_buffer->written, at);
+
+	return num;
+}
+
+
+void
+bit_buffer_set_bits(
+	bit_buffer_t* bit_buffer,
+	uint64_t num,
+	uint64_t bits
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_le(bits, 64);
+
+	if(!bits)
+	{
+		return;
+	}
+
+	num &= UINT64_MAX >> (64 - bits);
+
+	if(bit_buffer->bit + bits > 64)
+	{
+		/* Straddles 9 bytes, split it so each half fits a word */
+		bit_buffer_set_bits(bit_buffer, num >> 32, bits - 32);
+		bit_buffer_set_bits(bit_buffer, num, 32);
 
-	num &= mask;
+		return;
+	}
+
+	if(bit_buffer_remaining(bit_buffer) < sizeof(uint64_t))
+	{
+		bit_buffer_set_bits_bytewise(bit_buffer, num, bits);
+
+		return;
+	}
+
+	uint8_t* at = bit_buffer->at;
+	uint64_t end = bit_buffer->bit + bits;
+
+	uint64_t word = at >= bit_buffer->written ? (uint64_t) *at << 56 : bit_buffer_load_word(at);
+	word |= num << (64 - end);
+	bit_buffer_store_word(at, word);
+
+	bit_buffer->at = at + (end >> 3);
+	bit_buffer->bit = end & 7;
+	bit_buffer->written = MACRO_MAX(bit_buffer->written, bit_buffer->at);
+}
+
+
+uint64_t
+bit_buffer_get_bits(
+	bit_buffer_t* bit_buffer,
+	uint64_t bits
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_le(bits, 64);
+
+	if(!bits)
+	{
+		return 0;
+	}
+
+	uint64_t mask = UINT64_MAX >> (64 - bits);
+
+	if(bit_buffer->bit + bits > 64)
+	{
+		uint64_t high = bit_buffer_get_bits(bit_buffer, bits - 32);
+
+		return ((high << 32) | bit_buffer_get_bits(bit_buffer, 32)) & mask;
+	}
+
+	if(bit_buffer_remaining(bit_buffer) < sizeof(uint64_t))
+	{
+		return bit_buffer_get_bits_bytewise(bit_buffer, bits) & mask;
+	}
+
+	uint64_t word = bit_buffer_load_word(bit_buffer->at);
+	uint64_t num = (word << bit_buffer->bit) >> (64 - bits);
+
+	bit_buffer_skip_bits(bit_buffer, bits);
 
 	return num;
 }
@@ -883,6 +1015,63 @@ bit_buffer_len_bytes(
 }
 
 
+void
+bit_buffer_copy_bits(
+	bit_buffer_t* bit_buffer,
+	bit_buffer_t* src,
+	uint64_t bits
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_not_null(src);
+
+	if(!bit_buffer->bit && !src->bit)
+	{
+		uint64_t bytes = bits >> 3;
+
+		(void) memcpy(bit_buffer->at, src->at, bytes);
+
+		bit_buffer_skip_bytes(bit_buffer, bytes);
+		bit_buffer_skip_bytes(src, bytes);
+		bits &= 7;
+	}
+
+	while(bits >= 64)
+	{
+		bit_buffer_set_bits(bit_buffer, bit_buffer_get_bits(src, 64), 64);
+		bits -= 64;
+	}
+
+	if(bits)
+	{
+		bit_buffer_set_bits(bit_buffer, bit_buffer_get_bits(src, bits), bits);
+	}
+}
+
+
+void
+bit_buffer_copy_bits_safe(
+	bit_buffer_t* bit_buffer,
+	bit_buffer_t* src,
+	uint64_t bits,
+	bool* status
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_not_null(src);
+	assert_not_null(status);
+
+	if(bit_buffer_available_bits(src) < bits)
+	{
+		*status = false;
+		return;
+	}
+
+	*status = true;
+	bit_buffer_copy_bits(bit_buffer, src, bits);
+}
+
+
 void
 bit_buffer_set_str(
 	bit_buffer_t* bit_buffer,
@@ -952,3 +1141,595 @@ bit_buffer_len_str(
 {
 	return bit_buffer_len_bits_var(len, 6) + bit_buffer_len_bytes(len);
 }
+
+
+/*
+ * Arrays of same-width fields, bit for bit the same as a loop of the
+ * single field calls. The writer keeps a whole word in a register and
+ * stores it once it fills up, instead of going through the buffer for
+ * every field. The reader doesn't depend on the previous field's value,
+ * so its word loads overlap. Conversions are done in chunks on vectors.
+ */
+
+#define BIT_BUFFER_ARRAY_CHUNK 256U
+
+
+void
+bit_buffer_set_bits_array(
+	bit_buffer_t* bit_buffer,
+	const uint32_t* values,
+	uint32_t count,
+	uint64_t bits
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_ptr(values, count);
+	assert_le(bits, 32);
+	assert_le(bits * count, bit_buffer_available_bits(bit_buffer));
+
+	if(!bits || !count)
+	{
+		return;
+	}
+
+	if(bit_buffer->at < bit_buffer->written)
+	{
+		/* Patching, the bytes ahead aren't zero */
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			bit_buffer_set_bits(bit_buffer, values[i], bits);
+		}
+
+		return;
+	}
+
+	uint32_t mask = UINT32_MAX >> (32 - bits);
+
+	uint8_t* at = bit_buffer->at;
+	uint64_t fill = bit_buffer->bit;
+	uint64_t word = (uint64_t) *at << 56;
+
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		uint64_t num = values[i] & mask;
+		fill += bits;
+
+		if(fill <= 64)
+		{
+			word |= num << (64 - fill);
+		}
+		else
+		{
+			fill -= 64;
+
+			bit_buffer_store_word(at, word | (num >> fill));
+			at += sizeof(uint64_t);
+
+			word = num << (64 - fill);
+		}
+	}
+
+	uint64_t bytes = MACRO_TO_BYTES(fill);
+
+	for(uint64_t i = 0; i < bytes; ++i)
+	{
+		at[i] = word >> (56 - (i << 3));
+	}
+
+	bit_buffer->at = at + (fill >> 3);
+	bit_buffer->bit = fill & 7;
+	bit_buffer->written = MACRO_MAX(bit_buffer->written, bit_buffer->at);
+}
+
+
+void
+bit_buffer_get_bits_array(
+	bit_buffer_t* bit_buffer,
+	uint32_t* values,
+	uint32_t count,
+	uint64_t bits
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_ptr(values, count);
+	assert_le(bits, 32);
+
+	if(!bits)
+	{
+		(void) memset(values, 0, sizeof(*values) * count);
+		return;
+	}
+
+	/* Fields whose word lies fully within the buffer */
+	uint64_t remaining = bit_buffer_remaining(bit_buffer);
+	uint64_t fast = 0;
+
+	if(remaining >= sizeof(uint64_t))
+	{
+		uint64_t last = ((remaining - sizeof(uint64_t)) << 3) + 7 - bit_buffer->bit;
+		fast = MACRO_MIN(last / bits + 1, count);
+	}
+
+	const uint8_t* at = bit_buffer->at;
+	uint64_t pos = bit_buffer->bit;
+
+	for(uint32_t i = 0; i < fast; ++i)
+	{
+		uint64_t word = bit_buffer_load_word(at + (pos >> 3));
+		values[i] = (word << (pos & 7)) >> (64 - bits);
+
+		pos += bits;
+	}
+
+	bit_buffer_skip_bits(bit_buffer, fast * bits);
+
+	for(uint32_t i = fast; i < count; ++i)
+	{
+		values[i] = bit_buffer_get_bits(bit_buffer, bits);
+	}
+}
+
+
+void
+bit_buffer_get_bits_array_safe(
+	bit_buffer_t* bit_buffer,
+	uint32_t* values,
+	uint32_t count,
+	uint64_t bits,
+	bool* status
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_le(bits, 32);
+	assert_not_null(status);
+
+	if(bit_buffer_available_bits(bit_buffer) < bit_buffer_len_bits_array(count, bits))
+	{
+		*status = false;
+		return;
+	}
+
+	*status = true;
+	bit_buffer_get_bits_array(bit_buffer, values, count, bits);
+}
+
+
+uint64_t
+bit_buffer_len_bits_array(
+	uint32_t count,
+	uint64_t bits
+	)
+{
+	assert_le(bits, 32);
+
+	return bits * count;
+}
+
+
+private void
+bit_buffer_zigzag(
+	const int32_t* values,
+	uint32_t* nums,
+	uint32_t count
+	)
+{
+	uint32_t i = 0;
+
+	for(; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+	{
+		simd_i32_t value = *(const simd_i32_t*)(values + i);
+		*(simd_u32_t*)(nums + i) = ((simd_u32_t) value << 1) ^ (simd_u32_t)(value >> 31);
+	}
+
+	for(; i < count; ++i)
+	{
+		nums[i] = ((uint32_t) values[i] << 1) ^ (uint32_t)(values[i] >> 31);
+	}
+}
+
+
+private void
+bit_buffer_unzigzag(
+	const uint32_t* nums,
+	int32_t* values,
+	uint32_t count
+	)
+{
+	uint32_t i = 0;
+
+	for(; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+	{
+		simd_u32_t num = *(const simd_u32_t*)(nums + i);
+		*(simd_u32_t*)(values + i) = (num >> 1) ^ -(num & 1);
+	}
+
+	for(; i < count; ++i)
+	{
+		values[i] = (nums[i] >> 1) ^ -(nums[i] & 1);
+	}
+}
+
+
+void
+bit_buffer_set_signed_bits_array(
+	bit_buffer_t* bit_buffer,
+	const int32_t* values,
+	uint32_t count,
+	uint64_t bits
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_ptr(values, count);
+	assert_le(bits, 31);
+
+	if(!bits)
+	{
+		return;
+	}
+
+	uint32_t nums[BIT_BUFFER_ARRAY_CHUNK];
+
+	for(uint32_t i = 0; i < count; i += BIT_BUFFER_ARRAY_CHUNK)
+	{
+		uint32_t chunk = MACRO_MIN(count - i, BIT_BUFFER_ARRAY_CHUNK);
+
+		bit_buffer_zigzag(values + i, nums, chunk);
+		bit_buffer_set_bits_array(bit_buffer, nums, chunk, bits + 1);
+	}
+}
+
+
+void
+bit_buffer_get_signed_bits_array(
+	bit_buffer_t* bit_buffer,
+	int32_t* values,
+	uint32_t count,
+	uint64_t bits
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_ptr(values, count);
+	assert_le(bits, 31);
+
+	if(!bits)
+	{
+		(void) memset(values, 0, sizeof(*values) * count);
+		return;
+	}
+
+	uint32_t nums[BIT_BUFFER_ARRAY_CHUNK];
+
+	for(uint32_t i = 0; i < count; i += BIT_BUFFER_ARRAY_CHUNK)
+	{
+		uint32_t chunk = MACRO_MIN(count - i, BIT_BUFFER_ARRAY_CHUNK);
+
+		bit_buffer_get_bits_array(bit_buffer, nums, chunk, bits + 1);
+		bit_buffer_unzigzag(nums, values + i, chunk);
+	}
+}
+
+
+void
+bit_buffer_get_signed_bits_array_safe(
+	bit_buffer_t* bit_buffer,
+	int32_t* values,
+	uint32_t count,
+	uint64_t bits,
+	bool* status
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_le(bits, 31);
+	assert_not_null(status);
+
+	if(bit_buffer_available_bits(bit_buffer) < bit_buffer_len_signed_bits_array(count, bits))
+	{
+		*status = false;
+		return;
+	}
+
+	*status = true;
+	bit_buffer_get_signed_bits_array(bit_buffer, values, count, bits);
+}
+
+
+uint64_t
+bit_buffer_len_signed_bits_array(
+	uint32_t count,
+	uint64_t bits
+	)
+{
+	assert_le(bits, 31);
+
+	return bit_buffer_len_signed_bits(bits) * count;
+}
+
+
+/*
+ * Rounds half away from zero like roundf(). The fraction left over by
+ * truncation is exact, so comparing it against a half never misrounds.
+ * With a sign, it goes above the magnitude like in two separate fields.
+ */
+
+private void
+bit_buffer_quantize(
+	const float* values,
+	uint32_t* nums,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits,
+	bool sign
+	)
+{
+	uint64_t bits = integer_bits + fraction_bits;
+	uint32_t mask = ((uint32_t) 1 << bits) - 1;
+	float scale = MACRO_U32_TO_F32((fraction_bits + 127) << 23);
+	uint32_t magnitude = sign ? 0x7FFFFFFF : UINT32_MAX;
+
+	uint32_t i = 0;
+
+	for(; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+	{
+		simd_u32_t raw = *(const simd_u32_t*)(values + i);
+		simd_f32_t value = (simd_f32_t)(raw & magnitude) * scale;
+
+		simd_i32_t num = __builtin_convertvector(value, simd_i32_t);
+		simd_f32_t rest = value - __builtin_convertvector(num, simd_f32_t);
+		num -= rest >= 0.5f;
+		num += rest <= -0.5f;
+
+		simd_u32_t out = (simd_u32_t) num & mask;
+		if(sign)
+		{
+			out |= (raw >> 31) << bits;
+		}
+
+		*(simd_u32_t*)(nums + i) = out;
+	}
+
+	for(; i < count; ++i)
+	{
+		uint32_t raw = MACRO_F32_TO_U32(values[i]);
+		float value = MACRO_U32_TO_F32(raw & magnitude) * scale;
+
+		nums[i] = (uint32_t) roundf(value) & mask;
+		if(sign)
+		{
+			nums[i] |= (raw >> 31) << bits;
+		}
+	}
+}
+
+
+private void
+bit_buffer_dequantize(
+	const uint32_t* nums,
+	float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits,
+	bool sign
+	)
+{
+	uint64_t bits = integer_bits + fraction_bits;
+	uint32_t mask = ((uint32_t) 1 << bits) - 1;
+	float scale = MACRO_U32_TO_F32((-fraction_bits + 127) << 23);
+
+	uint32_t i = 0;
+
+	for(; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+	{
+		simd_u32_t num = *(const simd_u32_t*)(nums + i);
+		simd_f32_t value = __builtin_convertvector((simd_i32_t)(num & mask), simd_f32_t) * scale;
+
+		simd_u32_t out = (simd_u32_t) value;
+		if(sign)
+		{
+			out |= (num >> bits) << 31;
+		}
+
+		*(simd_u32_t*)(values + i) = out;
+	}
+
+	for(; i < count; ++i)
+	{
+		uint32_t out = MACRO_F32_TO_U32((nums[i] & mask) * scale);
+		if(sign)
+		{
+			out |= (nums[i] >> bits) << 31;
+		}
+
+		values[i] = MACRO_U32_TO_F32(out);
+	}
+}
+
+
+void
+bit_buffer_set_fixed_point_array(
+	bit_buffer_t* bit_buffer,
+	const float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_ptr(values, count);
+	assert_le(fraction_bits, 23);
+	assert_le(integer_bits + fraction_bits, 31);
+
+	uint32_t nums[BIT_BUFFER_ARRAY_CHUNK];
+
+	for(uint32_t i = 0; i < count; i += BIT_BUFFER_ARRAY_CHUNK)
+	{
+		uint32_t chunk = MACRO_MIN(count - i, BIT_BUFFER_ARRAY_CHUNK);
+
+		bit_buffer_quantize(values + i, nums, chunk, integer_bits, fraction_bits, false);
+		bit_buffer_set_bits_array(bit_buffer, nums, chunk, integer_bits + fraction_bits);
+	}
+}
+
+
+void
+bit_buffer_get_fixed_point_array(
+	bit_buffer_t* bit_buffer,
+	float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_ptr(values, count);
+	assert_le(fraction_bits, 23);
+	assert_le(integer_bits + fraction_bits, 31);
+
+	uint32_t nums[BIT_BUFFER_ARRAY_CHUNK];
+
+	for(uint32_t i = 0; i < count; i += BIT_BUFFER_ARRAY_CHUNK)
+	{
+		uint32_t chunk = MACRO_MIN(count - i, BIT_BUFFER_ARRAY_CHUNK);
+
+		bit_buffer_get_bits_array(bit_buffer, nums, chunk, integer_bits + fraction_bits);
+		bit_buffer_dequantize(nums, values + i, chunk, integer_bits, fraction_bits, false);
+	}
+}
+
+
+void
+bit_buffer_get_fixed_point_array_safe(
+	bit_buffer_t* bit_buffer,
+	float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits,
+	bool* status
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_le(fraction_bits, 23);
+	assert_le(integer_bits + fraction_bits, 31);
+	assert_not_null(status);
+
+	if(bit_buffer_available_bits(bit_buffer) <
+		bit_buffer_len_fixed_point_array(count, integer_bits, fraction_bits))
+	{
+		*status = false;
+		return;
+	}
+
+	*status = true;
+	bit_buffer_get_fixed_point_array(bit_buffer, values, count, integer_bits, fraction_bits);
+}
+
+
+uint64_t
+bit_buffer_len_fixed_point_array(
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	)
+{
+	return bit_buffer_len_fixed_point(integer_bits, fraction_bits) * count;
+}
+
+
+void
+bit_buffer_set_signed_fixed_point_array(
+	bit_buffer_t* bit_buffer,
+	const float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_ptr(values, count);
+	assert_le(fraction_bits, 23);
+	assert_le(integer_bits + fraction_bits, 31);
+
+	if(!integer_bits && !fraction_bits)
+	{
+		return;
+	}
+
+	uint32_t nums[BIT_BUFFER_ARRAY_CHUNK];
+
+	for(uint32_t i = 0; i < count; i += BIT_BUFFER_ARRAY_CHUNK)
+	{
+		uint32_t chunk = MACRO_MIN(count - i, BIT_BUFFER_ARRAY_CHUNK);
+
+		bit_buffer_quantize(values + i, nums, chunk, integer_bits, fraction_bits, true);
+		bit_buffer_set_bits_array(bit_buffer, nums, chunk, 1 + integer_bits + fraction_bits);
+	}
+}
+
+
+void
+bit_buffer_get_signed_fixed_point_array(
+	bit_buffer_t* bit_buffer,
+	float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_ptr(values, count);
+	assert_le(fraction_bits, 23);
+	assert_le(integer_bits + fraction_bits, 31);
+
+	if(!integer_bits && !fraction_bits)
+	{
+		(void) memset(values, 0, sizeof(*values) * count);
+		return;
+	}
+
+	uint32_t nums[BIT_BUFFER_ARRAY_CHUNK];
+
+	for(uint32_t i = 0; i < count; i += BIT_BUFFER_ARRAY_CHUNK)
+	{
+		uint32_t chunk = MACRO_MIN(count - i, BIT_BUFFER_ARRAY_CHUNK);
+
+		bit_buffer_get_bits_array(bit_buffer, nums, chunk, 1 + integer_bits + fraction_bits);
+		bit_buffer_dequantize(nums, values + i, chunk, integer_bits, fraction_bits, true);
+	}
+}
+
+
+void
+bit_buffer_get_signed_fixed_point_array_safe(
+	bit_buffer_t* bit_buffer,
+	float* values,
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits,
+	bool* status
+	)
+{
+	assert_not_null(bit_buffer);
+	assert_le(fraction_bits, 23);
+	assert_le(integer_bits + fraction_bits, 31);
+	assert_not_null(status);
+
+	if(bit_buffer_available_bits(bit_buffer) <
+		bit_buffer_len_signed_fixed_point_array(count, integer_bits, fraction_bits))
+	{
+		*status = false;
+		return;
+	}
+
+	*status = true;
+	bit_buffer_get_signed_fixed_point_array(bit_buffer, values, count, integer_bits, fraction_bits);
+}
+
+
+uint64_t
+bit_buffer_len_signed_fixed_point_array(
+	uint32_t count,
+	uint64_t integer_bits,
+	uint64_t fraction_bits
+	)
+{
+	return bit_buffer_len_signed_fixed_point(integer_bits, fraction_bits) * count;
+}
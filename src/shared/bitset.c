@@ -0,0 +1,416 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/debug.h>
+#include <shared/bitset.h>
+#include <shared/alloc_ext.h>
+
+#include <string.h>
+
+#ifdef __AVX2__
+	#include <immintrin.h>
+#endif
+
+
+/* Sets are padded to whole 256-bit lanes so the AVX2 paths need no tail */
+#define BITSET_LANE_WORDS 4
+
+
+private uint32_t
+bitset_word_count(
+	uint32_t bits
+	)
+{
+	uint32_t words = (bits + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+
+	return (words + BITSET_LANE_WORDS - 1) & ~(BITSET_LANE_WORDS - 1);
+}
+
+
+void
+bitset_init(
+	bitset_t* set,
+	uint32_t bits
+	)
+{
+	assert_not_null(set);
+	assert_gt(bits, 0);
+
+	set->word_count = bitset_word_count(bits);
+	set->words = alloc_calloc(set->words, set->word_count);
+	assert_not_null(set->words);
+}
+
+
+void
+bitset_resize(
+	bitset_t* set,
+	uint32_t bits
+	)
+{
+	assert_not_null(set);
+	assert_gt(bits, 0);
+
+	uint32_t word_count = bitset_word_count(bits);
+
+	set->words = alloc_recalloc(set->words, set->word_count, word_count);
+	assert_not_null(set->words);
+
+	set->word_count = word_count;
+
+	if(bits % BITSET_WORD_BITS)
+	{
+		set->words[bits / BITSET_WORD_BITS] &= (UINT64_C(1) << (bits % BITSET_WORD_BITS)) - 1;
+	}
+
+	for(uint32_t i = bits / BITSET_WORD_BITS + !!(bits % BITSET_WORD_BITS); i < word_count; ++i)
+	{
+		set->words[i] = 0;
+	}
+}
+
+
+void
+bitset_free(
+	bitset_t* set
+	)
+{
+	assert_not_null(set);
+
+	alloc_free(set->words, set->word_count);
+}
+
+
+void
+bitset_clear(
+	bitset_t* set
+	)
+{
+	assert_not_null(set);
+
+	(void) memset(set->words, 0, sizeof(*set->words) * set->word_count);
+}
+
+
+#ifdef __AVX2__
+
+private __m256i
+bitset_popcount_lane(
+	__m256i lane
+	)
+{
+	const __m256i lookup = _mm256_setr_epi8(
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+		);
+	const __m256i low_mask = _mm256_set1_epi8(0x0F);
+
+	__m256i low = _mm256_and_si256(lane, low_mask);
+	__m256i high = _mm256_and_si256(_mm256_srli_epi16(lane, 4), low_mask);
+
+	__m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+
+	return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+#endif
+
+
+uint32_t
+bitset_count(
+	const bitset_t* set
+	)
+{
+	assert_not_null(set);
+
+#ifdef __AVX2__
+	__m256i sum = _mm256_setzero_si256();
+
+	for(uint32_t i = 0; i < set->word_count; i += BITSET_LANE_WORDS)
+	{
+		__m256i lane = _mm256_loadu_si256((const void*)(set->words + i));
+		sum = _mm256_add_epi64(sum, bitset_popcount_lane(lane));
+	}
+
+	return _mm256_extract_epi64(sum, 0) + _mm256_extract_epi64(sum, 1) +
+		_mm256_extract_epi64(sum, 2) + _mm256_extract_epi64(sum, 3);
+#else
+	uint32_t count = 0;
+
+	for(uint32_t i = 0; i < set->word_count; ++i)
+	{
+		count += __builtin_popcountll(set->words[i]);
+	}
+
+	return count;
+#endif
+}
+
+
+void
+bitset_and(
+	bitset_t* dst,
+	const bitset_t* a,
+	const bitset_t* b
+	)
+{
+	assert_not_null(dst);
+	assert_not_null(a);
+	assert_not_null(b);
+	assert_eq(dst->word_count, a->word_count);
+	assert_eq(dst->word_count, b->word_count);
+
+#ifdef __AVX2__
+	for(uint32_t i = 0; i < dst->word_count; i += BITSET_LANE_WORDS)
+	{
+		__m256i lane_a = _mm256_loadu_si256((const void*)(a->words + i));
+		__m256i lane_b = _mm256_loadu_si256((const void*)(b->words + i));
+		_mm256_storeu_si256((void*)(dst->words + i), _mm256_and_si256(lane_a, lane_b));
+	}
+#else
+	for(uint32_t i = 0; i < dst->word_count; ++i)
+	{
+		dst->words[i] = a->words[i] & b->words[i];
+	}
+#endif
+}
+
+
+void
+bitset_andnot(
+	bitset_t* dst,
+	const bitset_t* a,
+	const bitset_t* b
+	)
+{
+	assert_not_null(dst);
+	assert_not_null(a);
+	assert_not_null(b);
+	assert_eq(dst->word_count, a->word_count);
+	assert_eq(dst->word_count, b->word_count);
+
+#ifdef __AVX2__
+	for(uint32_t i = 0; i < dst->word_count; i += BITSET_LANE_WORDS)
+	{
+		__m256i lane_a = _mm256_loadu_si256((const void*)(a->words + i));
+		__m256i lane_b = _mm256_loadu_si256((const void*)(b->words + i));
+		_mm256_storeu_si256((void*)(dst->words + i), _mm256_andnot_si256(lane_b, lane_a));
+	}
+#else
+	for(uint32_t i = 0; i < dst->word_count; ++i)
+	{
+		dst->words[i] = a->words[i] & ~b->words[i];
+	}
+#endif
+}
+
+
+void
+bitset_or(
+	bitset_t* dst,
+	const bitset_t* a,
+	const bitset_t* b
+	)
+{
+	assert_not_null(dst);
+	assert_not_null(a);
+	assert_not_null(b);
+	assert_eq(dst->word_count, a->word_count);
+	assert_eq(dst->word_count, b->word_count);
+
+#ifdef __AVX2__
+	for(uint32_t i = 0; i < dst->word_count; i += BITSET_LANE_WORDS)
+	{
+		__m256i lane_a = _mm256_loadu_si256((const void*)(a->words + i));
+		__m256i lane_b = _mm256_loadu_si256((const void*)(b->words + i));
+		_mm256_storeu_si256((void*)(dst->words + i), _mm256_or_si256(lane_a, lane_b));
+	}
+#else
+	for(uint32_t i = 0; i < dst->word_count; ++i)
+	{
+		dst->words[i] = a->words[i] | b->words[i];
+	}
+#endif
+}
+
+
+/*
+ * Returns the first word at or after `word` that has any bit set in either
+ * array (`b` may be NULL), or `word_count` if there is none. Empty regions
+ * are skipped a whole lane at a time when AVX2 is available.
+ */
+private uint32_t
+bitset_skip_empty(
+	const uint64_t* a,
+	const uint64_t* b,
+	uint32_t word,
+	uint32_t word_count
+	)
+{
+#ifdef __AVX2__
+	while(word < word_count && (word % BITSET_LANE_WORDS))
+	{
+		if(a[word] | (b ? b[word] : 0))
+		{
+			return word;
+		}
+
+		++word;
+	}
+
+	while(word < word_count)
+	{
+		__m256i lane = _mm256_loadu_si256((const void*)(a + word));
+
+		if(b)
+		{
+			lane = _mm256_or_si256(lane, _mm256_loadu_si256((const void*)(b + word)));
+		}
+
+		if(!_mm256_testz_si256(lane, lane))
+		{
+			break;
+		}
+
+		word += BITSET_LANE_WORDS;
+	}
+#endif
+
+	while(word < word_count && !(a[word] | (b ? b[word] : 0)))
+	{
+		++word;
+	}
+
+	return word;
+}
+
+
+bool
+bitset_next(
+	const bitset_t* set,
+	uint32_t* bit
+	)
+{
+	assert_not_null(set);
+	assert_not_null(bit);
+
+	uint32_t word = *bit / BITSET_WORD_BITS;
+
+	if(word >= set->word_count)
+	{
+		return false;
+	}
+
+	uint64_t bits = set->words[word] & (UINT64_MAX << (*bit % BITSET_WORD_BITS));
+
+	if(!bits)
+	{
+		word = bitset_skip_empty(set->words, NULL, word + 1, set->word_count);
+
+		if(word == set->word_count)
+		{
+			return false;
+		}
+
+		bits = set->words[word];
+	}
+
+	*bit = word * BITSET_WORD_BITS + __builtin_ctzll(bits);
+
+	return true;
+}
+
+
+void
+bitset_diff_init(
+	bitset_diff_iter_t* iter,
+	const bitset_t* old_set,
+	const bitset_t* new_set
+	)
+{
+	assert_not_null(iter);
+	assert_not_null(old_set);
+	assert_not_null(new_set);
+	assert_eq(old_set->word_count, new_set->word_count);
+
+	iter->old_words = old_set->words;
+	iter->new_words = new_set->words;
+	iter->word = 0;
+	iter->word_count = old_set->word_count;
+
+	iter->entered = 0;
+	iter->stayed = 0;
+	iter->left = 0;
+}
+
+
+bool
+bitset_diff_next(
+	bitset_diff_iter_t* iter,
+	uint32_t* bit,
+	bitset_change_t* change
+	)
+{
+	assert_not_null(iter);
+	assert_not_null(bit);
+	assert_not_null(change);
+
+	uint64_t all = iter->entered | iter->stayed | iter->left;
+
+	if(!all)
+	{
+		uint32_t word = bitset_skip_empty(iter->old_words, iter->new_words, iter->word, iter->word_count);
+
+		if(word == iter->word_count)
+		{
+			iter->word = word;
+			return false;
+		}
+
+		uint64_t old_word = iter->old_words[word];
+		uint64_t new_word = iter->new_words[word];
+
+		iter->entered = new_word & ~old_word;
+		iter->stayed = new_word & old_word;
+		iter->left = old_word & ~new_word;
+		iter->word = word + 1;
+
+		all = old_word | new_word;
+	}
+
+	uint64_t lowest = all & -all;
+
+	if(iter->entered & lowest)
+	{
+		iter->entered ^= lowest;
+		*change = BITSET_CHANGE_ENTERED;
+	}
+	else if(iter->stayed & lowest)
+	{
+		iter->stayed ^= lowest;
+		*change = BITSET_CHANGE_STAYED;
+	}
+	else
+	{
+		iter->left ^= lowest;
+		*change = BITSET_CHANGE_LEFT;
+	}
+
+	*bit = (iter->word - 1) * BITSET_WORD_BITS + __builtin_ctzll(all);
+
+	return true;
+}
@@ -0,0 +1,489 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/rand.h>
+#include <shared/debug.h>
+#include <shared/channel.h>
+
+#include <string.h>
+
+
+void
+channel_init(
+	channel_t* channel
+	)
+{
+	assert_not_null(channel);
+
+	(void) memset(channel, 0, sizeof(*channel));
+}
+
+
+bool
+channel_seq_greater(
+	uint16_t a,
+	uint16_t b
+	)
+{
+	return (int16_t)(a - b) > 0;
+}
+
+
+void
+channel_send_reliable(
+	channel_t* channel,
+	const void* data,
+	uint32_t len,
+	bool* status
+	)
+{
+	assert_not_null(channel);
+	assert_ptr(data, len);
+	assert_not_null(status);
+	assert_le(len, CHANNEL_MAX_MESSAGE_SIZE);
+
+	if((uint16_t)(channel->out_next - channel->out_oldest) == CHANNEL_RELIABLE_WINDOW)
+	{
+		*status = false;
+		return;
+	}
+
+	channel_msg_t* msg = channel->out + (channel->out_next % CHANNEL_RELIABLE_WINDOW);
+	msg->used = true;
+	msg->id = channel->out_next++;
+	msg->len = len;
+	(void) memcpy(msg->data, data, len);
+
+	*status = true;
+}
+
+
+bool
+channel_recv_reliable(
+	channel_t* channel,
+	void* data,
+	uint32_t* len
+	)
+{
+	assert_not_null(channel);
+	assert_not_null(data);
+	assert_not_null(len);
+
+	channel_msg_t* msg = channel->in + (channel->in_next % CHANNEL_RELIABLE_WINDOW);
+
+	if(!msg->used || msg->id != channel->in_next)
+	{
+		return false;
+	}
+
+	(void) memcpy(data, msg->data, msg->len);
+	*len = msg->len;
+
+	msg->used = false;
+	++channel->in_next;
+
+	return true;
+}
+
+
+uint32_t
+channel_reliable_pending(
+	channel_t* channel
+	)
+{
+	assert_not_null(channel);
+
+	return (uint16_t)(channel->out_next - channel->out_oldest);
+}
+
+
+uint16_t
+channel_write_header(
+	channel_t* channel,
+	bit_buffer_t* bit_buffer,
+	uint32_t reliable_budget
+	)
+{
+	assert_not_null(channel);
+	assert_not_null(bit_buffer);
+	assert_ge(bit_buffer_available_bits(bit_buffer), CHANNEL_HEADER_BITS);
+
+	uint16_t seq = channel->local_seq++;
+
+	channel_sent_t* sent = channel->sent + (seq % CHANNEL_SENT_WINDOW);
+	*sent =
+	(channel_sent_t)
+	{
+		.seq = seq,
+		.valid = true,
+		.acked = false,
+		.msg_first = channel->out_oldest,
+		.msg_count = 0
+	};
+
+	bit_buffer_set_bits(bit_buffer, seq, CHANNEL_SEQ_BITS);
+	bit_buffer_set_bits(bit_buffer, channel->remote_seq, CHANNEL_SEQ_BITS);
+	bit_buffer_set_bits(bit_buffer, channel->received_any, 1);
+	bit_buffer_set_bits(bit_buffer, channel->remote_ack_bits, CHANNEL_ACK_BITS);
+
+	bit_buffer_ctx_t count_ctx = bit_buffer_save(bit_buffer);
+	bit_buffer_skip_bits(bit_buffer, CHANNEL_COUNT_BITS);
+
+	uint64_t budget = MACRO_MIN((uint64_t) reliable_budget << 3, bit_buffer_available_bits(bit_buffer));
+	uint32_t count = 0;
+
+	for(uint16_t id = channel->out_oldest; id != channel->out_next; ++id)
+	{
+		channel_msg_t* msg = channel->out + (id % CHANNEL_RELIABLE_WINDOW);
+
+		if(!msg->used)
+		{
+			continue;
+		}
+
+		uint64_t bits = CHANNEL_SEQ_BITS + CHANNEL_LEN_BITS + ((uint64_t) msg->len << 3);
+		if(bits > budget)
+		{
+			break;
+		}
+
+		budget -= bits;
+
+		bit_buffer_set_bits(bit_buffer, msg->id, CHANNEL_SEQ_BITS);
+		bit_buffer_set_bits(bit_buffer, msg->len, CHANNEL_LEN_BITS);
+		bit_buffer_set_bytes(bit_buffer, msg->data, msg->len);
+
+		++count;
+		sent->msg_count = (uint16_t)(id - channel->out_oldest) + 1;
+	}
+
+	bit_buffer_ctx_t end_ctx = bit_buffer_save(bit_buffer);
+
+	bit_buffer_restore(bit_buffer, &count_ctx);
+	bit_buffer_set_bits(bit_buffer, count, CHANNEL_COUNT_BITS);
+
+	bit_buffer_restore(bit_buffer, &end_ctx);
+
+	return seq;
+}
+
+
+private void
+channel_ack(
+	channel_t* channel,
+	uint16_t seq
+	)
+{
+	channel_sent_t* sent = channel->sent + (seq % CHANNEL_SENT_WINDOW);
+
+	if(!sent->valid || sent->seq != seq || sent->acked)
+	{
+		return;
+	}
+
+	sent->acked = true;
+
+	if(!channel->acked_any || channel_seq_greater(seq, channel->acked_seq))
+	{
+		channel->acked_seq = seq;
+		channel->acked_any = true;
+	}
+
+	for(uint16_t i = 0; i < sent->msg_count; ++i)
+	{
+		uint16_t id = sent->msg_first + i;
+		channel_msg_t* msg = channel->out + (id % CHANNEL_RELIABLE_WINDOW);
+
+		if(msg->used && msg->id == id)
+		{
+			msg->used = false;
+		}
+	}
+
+	while(channel->out_oldest != channel->out_next &&
+		!channel->out[channel->out_oldest % CHANNEL_RELIABLE_WINDOW].used)
+	{
+		++channel->out_oldest;
+	}
+}
+
+
+private void
+channel_track_remote(
+	channel_t* channel,
+	uint16_t seq,
+	channel_packet_info_t* info
+	)
+{
+	info->seq = seq;
+	info->fresh = false;
+	info->duplicate = false;
+
+	if(!channel->received_any)
+	{
+		channel->received_any = true;
+		channel->remote_seq = seq;
+		channel->remote_ack_bits = 0;
+
+		info->fresh = true;
+		return;
+	}
+
+	if(channel_seq_greater(seq, channel->remote_seq))
+	{
+		uint16_t shift = seq - channel->remote_seq;
+		uint64_t bits = 0;
+
+		if(shift <= CHANNEL_ACK_BITS)
+		{
+			bits = ((uint64_t) channel->remote_ack_bits << shift) | ((uint64_t) 1 << (shift - 1));
+		}
+
+		channel->remote_seq = seq;
+		channel->remote_ack_bits = bits;
+
+		info->fresh = true;
+		return;
+	}
+
+	uint16_t age = channel->remote_seq - seq;
+
+	if(age == 0)
+	{
+		info->duplicate = true;
+		return;
+	}
+
+	if(age <= CHANNEL_ACK_BITS)
+	{
+		uint32_t bit = (uint32_t) 1 << (age - 1);
+
+		if(channel->remote_ack_bits & bit)
+		{
+			info->duplicate = true;
+			return;
+		}
+
+		channel->remote_ack_bits |= bit;
+	}
+}
+
+
+void
+channel_read_header(
+	channel_t* channel,
+	bit_buffer_t* bit_buffer,
+	channel_packet_info_t* info,
+	bool* status
+	)
+{
+	assert_not_null(channel);
+	assert_not_null(bit_buffer);
+	assert_not_null(info);
+	assert_not_null(status);
+
+	if(bit_buffer_available_bits(bit_buffer) < CHANNEL_HEADER_BITS)
+	{
+		*status = false;
+		return;
+	}
+
+	uint16_t seq = bit_buffer_get_bits(bit_buffer, CHANNEL_SEQ_BITS);
+	uint16_t ack = bit_buffer_get_bits(bit_buffer, CHANNEL_SEQ_BITS);
+	bool has_ack = bit_buffer_get_bits(bit_buffer, 1);
+	uint32_t ack_bits = bit_buffer_get_bits(bit_buffer, CHANNEL_ACK_BITS);
+	uint32_t count = bit_buffer_get_bits(bit_buffer, CHANNEL_COUNT_BITS);
+
+	if(count > CHANNEL_RELIABLE_WINDOW)
+	{
+		*status = false;
+		return;
+	}
+
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		uint16_t id = bit_buffer_get_bits_safe(bit_buffer, CHANNEL_SEQ_BITS, status);
+		if(!*status)
+		{
+			return;
+		}
+
+		uint8_t len = bit_buffer_get_bits_safe(bit_buffer, CHANNEL_LEN_BITS, status);
+		if(!*status)
+		{
+			return;
+		}
+
+		uint8_t data[CHANNEL_MAX_MESSAGE_SIZE];
+		bit_buffer_get_bytes_safe(bit_buffer, data, len, status);
+		if(!*status)
+		{
+			return;
+		}
+
+		if((uint16_t)(id - channel->in_next) >= CHANNEL_RELIABLE_WINDOW)
+		{
+			continue;
+		}
+
+		channel_msg_t* msg = channel->in + (id % CHANNEL_RELIABLE_WINDOW);
+
+		if(msg->used)
+		{
+			continue;
+		}
+
+		msg->used = true;
+		msg->id = id;
+		msg->len = len;
+		(void) memcpy(msg->data, data, len);
+	}
+
+	channel_track_remote(channel, seq, info);
+
+	if(has_ack)
+	{
+		channel_ack(channel, ack);
+
+		for(uint32_t i = 1; i <= CHANNEL_ACK_BITS; ++i)
+		{
+			if(ack_bits & ((uint32_t) 1 << (i - 1)))
+			{
+				channel_ack(channel, ack - i);
+			}
+		}
+	}
+
+	*status = true;
+}
+
+
+bool
+channel_is_acked(
+	channel_t* channel,
+	uint16_t seq
+	)
+{
+	assert_not_null(channel);
+
+	channel_sent_t* sent = channel->sent + (seq % CHANNEL_SENT_WINDOW);
+
+	return sent->valid && sent->seq == seq && sent->acked;
+}
+
+
+bool
+channel_last_acked(
+	channel_t* channel,
+	uint16_t* seq
+	)
+{
+	assert_not_null(channel);
+	assert_not_null(seq);
+
+	*seq = channel->acked_seq;
+
+	return channel->acked_any;
+}
+
+
+void
+channel_link_init(
+	channel_link_t* link,
+	float loss,
+	uint64_t latency,
+	uint64_t jitter
+	)
+{
+	assert_not_null(link);
+	assert_ge(loss, 0.0f);
+	assert_le(loss, 1.0f);
+
+	link->loss = loss;
+	link->latency = latency;
+	link->jitter = jitter;
+	link->used = 0;
+}
+
+
+void
+channel_link_send(
+	channel_link_t* link,
+	uint64_t now,
+	const void* data,
+	uint32_t len
+	)
+{
+	assert_not_null(link);
+	assert_ptr(data, len);
+	assert_le(len, CHANNEL_LINK_MTU);
+
+	if(link->used == CHANNEL_LINK_CAPACITY || rand_f32() < link->loss)
+	{
+		return;
+	}
+
+	channel_datagram_t* datagram = link->datagrams + link->used++;
+
+	datagram->deliver_at = now + link->latency;
+	if(link->jitter)
+	{
+		datagram->deliver_at += rand_u32() % (link->jitter + 1);
+	}
+
+	datagram->len = len;
+	(void) memcpy(datagram->data, data, len);
+}
+
+
+bool
+channel_link_recv(
+	channel_link_t* link,
+	uint64_t now,
+	void* data,
+	uint32_t* len
+	)
+{
+	assert_not_null(link);
+	assert_not_null(data);
+	assert_not_null(len);
+
+	channel_datagram_t* next = NULL;
+
+	channel_datagram_t* datagram = link->datagrams;
+	channel_datagram_t* datagram_end = datagram + link->used;
+
+	for(; datagram != datagram_end; ++datagram)
+	{
+		if(datagram->deliver_at <= now && (!next || datagram->deliver_at < next->deliver_at))
+		{
+			next = datagram;
+		}
+	}
+
+	if(!next)
+	{
+		return false;
+	}
+
+	(void) memcpy(data, next->data, next->len);
+	*len = next->len;
+
+	*next = link->datagrams[--link->used];
+
+	return true;
+}
@@ -75,3 +75,99 @@ rect_to_half_extent(
 		.h = (extent.max_y - extent.min_y) * 0.5f
 	};
 }
+
+
+bool
+rect_extent_f64_intersects(
+	rect_extent_f64_t a,
+	rect_extent_f64_t b
+	)
+{
+	return
+		a.max_x >= b.min_x &&
+		a.max_y >= b.min_y &&
+		b.max_x >= a.min_x &&
+		b.max_y >= a.min_y;
+}
+
+
+rect_extent_f64_t
+half_to_rect_extent_f64(
+	half_extent_f64_t extent
+	)
+{
+	return
+	(rect_extent_f64_t)
+	{
+		.min_x = extent.x - extent.w,
+		.min_y = extent.y - extent.h,
+		.max_x = extent.x + extent.w,
+		.max_y = extent.y + extent.h
+	};
+}
+
+
+half_extent_f64_t
+rect_to_half_extent_f64(
+	rect_extent_f64_t extent
+	)
+{
+	return
+	(half_extent_f64_t)
+	{
+		.x = (extent.max_x + extent.min_x) * 0.5,
+		.y = (extent.max_y + extent.min_y) * 0.5,
+		.w = (extent.max_x - extent.min_x) * 0.5,
+		.h = (extent.max_y - extent.min_y) * 0.5
+	};
+}
+
+
+bool
+rect_extent_i32_intersects(
+	rect_extent_i32_t a,
+	rect_extent_i32_t b
+	)
+{
+	return
+		a.max_x >= b.min_x &&
+		a.max_y >= b.min_y &&
+		b.max_x >= a.min_x &&
+		b.max_y >= a.min_y;
+}
+
+
+rect_extent_i32_t
+half_to_rect_extent_i32(
+	half_extent_i32_t extent
+	)
+{
+	return
+	(rect_extent_i32_t)
+	{
+		.min_x = extent.x - extent.w,
+		.min_y = extent.y - extent.h,
+		.max_x = extent.x + extent.w,
+		.max_y = extent.y + extent.h
+	};
+}
+
+
+half_extent_i32_t
+rect_to_half_extent_i32(
+	rect_extent_i32_t extent
+	)
+{
+	/* Sums are widened so that extents spanning most of the int32_t range
+	 * don't overflow, and shifted so that rounding is always towards -inf,
+	 * which keeps the result identical on every machine. Odd sizes round
+	 * up so that the half extent still covers the whole rect. */
+	return
+	(half_extent_i32_t)
+	{
+		.x = ((int64_t) extent.max_x + extent.min_x) >> 1,
+		.y = ((int64_t) extent.max_y + extent.min_y) >> 1,
+		.w = ((int64_t) extent.max_x - extent.min_x + 1) >> 1,
+		.h = ((int64_t) extent.max_y - extent.min_y + 1) >> 1
+	};
+}
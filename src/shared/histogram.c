@@ -0,0 +1,176 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/debug.h>
+#include <shared/histogram.h>
+
+#include <string.h>
+
+
+private uint32_t
+histogram_bucket(
+	uint64_t value
+	)
+{
+	if(value < HISTOGRAM_SUB_BUCKETS)
+	{
+		return value;
+	}
+
+	uint32_t exponent = 63 - __builtin_clzll(value);
+	uint32_t shift = exponent - HISTOGRAM_SUB_BITS;
+	uint32_t sub = (value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1);
+
+	return ((shift + 1) << HISTOGRAM_SUB_BITS) + sub;
+}
+
+
+private uint64_t
+histogram_bucket_max(
+	uint32_t bucket
+	)
+{
+	if(bucket < HISTOGRAM_SUB_BUCKETS)
+	{
+		return bucket;
+	}
+
+	uint32_t shift = (bucket >> HISTOGRAM_SUB_BITS) - 1;
+	uint64_t sub = bucket & (HISTOGRAM_SUB_BUCKETS - 1);
+	uint64_t low = (HISTOGRAM_SUB_BUCKETS + sub) << shift;
+
+	return low + ((UINT64_C(1) << shift) - 1);
+}
+
+
+void
+histogram_reset(
+	histogram_t* histogram
+	)
+{
+	assert_not_null(histogram);
+
+	(void) memset(histogram, 0, sizeof(*histogram));
+}
+
+
+void
+histogram_record(
+	histogram_t* histogram,
+	uint64_t value
+	)
+{
+	assert_not_null(histogram);
+
+	if(!histogram->count || value < histogram->min)
+	{
+		histogram->min = value;
+	}
+
+	if(value > histogram->max)
+	{
+		histogram->max = value;
+	}
+
+	++histogram->count;
+	histogram->sum += value;
+	++histogram->buckets[histogram_bucket(value)];
+}
+
+
+void
+histogram_merge(
+	histogram_t* histogram,
+	const histogram_t* other
+	)
+{
+	assert_not_null(histogram);
+	assert_not_null(other);
+
+	if(!other->count)
+	{
+		return;
+	}
+
+	if(!histogram->count || other->min < histogram->min)
+	{
+		histogram->min = other->min;
+	}
+
+	if(other->max > histogram->max)
+	{
+		histogram->max = other->max;
+	}
+
+	histogram->count += other->count;
+	histogram->sum += other->sum;
+
+	for(uint32_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+	{
+		histogram->buckets[i] += other->buckets[i];
+	}
+}
+
+
+uint64_t
+histogram_percentile(
+	const histogram_t* histogram,
+	double percentile
+	)
+{
+	assert_not_null(histogram);
+	assert_ge(percentile, 0.0);
+	assert_le(percentile, 100.0);
+
+	if(!histogram->count)
+	{
+		return 0;
+	}
+
+	uint64_t target = percentile / 100.0 * histogram->count + 0.5;
+	target = MACRO_CLAMP(target, 1, histogram->count);
+
+	uint64_t seen = 0;
+
+	for(uint32_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+	{
+		seen += histogram->buckets[i];
+
+		if(seen >= target)
+		{
+			return MACRO_CLAMP(histogram_bucket_max(i), histogram->min, histogram->max);
+		}
+	}
+
+	return histogram->max;
+}
+
+
+uint64_t
+histogram_mean(
+	const histogram_t* histogram
+	)
+{
+	assert_not_null(histogram);
+
+	if(!histogram->count)
+	{
+		return 0;
+	}
+
+	return histogram->sum / histogram->count;
+}
@@ -0,0 +1,349 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/debug.h>
+#include <shared/history.h>
+#include <shared/alloc_ext.h>
+
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+
+
+private int32_t
+history_quantize(
+	float value
+	)
+{
+	value *= 1 << HISTORY_FRACTION_BITS;
+
+	return value + (value < 0 ? -0.5f : 0.5f);
+}
+
+
+private uint16_t
+history_quantize_size(
+	float value
+	)
+{
+	return MACRO_CLAMP(history_quantize(value), 0, UINT16_MAX);
+}
+
+
+private uint32_t
+history_slot(
+	const history_t* history,
+	uint64_t tick
+	)
+{
+	return tick & (history->length - 1);
+}
+
+
+private float
+history_dequantize(
+	int64_t value
+	)
+{
+	return (float) value / (1 << HISTORY_FRACTION_BITS);
+}
+
+
+void
+history_init(
+	history_t* history,
+	uint32_t length,
+	uint32_t capacity
+	)
+{
+	assert_not_null(history);
+	assert_gt(length, 0);
+	assert_gt(capacity, 0);
+
+	/* Slots are picked with a mask */
+	length = 1U << MACRO_GET_BITS(length);
+
+	uint64_t size = (uint64_t) length * capacity;
+
+	history->x = alloc_calloc(history->x, size);
+	assert_not_null(history->x);
+
+	history->y = alloc_calloc(history->y, size);
+	assert_not_null(history->y);
+
+	history->w = alloc_calloc(history->w, size);
+	assert_not_null(history->w);
+
+	history->h = alloc_calloc(history->h, size);
+	assert_not_null(history->h);
+
+	history->counts = alloc_calloc(history->counts, length);
+	assert_not_null(history->counts);
+
+	history->spread = alloc_calloc(history->spread, length);
+	assert_not_null(history->spread);
+
+	history->born = alloc_calloc(history->born, capacity);
+	assert_not_null(history->born);
+
+	history->settled = alloc_calloc(history->settled, capacity);
+	assert_not_null(history->settled);
+
+	history->length = length;
+	history->capacity = capacity;
+	history->recorded = 0;
+	history->tick = 0;
+}
+
+
+void
+history_free(
+	history_t* history
+	)
+{
+	assert_not_null(history);
+
+	uint64_t size = (uint64_t) history->length * history->capacity;
+
+	alloc_free(history->x, size);
+	alloc_free(history->y, size);
+	alloc_free(history->w, size);
+	alloc_free(history->h, size);
+	alloc_free(history->counts, history->length);
+	alloc_free(history->spread, history->length);
+	alloc_free(history->born, history->capacity);
+	alloc_free(history->settled, history->capacity);
+}
+
+
+#define history_resize_field(field)										\
+do																		\
+{																		\
+	typeof(history->field) resized =									\
+		alloc_calloc(resized, (uint64_t) history->length * capacity);	\
+	assert_not_null(resized);											\
+																		\
+	for(uint32_t slot = 0; slot < history->length; ++slot)				\
+	{																	\
+		(void) memcpy(resized + (uint64_t) slot * capacity,				\
+			history->field + (uint64_t) slot * history->capacity,		\
+			sizeof(*resized) * MACRO_MIN(capacity, history->capacity));	\
+	}																	\
+																		\
+	alloc_free(history->field, (uint64_t) history->length * history->capacity);	\
+	history->field = resized;											\
+}																		\
+while(0)
+
+
+void
+history_resize(
+	history_t* history,
+	uint32_t capacity
+	)
+{
+	assert_not_null(history);
+	assert_gt(capacity, 0);
+
+	history_resize_field(x);
+	history_resize_field(y);
+	history_resize_field(w);
+	history_resize_field(h);
+
+	history->born = alloc_recalloc(history->born, history->capacity, capacity);
+	assert_not_null(history->born);
+
+	history->settled = alloc_recalloc(history->settled, history->capacity, capacity);
+	assert_not_null(history->settled);
+
+	for(uint32_t slot = 0; slot < history->length; ++slot)
+	{
+		history->counts[slot] = MACRO_MIN(history->counts[slot], capacity);
+	}
+
+	history->capacity = capacity;
+}
+
+
+#undef history_resize_field
+
+
+void
+history_spawn(
+	history_t* history,
+	uint32_t idx
+	)
+{
+	assert_not_null(history);
+	assert_lt(idx, history->capacity);
+
+	/* Whatever was recorded at this index before belongs to someone else */
+	history->born[idx] = history->recorded ? history->tick + 1 : 0;
+	history->settled[idx] = 0;
+}
+
+
+void
+history_record(
+	history_t* history,
+	uint64_t tick,
+	const float* x,
+	const float* y,
+	const float* w,
+	const float* h,
+	uint32_t count
+	)
+{
+	assert_not_null(history);
+	assert_le(count, history->capacity);
+
+	if(history->recorded)
+	{
+		assert_eq(tick, history->tick + 1);
+	}
+
+	uint32_t slot = history_slot(history, tick);
+	uint32_t prev_slot = history_slot(history, tick - 1);
+
+	int32_t* slot_x = history->x + (uint64_t) slot * history->capacity;
+	int32_t* slot_y = history->y + (uint64_t) slot * history->capacity;
+	uint16_t* slot_w = history->w + (uint64_t) slot * history->capacity;
+	uint16_t* slot_h = history->h + (uint64_t) slot * history->capacity;
+
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		slot_x[i] = history_quantize(x[i]);
+		slot_y[i] = history_quantize(y[i]);
+		slot_w[i] = history_quantize_size(w[i]);
+		slot_h[i] = history_quantize_size(h[i]);
+	}
+
+	const int32_t* prev_x = history->x + (uint64_t) prev_slot * history->capacity;
+	const int32_t* prev_y = history->y + (uint64_t) prev_slot * history->capacity;
+	const uint16_t* prev_w = history->w + (uint64_t) prev_slot * history->capacity;
+	const uint16_t* prev_h = history->h + (uint64_t) prev_slot * history->capacity;
+
+	uint32_t prev_count = history->recorded ? MACRO_MIN(history->counts[prev_slot], count) : 0;
+	uint32_t spread = 0;
+
+	/* Moving plus growing, for entities that were there the tick before.
+	   A mask rather than a branch on born keeps this loop vectorized. */
+	for(uint32_t i = 0; i < prev_count; ++i)
+	{
+		uint32_t moved = MACRO_MAX(abs(slot_x[i] - prev_x[i]), abs(slot_y[i] - prev_y[i]));
+		int32_t grown = MACRO_MAX(slot_w[i] - prev_w[i], slot_h[i] - prev_h[i]);
+		uint32_t step = (moved + MACRO_MAX(grown, 0)) & history->settled[i];
+
+		spread = MACRO_MAX(spread, step);
+		history->settled[i] = UINT32_MAX;
+	}
+
+	for(uint32_t i = prev_count; i < count; ++i)
+	{
+		history->settled[i] = UINT32_MAX;
+	}
+
+	history->counts[slot] = count;
+	history->spread[slot] = spread;
+	history->tick = tick;
+	history->recorded = MACRO_MIN(history->recorded + 1, history->length);
+}
+
+
+bool
+history_has(
+	const history_t* history,
+	uint64_t tick
+	)
+{
+	assert_not_null(history);
+
+	return history->recorded && tick <= history->tick && history->tick - tick < history->recorded;
+}
+
+
+float
+history_spread(
+	const history_t* history,
+	uint64_t tick
+	)
+{
+	assert_not_null(history);
+	assert_true(history_has(history, tick));
+
+	/* One step of slack covers rounding of the current, unquantized bounds */
+	uint64_t spread = 1;
+
+	for(uint64_t t = tick + 1; t <= history->tick; ++t)
+	{
+		spread += history->spread[history_slot(history, t)];
+	}
+
+	return history_dequantize(spread);
+}
+
+
+bool
+history_get(
+	const history_t* history,
+	uint64_t tick,
+	uint32_t idx,
+	half_extent_t* extent
+	)
+{
+	assert_not_null(history);
+	assert_not_null(extent);
+
+	uint32_t slot = history_slot(history, tick);
+
+	if(!history_has(history, tick) || idx >= history->counts[slot] || history->born[idx] > tick)
+	{
+		return false;
+	}
+
+	uint64_t offset = (uint64_t) slot * history->capacity + idx;
+
+	extent->x = history_dequantize(history->x[offset]);
+	extent->y = history_dequantize(history->y[offset]);
+	extent->w = history_dequantize(history->w[offset]);
+	extent->h = history_dequantize(history->h[offset]);
+
+	return true;
+}
+
+
+bool
+history_intersects(
+	const history_t* history,
+	uint64_t tick,
+	uint32_t idx,
+	rect_extent_t extent
+	)
+{
+	half_extent_t then;
+
+	if(!history_get(history, tick, idx, &then))
+	{
+		return false;
+	}
+
+	return
+		then.x - then.w <= extent.max_x &&
+		then.x + then.w >= extent.min_x &&
+		then.y - then.h <= extent.max_y &&
+		then.y + then.h >= extent.min_y;
+}
@@ -24,6 +24,67 @@
 #include <string.h>
 
 
+#if quadtree_coord == QUADTREE_COORD_F32
+	#define quadtree_coord_half(coord) ((coord) * 0.5f)
+
+	#define quadtree_rect_extent_intersects rect_extent_intersects
+	#define quadtree_half_to_rect_extent half_to_rect_extent
+
+	#define quadtree_ray_inv(d) (1.0f / (d))
+	#define quadtree_ray_param(num, inv) ((num) * (inv))
+	#define QUADTREE_RAY_ONE 1.0f
+
+	#define QUADTREE_DIST_MAX INFINITY
+#elif quadtree_coord == QUADTREE_COORD_F64
+	#define quadtree_coord_half(coord) ((coord) * 0.5)
+
+	#define quadtree_rect_extent_intersects rect_extent_f64_intersects
+	#define quadtree_half_to_rect_extent half_to_rect_extent_f64
+
+	#define quadtree_ray_inv(d) (1.0 / (d))
+	#define quadtree_ray_param(num, inv) ((num) * (inv))
+	#define QUADTREE_RAY_ONE 1.0
+
+	#define QUADTREE_DIST_MAX ((double) INFINITY)
+#else
+	#define quadtree_coord_half(coord) ((coord) >> 1)
+
+	#define quadtree_rect_extent_intersects rect_extent_i32_intersects
+	#define quadtree_half_to_rect_extent half_to_rect_extent_i32
+
+	#define quadtree_ray_inv(d) ((quadtree_dist_t)(d))
+	#define quadtree_ray_param(num, inv) quadtree_fixed_ray_param((num), (inv))
+	#define QUADTREE_RAY_ONE ((quadtree_dist_t) 1 << quadtree_fixed_fraction_bits)
+
+	#define QUADTREE_DIST_MAX INT64_MAX
+
+
+/*
+ * Fixed point has no infinities, so a zero direction saturates instead.
+ * A zero numerator (ray origin exactly on the slab boundary) yields 0,
+ * which keeps touching extents counted as hits, same as the float path.
+ */
+private quadtree_dist_t
+quadtree_fixed_ray_param(
+	quadtree_dist_t num,
+	quadtree_dist_t d
+	)
+{
+	if(!num)
+	{
+		return 0;
+	}
+
+	if(!d)
+	{
+		return num > 0 ? INT64_MAX : INT64_MIN;
+	}
+
+	return num * ((quadtree_dist_t) 1 << quadtree_fixed_fraction_bits) / d;
+}
+#endif
+
+
 void
 quadtree_init(
 	quadtree_t* qt
@@ -54,9 +115,29 @@ quadtree_init(
 
 	if(!qt->min_size)
 	{
-		qt->min_size = 1.0f;
+		qt->min_size = quadtree_coord_from_f32(1.0f);
 	}
 
+#if quadtree_coord == QUADTREE_COORD_FIXED
+	/* Children halve by shifting, so an odd raw extent would lose a unit
+	 * at every level and stop covering its parent. Round up to a power of
+	 * two instead, which halves exactly all the way down. */
+	assert_gt(qt->half_extent.w, 0);
+	assert_gt(qt->half_extent.h, 0);
+	assert_le(qt->half_extent.w, INT32_C(1) << 29);
+	assert_le(qt->half_extent.h, INT32_C(1) << 29);
+
+	qt->half_extent.w = MACRO_NEXT_OR_EQUAL_POWER_OF_2(qt->half_extent.w);
+	qt->half_extent.h = MACRO_NEXT_OR_EQUAL_POWER_OF_2(qt->half_extent.h);
+	qt->rect_extent = quadtree_half_to_rect_extent(qt->half_extent);
+
+	/* See quadtree_coord_t, the rounding above can only widen the tree */
+	assert_ge(qt->rect_extent.min_x, -(INT32_C(1) << 30) + 1);
+	assert_ge(qt->rect_extent.min_y, -(INT32_C(1) << 30) + 1);
+	assert_le(qt->rect_extent.max_x, (INT32_C(1) << 30) - 1);
+	assert_le(qt->rect_extent.max_y, (INT32_C(1) << 30) - 1);
+#endif
+
 	qt->nodes = alloc_malloc(qt->nodes, 1);
 	assert_not_null(qt->nodes);
 
@@ -94,8 +175,15 @@ quadtree_free(
 	alloc_free(qt->node_removals, qt->node_removals_size);
 	alloc_free(qt->removals, qt->removals_size);
 #if QUADTREE_DEDUPE_COLLISIONS == 1
+	alloc_free(qt->ht, qt->ht_size);
 	alloc_free(qt->ht_entries, qt->ht_entries_size);
 #endif
+	alloc_free(qt->entity_map, qt->entity_map_size);
+	alloc_free(qt->spare_entities, qt->spare_entities_size);
+	alloc_free(qt->spare_node_entities.flags, qt->spare_node_entities_size);
+	alloc_free(qt->spare_node_entities.entities, qt->spare_node_entities_size);
+	alloc_free(qt->spare_node_entities.next, qt->spare_node_entities_size);
+	alloc_free(qt->spare_nodes, qt->spare_nodes_size);
 	alloc_free(qt->entities, qt->entities_size);
 	alloc_free(qt->node_entities.flags, qt->node_entities_size);
 	alloc_free(qt->node_entities.entities, qt->node_entities_size);
@@ -117,8 +205,10 @@ quadtree_fill_node_default(__VA_ARGS__)
 #define quadtree_descend(_extent, ...)				\
 do													\
 {													\
-	float half_w = info.extent.w * 0.5f;			\
-	float half_h = info.extent.h * 0.5f;			\
+	quadtree_coord_t half_w =						\
+		quadtree_coord_half(info.extent.w);			\
+	quadtree_coord_t half_h =						\
+		quadtree_coord_half(info.extent.h);			\
 													\
 	if(_extent.min_x <= info.extent.x)				\
 	{												\
@@ -126,7 +216,7 @@ do													\
 		{											\
 			*(node_info++) = quadtree_fill_node(	\
 				node->heads[0],						\
-				((half_extent_t)					\
+				((quadtree_half_extent_t)			\
 				{									\
 					.x = info.extent.x - half_w,	\
 					.y = info.extent.y - half_h,	\
@@ -140,7 +230,7 @@ do													\
 		{											\
 			*(node_info++) = quadtree_fill_node(	\
 				node->heads[1],						\
-				((half_extent_t)					\
+				((quadtree_half_extent_t)			\
 				{									\
 					.x = info.extent.x - half_w,	\
 					.y = info.extent.y + half_h,	\
@@ -157,7 +247,7 @@ do													\
 		{											\
 			*(node_info++) = quadtree_fill_node(	\
 				node->heads[2],						\
-				((half_extent_t)					\
+				((quadtree_half_extent_t)			\
 				{									\
 					.x = info.extent.x + half_w,	\
 					.y = info.extent.y - half_h,	\
@@ -171,7 +261,7 @@ do													\
 		{											\
 			*(node_info++) = quadtree_fill_node(	\
 				node->heads[3],						\
-				((half_extent_t)					\
+				((quadtree_half_extent_t)			\
 				{									\
 					.x = info.extent.x + half_w,	\
 					.y = info.extent.y + half_h,	\
@@ -188,12 +278,14 @@ while(0)
 #define quadtree_descend_all(...)			\
 do											\
 {											\
-	float half_w = info.extent.w * 0.5f;	\
-	float half_h = info.extent.h * 0.5f;	\
+	quadtree_coord_t half_w =				\
+		quadtree_coord_half(info.extent.w);	\
+	quadtree_coord_t half_h =				\
+		quadtree_coord_half(info.extent.h);	\
 											\
 	*(node_info++) = quadtree_fill_node(	\
 		node->heads[0],						\
-		((half_extent_t)					\
+		((quadtree_half_extent_t)			\
 		{									\
 			.x = info.extent.x - half_w,	\
 			.y = info.extent.y - half_h,	\
@@ -205,7 +297,7 @@ do											\
 											\
 	*(node_info++) = quadtree_fill_node(	\
 		node->heads[1],						\
-		((half_extent_t)					\
+		((quadtree_half_extent_t)			\
 		{									\
 			.x = info.extent.x - half_w,	\
 			.y = info.extent.y + half_h,	\
@@ -217,7 +309,7 @@ do											\
 											\
 	*(node_info++) = quadtree_fill_node(	\
 		node->heads[2],						\
-		((half_extent_t)					\
+		((quadtree_half_extent_t)			\
 		{									\
 			.x = info.extent.x + half_w,	\
 			.y = info.extent.y - half_h,	\
@@ -229,7 +321,7 @@ do											\
 											\
 	*(node_info++) = quadtree_fill_node(	\
 		node->heads[3],						\
-		((half_extent_t)					\
+		((quadtree_half_extent_t)			\
 		{									\
 			.x = info.extent.x + half_w,	\
 			.y = info.extent.y + half_h,	\
@@ -241,33 +333,33 @@ do											\
 }											\
 while(0)
 
-#define quadtree_descend_extentless(...)	\
-do											\
-{											\
-	*(node_info++) = quadtree_fill_node(	\
-		node->heads[0],						\
-		((half_extent_t){0}) __VA_OPT__(,)	\
-		__VA_ARGS__							\
-		);									\
-											\
-	*(node_info++) = quadtree_fill_node(	\
-		node->heads[1],						\
-		((half_extent_t){0}) __VA_OPT__(,)	\
-		__VA_ARGS__							\
-		);									\
-											\
-	*(node_info++) = quadtree_fill_node(	\
-		node->heads[2],						\
-		((half_extent_t){0}) __VA_OPT__(,)	\
-		__VA_ARGS__							\
-		);									\
-											\
-	*(node_info++) = quadtree_fill_node(	\
-		node->heads[3],						\
-		((half_extent_t){0}) __VA_OPT__(,)	\
-	  __VA_ARGS__							\
-	  );									\
-}											\
+#define quadtree_descend_extentless(...)			\
+do													\
+{													\
+	*(node_info++) = quadtree_fill_node(			\
+		node->heads[0],								\
+		((quadtree_half_extent_t){0}) __VA_OPT__(,)	\
+		__VA_ARGS__									\
+		);											\
+													\
+	*(node_info++) = quadtree_fill_node(			\
+		node->heads[1],								\
+		((quadtree_half_extent_t){0}) __VA_OPT__(,)	\
+		__VA_ARGS__									\
+		);											\
+													\
+	*(node_info++) = quadtree_fill_node(			\
+		node->heads[2],								\
+		((quadtree_half_extent_t){0}) __VA_OPT__(,)	\
+		__VA_ARGS__									\
+		);											\
+													\
+	*(node_info++) = quadtree_fill_node(			\
+		node->heads[3],								\
+		((quadtree_half_extent_t){0}) __VA_OPT__(,)	\
+	  __VA_ARGS__									\
+	  );											\
+}													\
 while(0)
 
 #define quadtree_reset_flags()								\
@@ -413,10 +505,7 @@ quadtree_normalize(
 			--node_removal;
 		}
 
-		alloc_free(node_removals, qt->node_removals_size);
-		qt->node_removals = NULL;
 		qt->node_removals_used = 0;
-		qt->node_removals_size = 0;
 	}
 
 
@@ -430,7 +519,7 @@ quadtree_normalize(
 			uint32_t entity_idx = reinsertion->entity_idx;
 			quadtree_entity_t* entity = entities + entity_idx;
 
-			rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
+			quadtree_rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
 			uint32_t in_nodes = 0;
 
 			node_info = node_infos;
@@ -453,7 +542,7 @@ quadtree_normalize(
 					continue;
 				}
 
-				rect_extent_t node_extent = half_to_rect_extent(info.extent);
+				quadtree_rect_extent_t node_extent = quadtree_half_to_rect_extent(info.extent);
 				uint32_t node_entity_idx = node->head;
 
 				++in_nodes;
@@ -513,10 +602,7 @@ quadtree_normalize(
 			++reinsertion;
 		}
 
-		alloc_free(reinsertions, qt->reinsertions_size);
-		qt->reinsertions = NULL;
 		qt->reinsertions_used = 0;
-		qt->reinsertions_size = 0;
 	}
 
 
@@ -538,7 +624,7 @@ quadtree_normalize(
 
 			uint32_t entity_idx = removal->entity_idx;
 			quadtree_entity_t* entity = entities + entity_idx;
-			rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
+			quadtree_rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
 
 			do
 			{
@@ -591,10 +677,7 @@ quadtree_normalize(
 			++removal;
 		}
 
-		alloc_free(removals, qt->removals_size);
-		qt->removals = NULL;
 		qt->removals_used = 0;
-		qt->removals_size = 0;
 	}
 
 
@@ -637,7 +720,7 @@ quadtree_normalize(
 			entity->update_tick = qt->update_tick;
 			entity->reinsertion_tick = qt->update_tick;
 
-			rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
+			quadtree_rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
 			uint32_t in_nodes = 0;
 
 			node_info = node_infos;
@@ -660,7 +743,7 @@ quadtree_normalize(
 					continue;
 				}
 
-				rect_extent_t node_extent = half_to_rect_extent(info.extent);
+				quadtree_rect_extent_t node_extent = quadtree_half_to_rect_extent(info.extent);
 				uint32_t node_entity_idx;
 
 				++in_nodes;
@@ -708,10 +791,7 @@ quadtree_normalize(
 			++insertion;
 		}
 
-		alloc_free(insertions, qt->insertions_size);
-		qt->insertions = NULL;
 		qt->insertions_used = 0;
-		qt->insertions_size = 0;
 	}
 
 
@@ -720,69 +800,72 @@ quadtree_normalize(
 		uint32_t nodes_used = qt->nodes_used;
 		uint32_t nodes_size = qt->nodes_size;
 
-		quadtree_node_t* new_nodes;
-		quadtree_node_entities_t new_node_entities;
-		quadtree_entity_t* new_entities;
+		quadtree_node_t* new_nodes = qt->spare_nodes;
+		quadtree_node_entities_t new_node_entities = qt->spare_node_entities;
+		quadtree_entity_t* new_entities = qt->spare_entities;
+		uint32_t* entity_map = qt->entity_map;
 
 		uint32_t new_nodes_used = 0;
-		uint32_t new_nodes_size;
+		uint32_t new_nodes_size = qt->spare_nodes_size;
 
-		if(nodes_size >> 2 < nodes_used)
+		if(new_nodes_size < nodes_size)
 		{
+			new_nodes = alloc_remalloc(new_nodes, new_nodes_size, nodes_size);
+			assert_not_null(new_nodes);
+
 			new_nodes_size = nodes_size;
 		}
-		else
-		{
-			new_nodes_size = nodes_size >> 1;
-		}
 
 		uint32_t new_node_entities_used = 1;
-		uint32_t new_node_entities_size;
+		uint32_t new_node_entities_size = qt->spare_node_entities_size;
 
-		if(node_entities_size >> 2 < node_entities_used)
+		if(new_node_entities_size < node_entities_size)
 		{
+			new_node_entities.next = alloc_remalloc(new_node_entities.next,
+				new_node_entities_size, node_entities_size);
+			assert_not_null(new_node_entities.next);
+
+			new_node_entities.entities = alloc_remalloc(new_node_entities.entities,
+				new_node_entities_size, node_entities_size);
+			assert_not_null(new_node_entities.entities);
+
+			new_node_entities.flags = alloc_remalloc(new_node_entities.flags,
+				new_node_entities_size, node_entities_size);
+			assert_not_null(new_node_entities.flags);
+
 			new_node_entities_size = node_entities_size;
 		}
-		else
-		{
-			new_node_entities_size = node_entities_size >> 1;
-		}
 
 		uint32_t new_entities_used = 1;
-		uint32_t new_entities_size;
+		uint32_t new_entities_size = qt->spare_entities_size;
 
-		if(entities_size >> 2 < entities_used)
+		if(new_entities_size < entities_size)
 		{
+			new_entities = alloc_remalloc(new_entities, new_entities_size, entities_size);
+			assert_not_null(new_entities);
+
 			new_entities_size = entities_size;
 		}
-		else
-		{
-			new_entities_size = entities_size >> 1;
-		}
 
-		new_nodes = alloc_malloc(new_nodes, new_nodes_size);
-		assert_not_null(new_nodes);
-
-		new_node_entities.next = alloc_malloc(new_node_entities.next, new_node_entities_size);
-		assert_not_null(new_node_entities.next);
-
-		new_node_entities.entities = alloc_malloc(new_node_entities.entities, new_node_entities_size);
-		assert_not_null(new_node_entities.entities);
-
-		new_node_entities.flags = alloc_malloc(new_node_entities.flags, new_node_entities_size);
-		assert_not_null(new_node_entities.flags);
+		if(qt->entity_map_size < entities_size)
+		{
+			entity_map = alloc_remalloc(entity_map, qt->entity_map_size, entities_size);
+			assert_not_null(entity_map);
 
-		new_entities = alloc_malloc(new_entities, new_entities_size);
-		assert_ptr(new_entities, new_entities_size);
+			qt->entity_map = entity_map;
+			qt->entity_map_size = entities_size;
+		}
 
-		uint32_t* entity_map = alloc_calloc(entity_map, entities_size);
-		assert_ptr(entity_map, entities_size);
+		if(entities_size)
+		{
+			memset(entity_map, 0, sizeof(*entity_map) * entities_size);
+		}
 
 
 		typedef struct quadtree_node_reorder_info
 		{
 			uint32_t node_idx;
-			half_extent_t extent;
+			quadtree_half_extent_t extent;
 			uint32_t parent_node_idx;
 			uint32_t head_idx;
 			uint32_t depth;
@@ -847,7 +930,7 @@ quadtree_normalize(
 					node->count = 0;
 					node->type = QUADTREE_NODE_TYPE_LEAF;
 
-					rect_extent_t node_extent = half_to_rect_extent(info.extent);
+					quadtree_rect_extent_t node_extent = quadtree_half_to_rect_extent(info.extent);
 
 					assert_ge(qt->merge_ht_size, qt->merge_threshold);
 					memset(qt->merge_ht, 0, sizeof(*qt->merge_ht) * qt->merge_ht_size);
@@ -880,7 +963,7 @@ quadtree_normalize(
 									node_entities.entities[node_entity_idx].is_last = !node->head;
 									node->head = node_entity_idx;
 
-									rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
+									quadtree_rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
 									quadtree_reset_flags();
 
 									++node->count;
@@ -997,7 +1080,7 @@ quadtree_normalize(
 					uint32_t entity_idx = node_entities.entities[node_entity_idx].index;
 					quadtree_entity_t* entity = entities + entity_idx;
 
-					rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
+					quadtree_rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
 
 					uint32_t target_node_idxs[4];
 					uint32_t* current_target_node_idx = target_node_idxs;
@@ -1097,8 +1180,8 @@ quadtree_normalize(
 
 			if(node->type != QUADTREE_NODE_TYPE_LEAF)
 			{
-				float half_w = info.extent.w * 0.5f;
-				float half_h = info.extent.h * 0.5f;
+				quadtree_coord_t half_w = quadtree_coord_half(info.extent.w);
+				quadtree_coord_t half_h = quadtree_coord_half(info.extent.h);
 				uint32_t next_depth = info.depth + 1;
 
 				*(node_info++) =
@@ -1106,7 +1189,7 @@ quadtree_normalize(
 				{
 					.node_idx = node->heads[0],
 					.extent =
-					(half_extent_t)
+					(quadtree_half_extent_t)
 					{
 						.x = info.extent.x - half_w,
 						.y = info.extent.y - half_h,
@@ -1123,7 +1206,7 @@ quadtree_normalize(
 				{
 					.node_idx = node->heads[1],
 					.extent =
-					(half_extent_t)
+					(quadtree_half_extent_t)
 					{
 						.x = info.extent.x - half_w,
 						.y = info.extent.y + half_h,
@@ -1140,7 +1223,7 @@ quadtree_normalize(
 				{
 					.node_idx = node->heads[2],
 					.extent =
-					(half_extent_t)
+					(quadtree_half_extent_t)
 					{
 						.x = info.extent.x + half_w,
 						.y = info.extent.y - half_h,
@@ -1157,7 +1240,7 @@ quadtree_normalize(
 				{
 					.node_idx = node->heads[3],
 					.extent =
-					(half_extent_t)
+					(quadtree_half_extent_t)
 					{
 						.x = info.extent.x + half_w,
 						.y = info.extent.y + half_h,
@@ -1220,24 +1303,23 @@ quadtree_normalize(
 		}
 		while(node_info != node_infos);
 
-		alloc_free(nodes, nodes_size);
+		qt->spare_nodes = nodes;
+		qt->spare_nodes_size = nodes_size;
 		qt->nodes = new_nodes;
 		qt->nodes_used = new_nodes_used;
 		qt->nodes_size = new_nodes_size;
 
-		alloc_free(node_entities.next, node_entities_size);
-		alloc_free(node_entities.entities, node_entities_size);
-		alloc_free(node_entities.flags, node_entities_size);
+		qt->spare_node_entities = node_entities;
+		qt->spare_node_entities_size = node_entities_size;
 		qt->node_entities = new_node_entities;
 		qt->node_entities_used = new_node_entities_used;
 		qt->node_entities_size = new_node_entities_size;
 
-		alloc_free(entities, entities_size);
+		qt->spare_entities = entities;
+		qt->spare_entities_size = entities_size;
 		qt->entities = new_entities;
 		qt->entities_used = new_entities_used;
 		qt->entities_size = new_entities_size;
-
-		alloc_free(entity_map, entities_size);
 	}
 }
 
@@ -1314,7 +1396,7 @@ quadtree_update(
 			continue;
 		}
 
-		rect_extent_t node_extent = half_to_rect_extent(info.extent);
+		quadtree_rect_extent_t node_extent = quadtree_half_to_rect_extent(info.extent);
 
 		do
 		{
@@ -1343,7 +1425,7 @@ quadtree_update(
 				continue;
 			}
 
-			rect_extent_t extent = quadtree_get_entity_rect_extent(entity);
+			quadtree_rect_extent_t extent = quadtree_get_entity_rect_extent(entity);
 
 			bool crossed_new_boundary = false;
 			uint8_t flags = *node_entities_flags;
@@ -1476,7 +1558,7 @@ quadtree_update(
 void
 quadtree_query_rect(
 	quadtree_t* qt,
-	rect_extent_t extent,
+	quadtree_rect_extent_t extent,
 	quadtree_query_fn_t query_fn,
 	void* user_data
 	)
@@ -1531,7 +1613,7 @@ quadtree_query_rect(
 			{
 				entity->query_tick = query_tick;
 
-				if(rect_extent_intersects(quadtree_get_entity_rect_extent(entity), extent))
+				if(quadtree_rect_extent_intersects(quadtree_get_entity_rect_extent(entity), extent))
 				{
 					quadtree_entity_info_t entity_info =
 					{
@@ -1558,15 +1640,96 @@ quadtree_query_rect(
 }
 
 
-private float
+#ifdef quadtree_get_entity_data_idx
+
+
+typedef struct quadtree_query_at
+{
+	const history_t* history;
+	uint64_t tick;
+	rect_extent_t extent;
+	quadtree_query_fn_t query_fn;
+	void* user_data;
+}
+quadtree_query_at_t;
+
+
+private quadtree_status_t
+quadtree_query_at_fn(
+	quadtree_t* qt,
+	quadtree_entity_info_t info,
+	void* user_data
+	)
+{
+	quadtree_query_at_t* query = user_data;
+
+	if(!history_intersects(query->history, query->tick, quadtree_get_entity_data_idx(*info.data), query->extent))
+	{
+		return QUADTREE_STATUS_NOT_CHANGED;
+	}
+
+	return query->query_fn(qt, info, query->user_data);
+}
+
+
+/*
+ * Nothing moved or grew by more than the history's spread since the tick,
+ * so the current tree queried with an extent grown by that much finds a
+ * superset of what overlapped it back then. The tree is left untouched.
+ */
+void
+quadtree_query_rect_at(
+	quadtree_t* qt,
+	const history_t* history,
+	uint64_t tick,
+	quadtree_rect_extent_t extent,
+	quadtree_query_fn_t query_fn,
+	void* user_data
+	)
+{
+	assert_not_null(qt);
+	assert_not_null(history);
+	assert_not_null(query_fn);
+	assert_true(history_has(history, tick));
+
+	quadtree_query_at_t query =
+	{
+		.history = history,
+		.tick = tick,
+		.extent =
+		{
+			.min_x = quadtree_coord_to_f32(extent.min_x),
+			.min_y = quadtree_coord_to_f32(extent.min_y),
+			.max_x = quadtree_coord_to_f32(extent.max_x),
+			.max_y = quadtree_coord_to_f32(extent.max_y)
+		},
+		.query_fn = query_fn,
+		.user_data = user_data
+	};
+
+	quadtree_coord_t spread = quadtree_coord_from_f32(history_spread(history, tick));
+
+	extent.min_x -= spread;
+	extent.min_y -= spread;
+	extent.max_x += spread;
+	extent.max_y += spread;
+
+	quadtree_query_rect(qt, extent, quadtree_query_at_fn, &query);
+}
+
+
+#endif
+
+
+private quadtree_dist_t
 quadtree_point_to_extent_distance_sq(
-	float x,
-	float y,
-	rect_extent_t extent
+	quadtree_coord_t x,
+	quadtree_coord_t y,
+	quadtree_rect_extent_t extent
 	)
 {
-	float dx = MACRO_MAX(MACRO_MAX(extent.min_x - x, 0.0f), x - extent.max_x);
-	float dy = MACRO_MAX(MACRO_MAX(extent.min_y - y, 0.0f), y - extent.max_y);
+	quadtree_dist_t dx = MACRO_MAX(MACRO_MAX((quadtree_dist_t) extent.min_x - x, (quadtree_dist_t) 0), (quadtree_dist_t) x - extent.max_x);
+	quadtree_dist_t dy = MACRO_MAX(MACRO_MAX((quadtree_dist_t) extent.min_y - y, (quadtree_dist_t) 0), (quadtree_dist_t) y - extent.max_y);
 	return dx * dx + dy * dy;
 }
 
@@ -1574,9 +1737,9 @@ quadtree_point_to_extent_distance_sq(
 void
 quadtree_query_circle(
 	quadtree_t* qt,
-	float x,
-	float y,
-	float radius,
+	quadtree_coord_t x,
+	quadtree_coord_t y,
+	quadtree_coord_t radius,
 	quadtree_query_fn_t query_fn,
 	void* user_data
 	)
@@ -1589,9 +1752,9 @@ quadtree_query_circle(
 	++qt->query_tick;
 	uint32_t query_tick = qt->query_tick;
 
-	float radius_sq = radius * radius;
+	quadtree_dist_t radius_sq = (quadtree_dist_t) radius * radius;
 
-	rect_extent_t search_extent =
+	quadtree_rect_extent_t search_extent =
 	{
 		.min_x = x - radius,
 		.min_y = y - radius,
@@ -1618,7 +1781,7 @@ quadtree_query_circle(
 		quadtree_node_info_t info = *(--node_info);
 		quadtree_node_t* node = nodes + info.node_idx;
 
-		rect_extent_t node_extent = half_to_rect_extent(info.extent);
+		quadtree_rect_extent_t node_extent = quadtree_half_to_rect_extent(info.extent);
 
 		if(quadtree_point_to_extent_distance_sq(x, y, node_extent) > radius_sq)
 		{
@@ -1648,10 +1811,10 @@ quadtree_query_circle(
 			{
 				entity->query_tick = query_tick;
 
-				rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
+				quadtree_rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
 
-				float edx = MACRO_MAX(MACRO_MAX(entity_extent.min_x - x, 0.0f), x - entity_extent.max_x);
-				float edy = MACRO_MAX(MACRO_MAX(entity_extent.min_y - y, 0.0f), y - entity_extent.max_y);
+				quadtree_dist_t edx = MACRO_MAX(MACRO_MAX((quadtree_dist_t) entity_extent.min_x - x, (quadtree_dist_t) 0), (quadtree_dist_t) x - entity_extent.max_x);
+				quadtree_dist_t edy = MACRO_MAX(MACRO_MAX((quadtree_dist_t) entity_extent.min_y - y, (quadtree_dist_t) 0), (quadtree_dist_t) y - entity_extent.max_y);
 
 				if(edx * edx + edy * edy <= radius_sq)
 				{
@@ -1683,7 +1846,7 @@ quadtree_query_circle(
 void
 quadtree_query_nodes_rect(
 	quadtree_t* qt,
-	rect_extent_t extent,
+	quadtree_rect_extent_t extent,
 	quadtree_node_query_fn_t node_query_fn,
 	void* user_data
 	)
@@ -1729,9 +1892,9 @@ quadtree_query_nodes_rect(
 void
 quadtree_query_nodes_circle(
 	quadtree_t* qt,
-	float x,
-	float y,
-	float radius,
+	quadtree_coord_t x,
+	quadtree_coord_t y,
+	quadtree_coord_t radius,
 	quadtree_node_query_fn_t node_query_fn,
 	void* user_data
 	)
@@ -1741,9 +1904,9 @@ quadtree_query_nodes_circle(
 
 	quadtree_normalize_hard(qt);
 
-	float radius_sq = radius * radius;
+	quadtree_dist_t radius_sq = (quadtree_dist_t) radius * radius;
 
-	rect_extent_t search_extent =
+	quadtree_rect_extent_t search_extent =
 	{
 		.min_x = x - radius,
 		.min_y = y - radius,
@@ -1768,7 +1931,7 @@ quadtree_query_nodes_circle(
 		quadtree_node_info_t info = *(--node_info);
 		quadtree_node_t* node = nodes + info.node_idx;
 
-		rect_extent_t node_extent = half_to_rect_extent(info.extent);
+		quadtree_rect_extent_t node_extent = quadtree_half_to_rect_extent(info.extent);
 
 		if(quadtree_point_to_extent_distance_sq(x, y, node_extent) > radius_sq)
 		{
@@ -1810,8 +1973,18 @@ quadtree_collide(
 
 #if QUADTREE_DEDUPE_COLLISIONS == 1
 	uint32_t ht_size = qt->ht_entries_used * 2;
-	uint32_t* ht = alloc_calloc(ht, ht_size);
-	assert_not_null(ht);
+	uint32_t* ht = qt->ht;
+
+	if(qt->ht_size < ht_size)
+	{
+		ht = alloc_remalloc(ht, qt->ht_size, ht_size);
+		assert_not_null(ht);
+
+		qt->ht = ht;
+		qt->ht_size = ht_size;
+	}
+
+	memset(ht, 0, sizeof(*ht) * ht_size);
 
 	quadtree_ht_entry_t* ht_entries = qt->ht_entries;
 
@@ -1835,7 +2008,7 @@ quadtree_collide(
 
 		uint32_t entity_idx = node_entity->index;
 		quadtree_entity_t* entity = entities + entity_idx;
-		rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
+		quadtree_rect_extent_t entity_extent = quadtree_get_entity_rect_extent(entity);
 		quadtree_entity_info_t entity_info =
 		{
 			.idx = entity_idx,
@@ -1851,7 +2024,7 @@ quadtree_collide(
 			uint32_t other_entity_idx = other_node_entity->index;
 			quadtree_entity_t* other_entity = entities + other_entity_idx;
 
-			if(!rect_extent_intersects(
+			if(!quadtree_rect_extent_intersects(
 				entity_extent,
 				quadtree_get_entity_rect_extent(other_entity)
 				))
@@ -1924,21 +2097,9 @@ quadtree_collide(
 	while(node_entity != node_entities_end);
 
 #if QUADTREE_DEDUPE_COLLISIONS == 1
-	if(ht_entries_used * 4 <= ht_entries_size)
-	{
-		uint32_t new_size = ht_entries_size >> 1;
-
-		ht_entries = alloc_remalloc(ht_entries, ht_entries_size, new_size);
-		assert_not_null(ht_entries);
-
-		ht_entries_size = new_size;
-	}
-
 	qt->ht_entries = ht_entries;
 	qt->ht_entries_used = ht_entries_used;
 	qt->ht_entries_size = ht_entries_size;
-
-	alloc_free(ht, ht_size);
 #endif
 }
 
@@ -2007,11 +2168,41 @@ quadtree_fill_node_default(__VA_ARGS__)
 }
 
 
+uint64_t
+quadtree_memory_usage(
+	const quadtree_t* qt
+	)
+{
+	assert_not_null(qt);
+
+	uint64_t node_entity_size = sizeof(*qt->node_entities.next) +
+		sizeof(*qt->node_entities.entities) + sizeof(*qt->node_entities.flags);
+
+	uint64_t usage = 0;
+
+	usage += sizeof(*qt->nodes) * (qt->nodes_size + qt->spare_nodes_size);
+	usage += node_entity_size * (qt->node_entities_size + qt->spare_node_entities_size);
+	usage += sizeof(*qt->entities) * (qt->entities_size + qt->spare_entities_size);
+	usage += sizeof(*qt->entity_map) * qt->entity_map_size;
+#if QUADTREE_DEDUPE_COLLISIONS == 1
+	usage += sizeof(*qt->ht) * qt->ht_size;
+	usage += sizeof(*qt->ht_entries) * qt->ht_entries_size;
+#endif
+	usage += sizeof(*qt->removals) * qt->removals_size;
+	usage += sizeof(*qt->node_removals) * qt->node_removals_size;
+	usage += sizeof(*qt->insertions) * qt->insertions_size;
+	usage += sizeof(*qt->reinsertions) * qt->reinsertions_size;
+	usage += sizeof(*qt->merge_ht) * qt->merge_ht_size;
+
+	return usage;
+}
+
+
 typedef struct quadtree_search_item
 {
-	float value;
+	quadtree_dist_t value;
 	uint32_t idx;
-	half_extent_t extent;
+	quadtree_half_extent_t extent;
 }
 quadtree_search_item_t;
 
@@ -2031,7 +2222,7 @@ quadtree_search_cmp(
 void
 quadtree_nearest_rect(
 	quadtree_t* qt,
-	rect_extent_t extent,
+	quadtree_rect_extent_t extent,
 	uint32_t max_results,
 	quadtree_query_fn_t query_fn,
 	void* user_data
@@ -2055,16 +2246,16 @@ quadtree_nearest_rect(
 	heap.el_size = sizeof(quadtree_search_item_t);
 	heap_init(&heap);
 
-	float center_x = (extent.min_x + extent.max_x) * 0.5f;
-	float center_y = (extent.min_y + extent.max_y) * 0.5f;
+	quadtree_coord_t center_x = quadtree_coord_half(extent.min_x + extent.max_x);
+	quadtree_coord_t center_y = quadtree_coord_half(extent.min_y + extent.max_y);
 
-	if(!rect_extent_intersects(qt->rect_extent, extent))
+	if(!quadtree_rect_extent_intersects(qt->rect_extent, extent))
 	{
 		heap_free(&heap);
 		return;
 	}
 
-	float root_dist = quadtree_point_to_extent_distance_sq(center_x, center_y, qt->rect_extent);
+	quadtree_dist_t root_dist = quadtree_point_to_extent_distance_sq(center_x, center_y, qt->rect_extent);
 
 	heap_push(&heap,
 		&(quadtree_search_item_t)
@@ -2086,7 +2277,7 @@ quadtree_nearest_rect(
 		quadtree_search_item_t* current_ptr = heap_pop(&heap);
 		quadtree_search_item_t current = *current_ptr;
 
-		if(current.extent.w == 0.0f)
+		if(current.extent.w == 0)
 		{
 			uint32_t entity_idx = current.idx;
 			quadtree_entity_t* entity = entities + entity_idx;
@@ -2112,12 +2303,12 @@ quadtree_nearest_rect(
 
 		if(node->type != QUADTREE_NODE_TYPE_LEAF)
 		{
-			float half_w = current.extent.w * 0.5f;
-			float half_h = current.extent.h * 0.5f;
+			quadtree_coord_t half_w = quadtree_coord_half(current.extent.w);
+			quadtree_coord_t half_h = quadtree_coord_half(current.extent.h);
 
 			for(uint32_t i = 0; i < 4; ++i)
 			{
-				half_extent_t child_ext =
+				quadtree_half_extent_t child_ext =
 				{
 					.x = current.extent.x + (i & 2) ? half_w : -half_w,
 					.y = current.extent.y + (i & 1) ? half_h : -half_h,
@@ -2125,11 +2316,11 @@ quadtree_nearest_rect(
 					.h = half_h
 				};
 
-				rect_extent_t child_rect = half_to_rect_extent(child_ext);
+				quadtree_rect_extent_t child_rect = quadtree_half_to_rect_extent(child_ext);
 
-				if(rect_extent_intersects(child_rect, extent))
+				if(quadtree_rect_extent_intersects(child_rect, extent))
 				{
-					float d = quadtree_point_to_extent_distance_sq(center_x, center_y, child_rect);
+					quadtree_dist_t d = quadtree_point_to_extent_distance_sq(center_x, center_y, child_rect);
 
 					heap_push(&heap,
 						&(quadtree_search_item_t)
@@ -2162,11 +2353,11 @@ quadtree_nearest_rect(
 			{
 				entity->query_tick = query_tick;
 
-				rect_extent_t ent_rect = quadtree_get_entity_rect_extent(entity);
+				quadtree_rect_extent_t ent_rect = quadtree_get_entity_rect_extent(entity);
 
-				if(rect_extent_intersects(ent_rect, extent))
+				if(quadtree_rect_extent_intersects(ent_rect, extent))
 				{
-					float d = quadtree_point_to_extent_distance_sq(center_x, center_y, ent_rect);
+					quadtree_dist_t d = quadtree_point_to_extent_distance_sq(center_x, center_y, ent_rect);
 
 					heap_push(&heap,
 						&(quadtree_search_item_t)
@@ -2193,9 +2384,9 @@ quadtree_nearest_rect(
 void
 quadtree_nearest_circle(
 	quadtree_t* qt,
-	float x,
-	float y,
-	float max_distance,
+	quadtree_coord_t x,
+	quadtree_coord_t y,
+	quadtree_coord_t max_distance,
 	uint32_t max_results,
 	quadtree_query_fn_t query_fn,
 	void* user_data
@@ -2214,8 +2405,8 @@ quadtree_nearest_circle(
 	++qt->query_tick;
 	uint32_t query_tick = qt->query_tick;
 
-	float root_dist = quadtree_point_to_extent_distance_sq(x, y, qt->rect_extent);
-	float max_dist_sq = (max_distance < 0.0f) ? INFINITY : (max_distance * max_distance);
+	quadtree_dist_t root_dist = quadtree_point_to_extent_distance_sq(x, y, qt->rect_extent);
+	quadtree_dist_t max_dist_sq = (max_distance < 0) ? QUADTREE_DIST_MAX : ((quadtree_dist_t) max_distance * max_distance);
 
 	if(root_dist > max_dist_sq)
 	{
@@ -2252,7 +2443,7 @@ quadtree_nearest_circle(
 			break;
 		}
 
-		if(current.extent.w == 0.0f)
+		if(current.extent.w == 0)
 		{
 			uint32_t entity_idx = current.idx;
 			quadtree_entity_t* entity = entities + entity_idx;
@@ -2278,12 +2469,12 @@ quadtree_nearest_circle(
 
 		if(node->type != QUADTREE_NODE_TYPE_LEAF)
 		{
-			float half_w = current.extent.w * 0.5f;
-			float half_h = current.extent.h * 0.5f;
+			quadtree_coord_t half_w = quadtree_coord_half(current.extent.w);
+			quadtree_coord_t half_h = quadtree_coord_half(current.extent.h);
 
 			for(uint32_t i = 0; i < 4; ++i)
 			{
-				half_extent_t child_ext =
+				quadtree_half_extent_t child_ext =
 				{
 					.x = current.extent.x + ((i & 2) ? half_w : -half_w),
 					.y = current.extent.y + ((i & 1) ? half_h : -half_h),
@@ -2291,7 +2482,7 @@ quadtree_nearest_circle(
 					.h = half_h
 				};
 
-				float d = quadtree_point_to_extent_distance_sq(x, y, half_to_rect_extent(child_ext));
+				quadtree_dist_t d = quadtree_point_to_extent_distance_sq(x, y, quadtree_half_to_rect_extent(child_ext));
 				if(d <= max_dist_sq)
 				{
 					heap_push(&heap,
@@ -2325,8 +2516,8 @@ quadtree_nearest_circle(
 			{
 				entity->query_tick = query_tick;
 
-				rect_extent_t ent_rect = quadtree_get_entity_rect_extent(entity);
-				float dist = quadtree_point_to_extent_distance_sq(x, y, ent_rect);
+				quadtree_rect_extent_t ent_rect = quadtree_get_entity_rect_extent(entity);
+				quadtree_dist_t dist = quadtree_point_to_extent_distance_sq(x, y, ent_rect);
 
 				if(dist <= max_dist_sq)
 				{
@@ -2355,10 +2546,10 @@ quadtree_nearest_circle(
 void
 quadtree_raycast(
 	quadtree_t* qt,
-	float x,
-	float y,
-	float dx,
-	float dy,
+	quadtree_coord_t x,
+	quadtree_coord_t y,
+	quadtree_coord_t dx,
+	quadtree_coord_t dy,
 	quadtree_query_fn_t query_fn,
 	void* user_data
 	)
@@ -2371,38 +2562,38 @@ quadtree_raycast(
 	++qt->query_tick;
 	uint32_t query_tick = qt->query_tick;
 
-	float inv_dx = 1.0f / dx;
-	float inv_dy = 1.0f / dy;
+	quadtree_dist_t inv_dx = quadtree_ray_inv(dx);
+	quadtree_dist_t inv_dy = quadtree_ray_inv(dy);
 
 	typedef struct quadtree_ray_node_info
 	{
 		uint32_t node_idx;
-		half_extent_t extent;
-		float t_min;
+		quadtree_half_extent_t extent;
+		quadtree_dist_t t_min;
 	}
 	quadtree_ray_node_info_t;
 
 	quadtree_ray_node_info_t stack[qt->dfs_length];
 	quadtree_ray_node_info_t* stack_ptr = stack;
 
-	float t1 = (qt->rect_extent.min_x - x) * inv_dx;
-	float t2 = (qt->rect_extent.max_x - x) * inv_dx;
-	float t_min = MACRO_MIN(t1, t2);
-	float t_max = MACRO_MAX(t1, t2);
+	quadtree_dist_t t1 = quadtree_ray_param((quadtree_dist_t) qt->rect_extent.min_x - x, inv_dx);
+	quadtree_dist_t t2 = quadtree_ray_param((quadtree_dist_t) qt->rect_extent.max_x - x, inv_dx);
+	quadtree_dist_t t_min = MACRO_MIN(t1, t2);
+	quadtree_dist_t t_max = MACRO_MAX(t1, t2);
 
-	t1 = (qt->rect_extent.min_y - y) * inv_dy;
-	t2 = (qt->rect_extent.max_y - y) * inv_dy;
+	t1 = quadtree_ray_param((quadtree_dist_t) qt->rect_extent.min_y - y, inv_dy);
+	t2 = quadtree_ray_param((quadtree_dist_t) qt->rect_extent.max_y - y, inv_dy);
 	t_min = MACRO_MAX(t_min, MACRO_MIN(t1, t2));
 	t_max = MACRO_MIN(t_max, MACRO_MAX(t1, t2));
 
-	if(t_max >= t_min && t_max >= 0.0f && t_min <= 1.0f)
+	if(t_max >= t_min && t_max >= 0 && t_min <= QUADTREE_RAY_ONE)
 	{
 		*(stack_ptr++) =
 		(quadtree_ray_node_info_t)
 		{
 			.node_idx = 0,
 			.extent = qt->half_extent,
-			.t_min = MACRO_MAX(t_min, 0.0f)
+			.t_min = MACRO_MAX(t_min, (quadtree_dist_t) 0)
 		};
 	}
 
@@ -2417,15 +2608,15 @@ quadtree_raycast(
 
 		if(node->type != QUADTREE_NODE_TYPE_LEAF)
 		{
-			float half_w = current.extent.w * 0.5f;
-			float half_h = current.extent.h * 0.5f;
+			quadtree_coord_t half_w = quadtree_coord_half(current.extent.w);
+			quadtree_coord_t half_h = quadtree_coord_half(current.extent.h);
 
 			quadtree_ray_node_info_t children[4];
 			uint32_t child_count = 0;
 
 			for(uint32_t i = 0; i < 4; ++i)
 			{
-				half_extent_t child_ext =
+				quadtree_half_extent_t child_ext =
 				{
 					.x = current.extent.x + ((i & 2) ? half_w : -half_w),
 					.y = current.extent.y + ((i & 1) ? half_h : -half_h),
@@ -2433,26 +2624,26 @@ quadtree_raycast(
 					.h = half_h
 				};
 
-				rect_extent_t r = half_to_rect_extent(child_ext);
+				quadtree_rect_extent_t r = quadtree_half_to_rect_extent(child_ext);
 
-				float t1 = (r.min_x - x) * inv_dx;
-				float t2 = (r.max_x - x) * inv_dx;
-				float c_t_min = MACRO_MIN(t1, t2);
-				float c_t_max = MACRO_MAX(t1, t2);
+				quadtree_dist_t t1 = quadtree_ray_param((quadtree_dist_t) r.min_x - x, inv_dx);
+				quadtree_dist_t t2 = quadtree_ray_param((quadtree_dist_t) r.max_x - x, inv_dx);
+				quadtree_dist_t c_t_min = MACRO_MIN(t1, t2);
+				quadtree_dist_t c_t_max = MACRO_MAX(t1, t2);
 
-				t1 = (r.min_y - y) * inv_dy;
-				t2 = (r.max_y - y) * inv_dy;
+				t1 = quadtree_ray_param((quadtree_dist_t) r.min_y - y, inv_dy);
+				t2 = quadtree_ray_param((quadtree_dist_t) r.max_y - y, inv_dy);
 				c_t_min = MACRO_MAX(c_t_min, MACRO_MIN(t1, t2));
 				c_t_max = MACRO_MIN(c_t_max, MACRO_MAX(t1, t2));
 
-				if(c_t_max >= c_t_min && c_t_max >= 0.0f && c_t_min <= 1.0f)
+				if(c_t_max >= c_t_min && c_t_max >= 0 && c_t_min <= QUADTREE_RAY_ONE)
 				{
 					children[child_count++] =
 					(quadtree_ray_node_info_t)
 					{
 						.node_idx = node->heads[i],
 						.extent = child_ext,
-						.t_min = MACRO_MAX(c_t_min, 0.0f)
+						.t_min = MACRO_MAX(c_t_min, (quadtree_dist_t) 0)
 					};
 				}
 			}
@@ -2500,19 +2691,19 @@ quadtree_raycast(
 			{
 				entity->query_tick = query_tick;
 
-				rect_extent_t r = quadtree_get_entity_rect_extent(entity);
+				quadtree_rect_extent_t r = quadtree_get_entity_rect_extent(entity);
 
-				float t1 = (r.min_x - x) * inv_dx;
-				float t2 = (r.max_x - x) * inv_dx;
-				float e_t_min = MACRO_MIN(t1, t2);
-				float e_t_max = MACRO_MAX(t1, t2);
+				quadtree_dist_t t1 = quadtree_ray_param((quadtree_dist_t) r.min_x - x, inv_dx);
+				quadtree_dist_t t2 = quadtree_ray_param((quadtree_dist_t) r.max_x - x, inv_dx);
+				quadtree_dist_t e_t_min = MACRO_MIN(t1, t2);
+				quadtree_dist_t e_t_max = MACRO_MAX(t1, t2);
 
-				t1 = (r.min_y - y) * inv_dy;
-				t2 = (r.max_y - y) * inv_dy;
+				t1 = quadtree_ray_param((quadtree_dist_t) r.min_y - y, inv_dy);
+				t2 = quadtree_ray_param((quadtree_dist_t) r.max_y - y, inv_dy);
 				e_t_min = MACRO_MAX(e_t_min, MACRO_MIN(t1, t2));
 				e_t_max = MACRO_MIN(e_t_max, MACRO_MAX(t1, t2));
 
-				if(e_t_max >= e_t_min && e_t_max >= 0.0f && e_t_min <= 1.0f)
+				if(e_t_max >= e_t_min && e_t_max >= 0 && e_t_min <= QUADTREE_RAY_ONE)
 				{
 					quadtree_entity_info_t entity_info =
 					{
@@ -2566,7 +2757,7 @@ quadtree_check_in_nodes_count(
 	for(i = 1; i < entities_used; ++i)
 	{
 		quadtree_entity_t* entity = entities + i;
-		rect_extent_t extent = quadtree_get_entity_rect_extent(entity);
+		quadtree_rect_extent_t extent = quadtree_get_entity_rect_extent(entity);
 
 		uint32_t check_count = 0;
 		quadtree_query_nodes_rect(qt, extent, quadtree_check_count_node, &check_count);
@@ -2589,6 +2780,13 @@ quadtree_check(
 }
 
 
+#undef QUADTREE_DIST_MAX
+#undef QUADTREE_RAY_ONE
+#undef quadtree_ray_param
+#undef quadtree_ray_inv
+#undef quadtree_half_to_rect_extent
+#undef quadtree_rect_extent_intersects
+#undef quadtree_coord_half
 #undef quadtree_reset_flags
 #undef quadtree_descend_extentless
 #undef quadtree_descend_all
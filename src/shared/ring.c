@@ -0,0 +1,457 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/ring.h>
+#include <shared/debug.h>
+#include <shared/alloc_ext.h>
+
+#include <string.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <unistd.h>
+	#include <sys/mman.h>
+#endif
+
+
+void
+ring_init(
+	ring_t* ring,
+	uint32_t size
+	)
+{
+	assert_not_null(ring);
+	assert_gt(size, 0);
+	assert_true(MACRO_IS_POWER_OF_2(size));
+
+	ring->data = alloc_malloc(ring->data, size);
+	assert_not_null(ring->data);
+
+	ring->size = size;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->mirrored = false;
+}
+
+
+#ifdef _WIN32
+
+/* Views must start on the allocation granularity, not just a page */
+private uint32_t
+ring_map_granularity(
+	void
+	)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwAllocationGranularity;
+}
+
+
+private uint8_t*
+ring_map_mirrored(
+	uint32_t size
+	)
+{
+	HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, size, NULL);
+	hard_assert_not_null(mapping);
+
+	uint8_t* data = NULL;
+
+	/* Another thread may grab the reserved range between the calls, retry */
+	for(uint32_t attempt = 0; attempt < 16 && !data; ++attempt)
+	{
+		uint8_t* base = VirtualAlloc(NULL, size * 2, MEM_RESERVE, PAGE_NOACCESS);
+		hard_assert_not_null(base);
+
+		BOOL status = VirtualFree(base, 0, MEM_RELEASE);
+		hard_assert_neq(status, 0);
+
+		uint8_t* low = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, base);
+		if(!low)
+		{
+			continue;
+		}
+
+		uint8_t* high = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size, base + size);
+		if(!high)
+		{
+			(void) UnmapViewOfFile(low);
+			continue;
+		}
+
+		data = low;
+	}
+
+	hard_assert_not_null(data);
+
+	(void) CloseHandle(mapping);
+
+	return data;
+}
+
+
+private void
+ring_unmap_mirrored(
+	uint8_t* data,
+	uint32_t size
+	)
+{
+	(void) UnmapViewOfFile(data + size);
+	(void) UnmapViewOfFile(data);
+}
+
+#else
+
+private uint32_t
+ring_map_granularity(
+	void
+	)
+{
+	return alloc_get_page_size();
+}
+
+
+private uint8_t*
+ring_map_mirrored(
+	uint32_t size
+	)
+{
+	int fd = memfd_create("ring", MFD_CLOEXEC);
+	hard_assert_neq(fd, -1);
+
+	int status = ftruncate(fd, size);
+	hard_assert_neq(status, -1);
+
+	uint8_t* data = mmap(NULL, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	hard_assert_neq(data, MAP_FAILED);
+
+	void* low = mmap(data, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+	hard_assert_neq(low, MAP_FAILED);
+
+	void* high = mmap(data + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+	hard_assert_neq(high, MAP_FAILED);
+
+	(void) close(fd);
+
+	return data;
+}
+
+
+private void
+ring_unmap_mirrored(
+	uint8_t* data,
+	uint32_t size
+	)
+{
+	(void) munmap(data, size * 2);
+}
+
+#endif
+
+
+void
+ring_init_mirrored(
+	ring_t* ring,
+	uint32_t size
+	)
+{
+	assert_not_null(ring);
+	assert_gt(size, 0);
+	assert_true(MACRO_IS_POWER_OF_2(size));
+
+	/*
+	 * The same pages are mapped twice back to back, so any run of up to
+	 * `size` bytes starting inside the ring is contiguous in memory.
+	 */
+	size = MACRO_MAX(size, ring_map_granularity());
+
+	ring->data = ring_map_mirrored(size);
+	ring->size = size;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->mirrored = true;
+}
+
+
+void
+ring_free(
+	ring_t* ring
+	)
+{
+	assert_not_null(ring);
+
+	if(ring->mirrored)
+	{
+		ring_unmap_mirrored(ring->data, ring->size);
+	}
+	else
+	{
+		alloc_free(ring->data, ring->size);
+	}
+}
+
+
+void
+ring_reset(
+	ring_t* ring
+	)
+{
+	assert_not_null(ring);
+
+	ring->head = 0;
+	ring->tail = 0;
+}
+
+
+uint32_t
+ring_used(
+	ring_t* ring
+	)
+{
+	assert_not_null(ring);
+
+	return ring->tail - ring->head;
+}
+
+
+uint32_t
+ring_available(
+	ring_t* ring
+	)
+{
+	assert_not_null(ring);
+
+	return ring->size - ring_used(ring);
+}
+
+
+void
+ring_write(
+	ring_t* ring,
+	const void* data,
+	uint32_t len
+	)
+{
+	assert_not_null(ring);
+	assert_ptr(data, len);
+	assert_le(len, ring_available(ring));
+
+	uint32_t at = ring->tail & (ring->size - 1);
+	uint32_t first = MACRO_MIN(len, ring->size - at);
+
+	(void) memcpy(ring->data + at, data, first);
+	(void) memcpy(ring->data, data + first, len - first);
+
+	ring->tail += len;
+}
+
+
+void
+ring_write_safe(
+	ring_t* ring,
+	const void* data,
+	uint32_t len,
+	bool* status
+	)
+{
+	assert_not_null(ring);
+	assert_ptr(data, len);
+	assert_not_null(status);
+
+	if(ring_available(ring) < len)
+	{
+		*status = false;
+		return;
+	}
+
+	*status = true;
+	ring_write(ring, data, len);
+}
+
+
+void
+ring_peek(
+	ring_t* ring,
+	void* data,
+	uint32_t len
+	)
+{
+	assert_not_null(ring);
+	assert_ptr(data, len);
+	assert_le(len, ring_used(ring));
+
+	uint32_t at = ring->head & (ring->size - 1);
+	uint32_t first = MACRO_MIN(len, ring->size - at);
+
+	(void) memcpy(data, ring->data + at, first);
+	(void) memcpy(data + first, ring->data, len - first);
+}
+
+
+void
+ring_read(
+	ring_t* ring,
+	void* data,
+	uint32_t len
+	)
+{
+	ring_peek(ring, data, len);
+	ring_consume(ring, len);
+}
+
+
+void
+ring_read_safe(
+	ring_t* ring,
+	void* data,
+	uint32_t len,
+	bool* status
+	)
+{
+	assert_not_null(ring);
+	assert_ptr(data, len);
+	assert_not_null(status);
+
+	if(ring_used(ring) < len)
+	{
+		*status = false;
+		return;
+	}
+
+	*status = true;
+	ring_read(ring, data, len);
+}
+
+
+void
+ring_consume(
+	ring_t* ring,
+	uint32_t len
+	)
+{
+	assert_not_null(ring);
+	assert_le(len, ring_used(ring));
+
+	ring->head += len;
+
+	if(ring->head == ring->tail)
+	{
+		ring->head = 0;
+		ring->tail = 0;
+	}
+}
+
+
+void
+ring_produce(
+	ring_t* ring,
+	uint32_t len
+	)
+{
+	assert_not_null(ring);
+	assert_le(len, ring_available(ring));
+
+	ring->tail += len;
+}
+
+
+uint32_t
+ring_read_segments(
+	ring_t* ring,
+	ring_segment_t segments[2]
+	)
+{
+	assert_not_null(ring);
+	assert_not_null(segments);
+
+	uint32_t used = ring_used(ring);
+	if(!used)
+	{
+		return 0;
+	}
+
+	uint32_t at = ring->head & (ring->size - 1);
+	uint32_t first = MACRO_MIN(used, ring->size - at);
+
+	segments[0] = (ring_segment_t){ .data = ring->data + at, .len = first };
+
+	if(first == used)
+	{
+		return 1;
+	}
+
+	segments[1] = (ring_segment_t){ .data = ring->data, .len = used - first };
+
+	return 2;
+}
+
+
+uint32_t
+ring_write_segments(
+	ring_t* ring,
+	ring_segment_t segments[2]
+	)
+{
+	assert_not_null(ring);
+	assert_not_null(segments);
+
+	uint32_t available = ring_available(ring);
+	if(!available)
+	{
+		return 0;
+	}
+
+	uint32_t at = ring->tail & (ring->size - 1);
+	uint32_t first = MACRO_MIN(available, ring->size - at);
+
+	segments[0] = (ring_segment_t){ .data = ring->data + at, .len = first };
+
+	if(first == available)
+	{
+		return 1;
+	}
+
+	segments[1] = (ring_segment_t){ .data = ring->data, .len = available - first };
+
+	return 2;
+}
+
+
+uint8_t*
+ring_read_ptr(
+	ring_t* ring
+	)
+{
+	assert_not_null(ring);
+	assert_true(ring->mirrored);
+
+	return ring->data + (ring->head & (ring->size - 1));
+}
+
+
+uint8_t*
+ring_write_ptr(
+	ring_t* ring
+	)
+{
+	assert_not_null(ring);
+	assert_true(ring->mirrored);
+
+	return ring->data + (ring->tail & (ring->size - 1));
+}
@@ -0,0 +1,196 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/simd.h>
+#include <shared/debug.h>
+
+#include <string.h>
+
+
+/*
+ * All kernels work on whole vectors of SIMD_WIDTH lanes, which the
+ * compiler lowers to AVX2 or SSE2 (or NEON), or to plain scalar code
+ * when SIMD_WIDTH is 1. Any count works. simd_sincos() runs a partial
+ * last vector through a zero padded copy, so every element sees the same
+ * math. The lerp and clamp kernels finish with a scalar loop instead,
+ * which computes the same expressions one element at a time.
+ *
+ * simd_sincos() reduces the angle to [-pi/4, pi/4] around the nearest
+ * multiple of pi/2 with a three-part Cody-Waite split, then evaluates
+ * the cephes minimax polynomials. The absolute error against the exact
+ * result stays below 1.2e-7 for |angle| <= 8192 (measured in the tests),
+ * past which the reduction itself starts losing bits. Inputs are not
+ * checked for NaN or infinity.
+ */
+
+
+private void
+simd_sincos_v(
+	simd_f32_t x,
+	simd_f32_t* sin,
+	simd_f32_t* cos
+	)
+{
+	simd_i32_t sign = (simd_i32_t) x & (int32_t) 0x80000000;
+	simd_f32_t half = (simd_f32_t)(sign | (simd_i32_t)((simd_f32_t){} + 0.5f));
+
+	simd_i32_t quadrant = __builtin_convertvector(x * 0.63661977236758134f + half, simd_i32_t);
+	simd_f32_t q = __builtin_convertvector(quadrant, simd_f32_t);
+
+	simd_f32_t r = x - q * 1.5703125f;
+	r -= q * 4.837512969970703125e-4f;
+	r -= q * 7.54978995489188216e-8f;
+
+	simd_f32_t r2 = r * r;
+
+	simd_f32_t s = (simd_f32_t){} - 1.9515295891e-4f;
+	s = s * r2 + 8.3321608736e-3f;
+	s = s * r2 - 1.6666654611e-1f;
+	s = s * r2 * r + r;
+
+	simd_f32_t c = (simd_f32_t){} + 2.443315711809948e-5f;
+	c = c * r2 - 1.388731625493765e-3f;
+	c = c * r2 + 4.166664568298827e-2f;
+	c = c * r2 * r2 - 0.5f * r2 + 1.0f;
+
+	simd_i32_t swap = -(quadrant & 1);
+	simd_i32_t sin_bits = (swap & (simd_i32_t) c) | (~swap & (simd_i32_t) s);
+	simd_i32_t cos_bits = (swap & (simd_i32_t) s) | (~swap & (simd_i32_t) c);
+
+	*sin = (simd_f32_t)(sin_bits ^ ((quadrant & 2) << 30));
+	*cos = (simd_f32_t)(cos_bits ^ (((quadrant + 1) & 2) << 30));
+}
+
+
+void
+simd_sincos(
+	const float* angle,
+	float* sin,
+	float* cos,
+	uint32_t count
+	)
+{
+	assert_ptr(angle, count);
+	assert_ptr(sin, count);
+	assert_ptr(cos, count);
+
+	uint32_t i = 0;
+
+	for(; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+	{
+		simd_sincos_v(*(simd_f32_t*)(angle + i), (simd_f32_t*)(sin + i), (simd_f32_t*)(cos + i));
+	}
+
+	if(i != count)
+	{
+		float x[SIMD_WIDTH] = {0};
+		float s[SIMD_WIDTH];
+		float c[SIMD_WIDTH];
+
+		(void) memcpy(x, angle + i, sizeof(float) * (count - i));
+
+		simd_sincos_v(*(simd_f32_t*) x, (simd_f32_t*) s, (simd_f32_t*) c);
+
+		(void) memcpy(sin + i, s, sizeof(float) * (count - i));
+		(void) memcpy(cos + i, c, sizeof(float) * (count - i));
+	}
+}
+
+
+void
+simd_lerp(
+	float* value,
+	const float* target,
+	float by,
+	uint32_t count
+	)
+{
+	assert_ptr(value, count);
+	assert_ptr(target, count);
+
+	uint32_t i = 0;
+
+	for(; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+	{
+		simd_f32_t* v = (simd_f32_t*)(value + i);
+		*v += (*(simd_f32_t*)(target + i) - *v) * by;
+	}
+
+	for(; i < count; ++i)
+	{
+		value[i] += (target[i] - value[i]) * by;
+	}
+}
+
+
+void
+simd_lerp_to(
+	float* value,
+	float target,
+	float by,
+	uint32_t count
+	)
+{
+	assert_ptr(value, count);
+
+	uint32_t i = 0;
+
+	for(; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+	{
+		simd_f32_t* v = (simd_f32_t*)(value + i);
+		*v += (target - *v) * by;
+	}
+
+	for(; i < count; ++i)
+	{
+		value[i] += (target - value[i]) * by;
+	}
+}
+
+
+void
+simd_clamp(
+	float* value,
+	float min,
+	float max,
+	uint32_t count
+	)
+{
+	assert_ptr(value, count);
+	assert_le(min, max);
+
+	uint32_t i = 0;
+
+	for(; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+	{
+		simd_f32_t v = *(simd_f32_t*)(value + i);
+
+		simd_i32_t below = v < min;
+		simd_i32_t above = v > max;
+
+		simd_i32_t bits = (simd_i32_t) v & ~(below | above);
+		bits |= below & (simd_i32_t)((simd_f32_t){} + min);
+		bits |= above & (simd_i32_t)((simd_f32_t){} + max);
+
+		*(simd_f32_t*)(value + i) = (simd_f32_t) bits;
+	}
+
+	for(; i < count; ++i)
+	{
+		value[i] = value[i] < min ? min : value[i] > max ? max : value[i];
+	}
+}
@@ -18,6 +18,7 @@
 #include <shared/threads.h>
 #include <shared/alloc_ext.h>
 
+#include <sched.h>
 #include <errno.h>
 #include <string.h>
 
@@ -240,6 +241,30 @@ thread_sleep(
 }
 
 
+bool
+thread_set_affinity(
+	thread_t thread,
+	uint32_t cpu
+	)
+{
+#ifdef __linux__
+	assert_lt(cpu, CPU_SETSIZE);
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+
+	return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+#else
+	/* Pinning is only a hint, elsewhere the scheduler decides */
+	(void) thread;
+	(void) cpu;
+
+	return false;
+#endif
+}
+
+
 private void
 threads_resize(
 	threads_t* threads,
@@ -19,6 +19,8 @@
 #include <shared/threads.h>
 #include <shared/alloc_ext.h>
 
+#include <time.h>
+#include <errno.h>
 #include <stdatomic.h>
 
 
@@ -143,6 +145,106 @@ time_get(
 }
 
 
+uint64_t
+time_get_monotonic(
+	void
+	)
+{
+	struct timespec time;
+	int status = clock_gettime(CLOCK_MONOTONIC, &time);
+	hard_assert_eq(status, 0);
+
+	return time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+
+void
+time_scheduler_init(
+	time_scheduler_t* scheduler,
+	uint64_t interval,
+	time_catch_up_t catch_up,
+	uint32_t max_catch_up,
+	uint64_t spin
+	)
+{
+	assert_not_null(scheduler);
+	assert_gt(interval, 0);
+	assert_lt(spin, interval);
+	assert_le(catch_up, TIME_CATCH_UP_BOUNDED);
+
+	scheduler->interval = interval;
+	scheduler->spin = spin;
+	scheduler->max_catch_up = catch_up == TIME_CATCH_UP_SKIP ? 0 : max_catch_up;
+	scheduler->catch_up = catch_up;
+
+	scheduler->next = time_get_monotonic() + interval;
+	scheduler->ticks = 0;
+	scheduler->overruns = 0;
+	scheduler->skipped = 0;
+}
+
+
+/*
+ * Deadlines advance by exactly one interval per tick, so a late wakeup
+ * doesn't shift every following tick. When the previous tick ran past
+ * the deadline, up to `max_catch_up` missed ticks run back to back and
+ * the rest are dropped. The last `spin` nanoseconds are busy-waited,
+ * since the kernel timer slack alone is often larger than that.
+ */
+uint64_t
+time_scheduler_wait(
+	time_scheduler_t* scheduler
+	)
+{
+	assert_not_null(scheduler);
+
+	uint64_t now = time_get_monotonic();
+
+	if(now < scheduler->next)
+	{
+		if(scheduler->next - now > scheduler->spin)
+		{
+			uint64_t wake = scheduler->next - scheduler->spin;
+
+			struct timespec time =
+			{
+				.tv_sec = wake / 1000000000,
+				.tv_nsec = wake % 1000000000
+			};
+
+			while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &time, NULL) == EINTR);
+		}
+
+		do
+		{
+			now = time_get_monotonic();
+		}
+		while(now < scheduler->next);
+	}
+	else
+	{
+		uint64_t behind = (now - scheduler->next) / scheduler->interval;
+
+		if(behind > scheduler->max_catch_up)
+		{
+			uint64_t skip = behind - scheduler->max_catch_up;
+
+			scheduler->skipped += skip;
+			scheduler->next += skip * scheduler->interval;
+		}
+
+		scheduler->overruns += now > scheduler->next;
+	}
+
+	uint64_t jitter = now - scheduler->next;
+
+	scheduler->next += scheduler->interval;
+	++scheduler->ticks;
+
+	return jitter;
+}
+
+
 uint64_t
 time_get_with_sec(
 	uint64_t sec
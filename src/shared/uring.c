@@ -0,0 +1,591 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/debug.h>
+#include <shared/uring.h>
+#include <shared/alloc_ext.h>
+
+#if __has_include(<linux/io_uring.h>)
+	#define URING_SUPPORTED
+
+	#include <linux/io_uring.h>
+
+	#include <errno.h>
+	#include <string.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/socket.h>
+	#include <sys/syscall.h>
+#endif
+
+#define URING_BUF_GROUP 0
+
+
+#ifdef URING_SUPPORTED
+	private int
+	uring_setup(
+		uint32_t entries,
+		struct io_uring_params* params
+		)
+	{
+		return syscall(__NR_io_uring_setup, entries, params);
+	}
+
+
+	private int
+	uring_enter(
+		int fd,
+		uint32_t to_submit,
+		uint32_t min_complete,
+		uint32_t flags
+		)
+	{
+		return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+	}
+
+
+	private int
+	uring_register(
+		int fd,
+		uint32_t opcode,
+		void* arg,
+		uint32_t nr_args
+		)
+	{
+		return syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+	}
+
+
+	private void
+	uring_unmap(
+		uring_t* uring
+		)
+	{
+		if(uring->buf_ring)
+		{
+			(void) munmap(uring->buf_ring, uring->buf_ring_size);
+		}
+
+		if(uring->sqes)
+		{
+			(void) munmap(uring->sqes, uring->sqes_size);
+		}
+
+		if(uring->ring)
+		{
+			(void) munmap(uring->ring, uring->ring_size);
+		}
+
+		if(uring->bufs)
+		{
+			alloc_free(uring->bufs, (alloc_t) uring->buf_count * uring->buf_size);
+		}
+
+		if(uring->fd != -1)
+		{
+			(void) close(uring->fd);
+		}
+	}
+
+
+	private void
+	uring_add_buf(
+		uring_t* uring,
+		uint16_t buf_id,
+		uint32_t offset
+		)
+	{
+		struct io_uring_buf_ring* buf_ring = uring->buf_ring;
+		uint16_t tail = buf_ring->tail;
+
+		struct io_uring_buf* buf = buf_ring->bufs + ((tail + offset) & (uring->buf_count - 1));
+		buf->addr = (uintptr_t) (uring->bufs + (alloc_t) buf_id * uring->buf_size);
+		buf->len = uring->buf_size;
+		buf->bid = buf_id;
+	}
+
+
+	private void
+	uring_advance_bufs(
+		uring_t* uring,
+		uint16_t count
+		)
+	{
+		struct io_uring_buf_ring* buf_ring = uring->buf_ring;
+
+		__atomic_store_n(&buf_ring->tail, (uint16_t)(buf_ring->tail + count), __ATOMIC_RELEASE);
+	}
+
+
+	bool
+	uring_init(
+		uring_t* uring,
+		uint32_t entries,
+		uint32_t buf_count,
+		uint32_t buf_size
+		)
+	{
+		assert_not_null(uring);
+		assert_gt(entries, 0);
+		assert_gt(buf_count, 0);
+		assert_le(buf_count, 32768);
+		assert_true(MACRO_IS_POWER_OF_2(buf_count));
+		assert_gt(buf_size, 0);
+
+		*uring = (uring_t){ .fd = -1 };
+
+		struct io_uring_params params = {0};
+		params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN;
+
+		uring->fd = uring_setup(entries, &params);
+
+		if(uring->fd == -1 && errno == EINVAL)
+		{
+			params = (struct io_uring_params){0};
+			uring->fd = uring_setup(entries, &params);
+		}
+
+		if(uring->fd == -1 || !(params.features & IORING_FEAT_SINGLE_MMAP))
+		{
+			uring_unmap(uring);
+			return false;
+		}
+
+		uring->ring_size = MACRO_MAX(
+			params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+			params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe)
+			);
+		uring->ring = mmap(NULL, uring->ring_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQ_RING);
+
+		if(uring->ring == MAP_FAILED)
+		{
+			uring->ring = NULL;
+			uring_unmap(uring);
+			return false;
+		}
+
+		uring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+		uring->sqes = mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES);
+
+		if(uring->sqes == MAP_FAILED)
+		{
+			uring->sqes = NULL;
+			uring_unmap(uring);
+			return false;
+		}
+
+		uint8_t* ring = uring->ring;
+
+		uring->sq_head = (void*) (ring + params.sq_off.head);
+		uring->sq_tail = (void*) (ring + params.sq_off.tail);
+		uring->sq_mask = *(uint32_t*) (ring + params.sq_off.ring_mask);
+
+		uint32_t* sq_array = (void*) (ring + params.sq_off.array);
+
+		for(uint32_t i = 0; i < params.sq_entries; ++i)
+		{
+			sq_array[i] = i;
+		}
+
+		uring->cq_head = (void*) (ring + params.cq_off.head);
+		uring->cq_tail = (void*) (ring + params.cq_off.tail);
+		uring->cq_mask = *(uint32_t*) (ring + params.cq_off.ring_mask);
+		uring->cqes = ring + params.cq_off.cqes;
+
+		uring->buf_count = buf_count;
+		uring->buf_size = buf_size;
+
+		uring->bufs = alloc_malloc(uring->bufs, (alloc_t) buf_count * buf_size);
+		assert_not_null(uring->bufs);
+
+		uring->buf_ring_size = buf_count * sizeof(struct io_uring_buf);
+		uring->buf_ring = mmap(NULL, uring->buf_ring_size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if(uring->buf_ring == MAP_FAILED)
+		{
+			uring->buf_ring = NULL;
+			uring_unmap(uring);
+			return false;
+		}
+
+		struct io_uring_buf_reg reg =
+		{
+			.ring_addr = (uintptr_t) uring->buf_ring,
+			.ring_entries = buf_count,
+			.bgid = URING_BUF_GROUP
+		};
+
+		if(uring_register(uring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) == -1)
+		{
+			uring_unmap(uring);
+			return false;
+		}
+
+		for(uint32_t i = 0; i < buf_count; ++i)
+		{
+			uring_add_buf(uring, i, i);
+		}
+
+		uring_advance_bufs(uring, buf_count);
+
+		return true;
+	}
+
+
+	void
+	uring_free(
+		uring_t* uring
+		)
+	{
+		assert_not_null(uring);
+
+		uring_unmap(uring);
+	}
+
+
+	private struct io_uring_sqe*
+	uring_get_sqe(
+		uring_t* uring
+		)
+	{
+		uint32_t head = __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE);
+		uint32_t tail = *uring->sq_tail;
+
+		if(tail - head > uring->sq_mask)
+		{
+			(void) uring_submit(uring, 0);
+
+			head = __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE);
+
+			if(tail - head > uring->sq_mask)
+			{
+				return NULL;
+			}
+		}
+
+		struct io_uring_sqe* sqe = (struct io_uring_sqe*) uring->sqes + (tail & uring->sq_mask);
+		(void) memset(sqe, 0, sizeof(*sqe));
+
+		return sqe;
+	}
+
+
+	private void
+	uring_push_sqe(
+		uring_t* uring
+		)
+	{
+		__atomic_store_n(uring->sq_tail, *uring->sq_tail + 1, __ATOMIC_RELEASE);
+		++uring->sq_pending;
+	}
+
+
+	bool
+	uring_accept_multishot(
+		uring_t* uring,
+		int fd,
+		uint64_t user_data
+		)
+	{
+		assert_not_null(uring);
+
+		struct io_uring_sqe* sqe = uring_get_sqe(uring);
+		if(!sqe)
+		{
+			return false;
+		}
+
+		sqe->opcode = IORING_OP_ACCEPT;
+		sqe->fd = fd;
+		sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+		sqe->accept_flags = SOCK_NONBLOCK;
+		sqe->user_data = user_data;
+
+		uring_push_sqe(uring);
+
+		return true;
+	}
+
+
+	bool
+	uring_recv_multishot(
+		uring_t* uring,
+		int fd,
+		uint64_t user_data
+		)
+	{
+		assert_not_null(uring);
+
+		struct io_uring_sqe* sqe = uring_get_sqe(uring);
+		if(!sqe)
+		{
+			return false;
+		}
+
+		sqe->opcode = IORING_OP_RECV;
+		sqe->fd = fd;
+		sqe->ioprio = IORING_RECV_MULTISHOT;
+		sqe->flags = IOSQE_BUFFER_SELECT;
+		sqe->buf_group = URING_BUF_GROUP;
+		sqe->user_data = user_data;
+
+		uring_push_sqe(uring);
+
+		return true;
+	}
+
+
+	bool
+	uring_send(
+		uring_t* uring,
+		int fd,
+		const void* data,
+		uint32_t len,
+		uint64_t user_data
+		)
+	{
+		assert_not_null(uring);
+		assert_ptr(data, len);
+
+		struct io_uring_sqe* sqe = uring_get_sqe(uring);
+		if(!sqe)
+		{
+			return false;
+		}
+
+		sqe->opcode = IORING_OP_SEND;
+		sqe->fd = fd;
+		sqe->addr = (uintptr_t) data;
+		sqe->len = len;
+		sqe->msg_flags = MSG_NOSIGNAL;
+		sqe->user_data = user_data;
+
+		uring_push_sqe(uring);
+
+		return true;
+	}
+
+
+	bool
+	uring_cancel(
+		uring_t* uring,
+		uint64_t target_user_data,
+		uint64_t user_data
+		)
+	{
+		assert_not_null(uring);
+
+		struct io_uring_sqe* sqe = uring_get_sqe(uring);
+		if(!sqe)
+		{
+			return false;
+		}
+
+		sqe->opcode = IORING_OP_ASYNC_CANCEL;
+		sqe->fd = -1;
+		sqe->addr = target_user_data;
+		sqe->user_data = user_data;
+
+		uring_push_sqe(uring);
+
+		return true;
+	}
+
+
+	uint32_t
+	uring_submit(
+		uring_t* uring,
+		uint32_t wait
+		)
+	{
+		assert_not_null(uring);
+
+		if(!uring->sq_pending && !wait)
+		{
+			return 0;
+		}
+
+		int submitted = uring_enter(uring->fd, uring->sq_pending, wait,
+			wait ? IORING_ENTER_GETEVENTS : 0);
+
+		if(submitted == -1)
+		{
+			assert_true(errno == EINTR || errno == EAGAIN || errno == EBUSY);
+
+			return 0;
+		}
+
+		uring->sq_pending -= submitted;
+
+		return submitted;
+	}
+
+
+	bool
+	uring_next_event(
+		uring_t* uring,
+		uring_event_t* event
+		)
+	{
+		assert_not_null(uring);
+		assert_not_null(event);
+
+		uint32_t head = *uring->cq_head;
+		uint32_t tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+
+		if(head == tail)
+		{
+			return false;
+		}
+
+		struct io_uring_cqe* cqe = (struct io_uring_cqe*) uring->cqes + (head & uring->cq_mask);
+
+		event->user_data = cqe->user_data;
+		event->res = cqe->res;
+		event->more = !!(cqe->flags & IORING_CQE_F_MORE);
+
+		if(cqe->flags & IORING_CQE_F_BUFFER)
+		{
+			event->buf_id = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+			event->buf = uring->bufs + (alloc_t) event->buf_id * uring->buf_size;
+		}
+		else
+		{
+			event->buf_id = 0;
+			event->buf = NULL;
+		}
+
+		__atomic_store_n(uring->cq_head, head + 1, __ATOMIC_RELEASE);
+
+		return true;
+	}
+
+
+	void
+	uring_return_buf(
+		uring_t* uring,
+		uint16_t buf_id
+		)
+	{
+		assert_not_null(uring);
+		assert_lt(buf_id, uring->buf_count);
+
+		uring_add_buf(uring, buf_id, 0);
+		uring_advance_bufs(uring, 1);
+	}
+#else
+	bool
+	uring_init(
+		uring_t* uring,
+		uint32_t entries,
+		uint32_t buf_count,
+		uint32_t buf_size
+		)
+	{
+		assert_not_null(uring);
+
+		return false;
+	}
+
+
+	void
+	uring_free(
+		uring_t* uring
+		)
+	{
+		assert_unreachable();
+	}
+
+
+	bool
+	uring_accept_multishot(
+		uring_t* uring,
+		int fd,
+		uint64_t user_data
+		)
+	{
+		assert_unreachable();
+	}
+
+
+	bool
+	uring_recv_multishot(
+		uring_t* uring,
+		int fd,
+		uint64_t user_data
+		)
+	{
+		assert_unreachable();
+	}
+
+
+	bool
+	uring_send(
+		uring_t* uring,
+		int fd,
+		const void* data,
+		uint32_t len,
+		uint64_t user_data
+		)
+	{
+		assert_unreachable();
+	}
+
+
+	bool
+	uring_cancel(
+		uring_t* uring,
+		uint64_t target_user_data,
+		uint64_t user_data
+		)
+	{
+		assert_unreachable();
+	}
+
+
+	uint32_t
+	uring_submit(
+		uring_t* uring,
+		uint32_t wait
+		)
+	{
+		assert_unreachable();
+	}
+
+
+	bool
+	uring_next_event(
+		uring_t* uring,
+		uring_event_t* event
+		)
+	{
+		assert_unreachable();
+	}
+
+
+	void
+	uring_return_buf(
+		uring_t* uring,
+		uint16_t buf_id
+		)
+	{
+		assert_unreachable();
+	}
+#endif
@@ -769,3 +769,30 @@ test_normal_pass__alloc_custom_handle_fill_block(
 
 	alloc_free_handle(&handle);
 }
+
+
+void assert_used
+test_normal_pass__alloc_call_count(
+	void
+	)
+{
+	alloc_t count = alloc_get_call_count();
+
+	uint32_t* ptr = alloc_malloc(ptr, 16);
+	assert_not_null(ptr);
+	assert_gt(alloc_get_call_count(), count);
+
+	count = alloc_get_call_count();
+
+	ptr = alloc_remalloc(ptr, 16, 32);
+	assert_not_null(ptr);
+	assert_gt(alloc_get_call_count(), count);
+
+	count = alloc_get_call_count();
+
+	alloc_free(ptr, 32);
+	assert_gt(alloc_get_call_count(), count);
+
+	count = alloc_get_call_count();
+	assert_eq(alloc_get_call_count(), count);
+}
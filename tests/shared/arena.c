@@ -0,0 +1,176 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/debug.h>
+#include <shared/arena.h>
+
+#include <string.h>
+
+
+void assert_used
+test_normal_pass__arena_init_free(
+	void
+	)
+{
+	arena_t arena;
+	arena_init(&arena, 64);
+
+	assert_eq(arena.used, 0);
+	assert_eq(arena.size, 64);
+	assert_eq(arena_available(&arena), 64);
+
+	arena_free(&arena);
+}
+
+
+void assert_used
+test_normal_pass__arena_alloc_alignment(
+	void
+	)
+{
+	arena_t arena;
+	arena_init(&arena, 256);
+
+	uint8_t* a = arena_alloc(&arena, 1, 1);
+	assert_not_null(a);
+
+	uint64_t* b = arena_alloc_arr(&arena, b, 4);
+	assert_not_null(b);
+	assert_eq((uintptr_t) b & (_Alignof(uint64_t) - 1), 0);
+	assert_gt((uint8_t*) b, a);
+
+	uint8_t* c = arena_alloc(&arena, 3, 64);
+	assert_eq((uintptr_t) c & 63, 0);
+	assert_ge(c, (uint8_t*) (b + 4));
+
+	arena_free(&arena);
+}
+
+
+void assert_used
+test_normal_pass__arena_alloc_exhausted(
+	void
+	)
+{
+	arena_t arena;
+	arena_init(&arena, 32);
+
+	bool status;
+
+	void* ptr = arena_alloc_safe(&arena, 32, 1, &status);
+	assert_true(status);
+	assert_not_null(ptr);
+	assert_eq(arena_available(&arena), 0);
+
+	ptr = arena_alloc_safe(&arena, 1, 1, &status);
+	assert_false(status);
+	assert_null(ptr);
+	assert_eq(arena.used, 32);
+
+	arena_free(&arena);
+}
+
+
+void assert_used
+test_normal_fail__arena_alloc_overflow(
+	void
+	)
+{
+	arena_t arena;
+	arena_init(&arena, 32);
+
+	(void) arena_alloc(&arena, 33, 1);
+}
+
+
+void assert_used
+test_normal_pass__arena_calloc_zeroes(
+	void
+	)
+{
+	arena_t arena;
+	arena_init(&arena, 64);
+
+	uint8_t* ptr = arena_alloc(&arena, 64, 1);
+	(void) memset(ptr, 0xFF, 64);
+
+	arena_reset(&arena);
+
+	uint32_t* arr = arena_calloc_arr(&arena, arr, 16);
+	assert_eq((void*) arr, (void*) ptr);
+
+	for(int i = 0; i < 16; ++i)
+	{
+		assert_eq(arr[i], 0);
+	}
+
+	arena_free(&arena);
+}
+
+
+void assert_used
+test_normal_pass__arena_save_restore(
+	void
+	)
+{
+	arena_t arena;
+	arena_init(&arena, 128);
+
+	(void) arena_alloc(&arena, 16, 1);
+
+	arena_ctx_t ctx = arena_save(&arena);
+
+	void* first = arena_alloc(&arena, 32, 1);
+	arena_restore(&arena, &ctx);
+	assert_eq(arena.used, 16);
+
+	void* second = arena_alloc(&arena, 32, 1);
+	assert_eq(first, second);
+	assert_eq(arena.peak, 48);
+
+	arena_reset(&arena);
+	assert_eq(arena.used, 0);
+	assert_eq(arena.peak, 48);
+
+	arena_free(&arena);
+}
+
+
+void assert_used
+test_normal_pass__arena_steady_state_no_allocs(
+	void
+	)
+{
+	arena_t arena;
+	arena_init(&arena, 4096);
+
+	alloc_t count = alloc_get_call_count();
+
+	for(int tick = 0; tick < 100; ++tick)
+	{
+		arena_reset(&arena);
+
+		for(int i = 0; i < 16; ++i)
+		{
+			assert_not_null(arena_alloc(&arena, 200, 8));
+		}
+	}
+
+	assert_eq(alloc_get_call_count(), count);
+
+	arena_free(&arena);
+}
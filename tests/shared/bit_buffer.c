@@ -205,6 +205,68 @@ test_normal_pass__bit_buffer_set_get_bits(
 }
 
 
+void assert_used
+test_normal_pass__bit_buffer_set_get_bits_word_boundaries(
+	void
+	)
+{
+	const uint64_t num = 0xFEDCBA9876543210;
+
+	/* Ends both inside a whole word and past the last one */
+	for(uint64_t len = 9; len <= 16; len += 7)
+	for(uint64_t offset = 0; offset < 8; ++offset)
+	for(uint64_t bits = 1; bits <= 64; ++bits)
+	{
+		uint8_t data[16] = {0};
+		uint8_t expected[16] = {0};
+
+		for(uint64_t i = 0; i < bits; ++i)
+		{
+			uint64_t bit = offset + i;
+
+			if((num >> (bits - 1 - i)) & 1)
+			{
+				expected[bit >> 3] |= 0x80 >> (bit & 7);
+			}
+		}
+
+		bit_buffer_t buffer;
+		bit_buffer_set(&buffer, data, len);
+
+		bit_buffer_skip_bits(&buffer, offset);
+		bit_buffer_set_bits(&buffer, num, bits);
+
+		assert_eq(bit_buffer_consumed_bits(&buffer), offset + bits);
+		assert_false(memcmp(data, expected, sizeof(data)));
+
+		bit_buffer_reset(&buffer);
+		bit_buffer_skip_bits(&buffer, offset);
+
+		assert_eq(bit_buffer_get_bits(&buffer, bits), num & (UINT64_MAX >> (64 - bits)));
+		assert_eq(bit_buffer_consumed_bits(&buffer), offset + bits);
+	}
+
+	/* Patching a field behind later ones must leave them be */
+	uint8_t data[16] = {0};
+	bit_buffer_t buffer;
+	bit_buffer_set(&buffer, data, sizeof(data));
+
+	bit_buffer_set_bits(&buffer, 1, 3);
+	bit_buffer_ctx_t ctx = bit_buffer_save(&buffer);
+	bit_buffer_skip_bits(&buffer, 12);
+	bit_buffer_set_bits(&buffer, num, 64);
+
+	bit_buffer_restore(&buffer, &ctx);
+	bit_buffer_set_bits(&buffer, 0xABC, 12);
+
+	bit_buffer_reset(&buffer);
+
+	assert_eq(bit_buffer_get_bits(&buffer, 3), 1);
+	assert_eq(bit_buffer_get_bits(&buffer, 12), 0xABC);
+	assert_eq(bit_buffer_get_bits(&buffer, 64), num);
+}
+
+
 void assert_used
 test_normal_pass__bit_buffer_set_get_float(
 	void
@@ -931,3 +993,428 @@ test_normal_fail__bit_buffer_get_str_safe_null(
 	bit_buffer_get_str_safe(NULL, 0, NULL);
 }
 
+
+
+void assert_used
+test_normal_pass__bit_buffer_copy_bits_offsets(
+	void
+	)
+{
+	uint8_t src_data[32];
+	for(uint32_t i = 0; i < sizeof(src_data); ++i)
+	{
+		src_data[i] = i * 37 + 11;
+	}
+
+	for(uint64_t src_off = 0; src_off < 8; ++src_off)
+	{
+		for(uint64_t dst_off = 0; dst_off < 8; ++dst_off)
+		{
+			for(uint64_t bits = 0; bits <= 150; bits += 7)
+			{
+				bit_buffer_t src;
+				bit_buffer_set(&src, src_data, sizeof(src_data));
+				bit_buffer_skip_bits(&src, src_off);
+
+				uint8_t dst_data[40] = {0};
+				bit_buffer_t dst;
+				bit_buffer_set(&dst, dst_data, sizeof(dst_data));
+				bit_buffer_skip_bits(&dst, dst_off);
+
+				bit_buffer_copy_bits(&dst, &src, bits);
+
+				assert_eq(bit_buffer_consumed_bits(&src), src_off + bits);
+				assert_eq(bit_buffer_consumed_bits(&dst), dst_off + bits);
+
+				bit_buffer_set(&src, src_data, sizeof(src_data));
+				bit_buffer_skip_bits(&src, src_off);
+
+				bit_buffer_reset(&dst);
+
+				for(uint64_t i = 0; i < dst_off; ++i)
+				{
+					assert_eq(bit_buffer_get_bits(&dst, 1), 0);
+				}
+
+				for(uint64_t i = 0; i < bits; ++i)
+				{
+					assert_eq(bit_buffer_get_bits(&dst, 1), bit_buffer_get_bits(&src, 1));
+				}
+
+				while(bit_buffer_available_bits(&dst))
+				{
+					assert_eq(bit_buffer_get_bits(&dst, 1), 0);
+				}
+			}
+		}
+	}
+}
+
+
+void assert_used
+test_normal_pass__bit_buffer_copy_bits_safe(
+	void
+	)
+{
+	bool status;
+
+	uint8_t src_data[2] = { 0xAB, 0xCD };
+	bit_buffer_t src;
+	bit_buffer_set(&src, src_data, sizeof(src_data));
+
+	uint8_t dst_data[4] = {0};
+	bit_buffer_t dst;
+	bit_buffer_set(&dst, dst_data, sizeof(dst_data));
+	bit_buffer_skip_bits(&dst, 4);
+
+	bit_buffer_copy_bits_safe(&dst, &src, 12, &status);
+	assert_true(status);
+	assert_eq(dst_data[0], 0x0A);
+	assert_eq(dst_data[1], 0xBC);
+
+	bit_buffer_copy_bits_safe(&dst, &src, 5, &status);
+	assert_false(status);
+	assert_eq(bit_buffer_consumed_bits(&src), 12);
+
+	bit_buffer_copy_bits_safe(&dst, &src, 4, &status);
+	assert_true(status);
+	assert_eq(dst_data[2], 0xD0);
+}
+
+
+void assert_used
+test_normal_pass__bit_buffer_patch_after_skip_and_copy(
+	void
+	)
+{
+	uint8_t src_data[16];
+	(void) memset(src_data, 0xFF, sizeof(src_data));
+
+	bit_buffer_t src;
+	bit_buffer_set(&src, src_data, sizeof(src_data));
+
+	/* A header patched in after the payload was copied in bulk */
+	uint8_t dst_data[32] = {0};
+	bit_buffer_t dst;
+	bit_buffer_set(&dst, dst_data, sizeof(dst_data));
+
+	bit_buffer_ctx_t ctx = bit_buffer_save(&dst);
+	bit_buffer_skip_bits(&dst, 16);
+	bit_buffer_copy_bits(&dst, &src, 128);
+
+	bit_buffer_restore(&dst, &ctx);
+	bit_buffer_set_bits(&dst, 0x1234, 16);
+
+	assert_eq(dst_data[0], 0x12);
+	assert_eq(dst_data[1], 0x34);
+
+	for(uint32_t i = 2; i < 18; ++i)
+	{
+		assert_eq(dst_data[i], 0xFF);
+	}
+
+	/* Bytes that were only skipped over keep their contents too */
+	(void) memset(dst_data, 0, sizeof(dst_data));
+	(void) memset(dst_data + 1, 0xEE, 8);
+	bit_buffer_set(&dst, dst_data, sizeof(dst_data));
+
+	ctx = bit_buffer_save(&dst);
+	bit_buffer_skip_bytes(&dst, 9);
+
+	bit_buffer_restore(&dst, &ctx);
+	bit_buffer_set_bits(&dst, 0x5, 4);
+
+	assert_eq(dst_data[0], 0x50);
+
+	for(uint32_t i = 1; i < 9; ++i)
+	{
+		assert_eq(dst_data[i], 0xEE);
+	}
+}
+
+
+void assert_used
+test_normal_fail__bit_buffer_copy_bits_null_src(
+	void
+	)
+{
+	bit_buffer_t bit_buffer;
+	bit_buffer_copy_bits(&bit_buffer, NULL, 0);
+}
+
+
+void assert_used
+test_normal_fail__bit_buffer_copy_bits_safe_null_status(
+	void
+	)
+{
+	bit_buffer_t bit_buffer;
+	bit_buffer_t src;
+	bit_buffer_copy_bits_safe(&bit_buffer, &src, 0, NULL);
+}
+
+
+private uint32_t
+test_bit_buffer_random(
+	uint32_t* seed
+	)
+{
+	*seed = *seed * 1664525 + 1013904223;
+	return *seed;
+}
+
+
+void assert_used
+test_normal_pass__bit_buffer_set_get_arrays(
+	void
+	)
+{
+	/* Past one chunk, with the buffer ending right where the fields do */
+	const uint32_t counts[] = { 0, 1, 5, 300 };
+	uint32_t seed = 1;
+
+	for(uint32_t c = 0; c < MACRO_ARRAY_LEN(counts); ++c)
+	for(uint64_t offset = 0; offset < 8; offset += 3)
+	for(uint64_t bits = 0; bits <= 32; ++bits)
+	{
+		uint32_t count = counts[c];
+
+		uint32_t values[300];
+		int32_t signed_values[300];
+		float floats[300];
+
+		uint32_t got[300];
+		int32_t got_signed[300];
+		float got_floats[300];
+
+		uint64_t integer_bits = bits / 3;
+		uint64_t fraction_bits = MACRO_MIN(bits - integer_bits, 23);
+		if(integer_bits + fraction_bits > 30)
+		{
+			--integer_bits;
+		}
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			values[i] = test_bit_buffer_random(&seed);
+			signed_values[i] = bits ? (int32_t) test_bit_buffer_random(&seed) >> (32 - MACRO_MIN(bits, 31)) : 0;
+			floats[i] = ((int32_t) test_bit_buffer_random(&seed) >> 8) / 65536.0f;
+		}
+
+		floats[0] = -0.0f;
+
+		uint64_t total =
+			bit_buffer_len_bits_array(count, bits) +
+			bit_buffer_len_signed_bits_array(count, MACRO_MIN(bits, 31)) +
+			bit_buffer_len_fixed_point_array(count, integer_bits, fraction_bits) +
+			bit_buffer_len_signed_fixed_point_array(count, integer_bits, fraction_bits);
+		uint64_t len = MACRO_TO_BYTES(offset + total);
+
+		uint8_t expected[5120] = {0};
+		uint8_t data[5120] = {0};
+
+		bit_buffer_t buffer;
+		bit_buffer_set(&buffer, expected, len);
+		bit_buffer_skip_bits(&buffer, offset);
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			bit_buffer_set_bits(&buffer, values[i], bits);
+		}
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			bit_buffer_set_signed_bits(&buffer, signed_values[i], MACRO_MIN(bits, 31));
+		}
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			bit_buffer_set_fixed_point(&buffer, floats[i], integer_bits, fraction_bits);
+		}
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			bit_buffer_set_signed_fixed_point(&buffer, floats[i], integer_bits, fraction_bits);
+		}
+
+		assert_eq(bit_buffer_consumed_bits(&buffer), offset + total);
+
+		bit_buffer_set(&buffer, data, len);
+		bit_buffer_skip_bits(&buffer, offset);
+
+		bit_buffer_set_bits_array(&buffer, values, count, bits);
+		bit_buffer_set_signed_bits_array(&buffer, signed_values, count, MACRO_MIN(bits, 31));
+		bit_buffer_set_fixed_point_array(&buffer, floats, count, integer_bits, fraction_bits);
+		bit_buffer_set_signed_fixed_point_array(&buffer, floats, count, integer_bits, fraction_bits);
+
+		assert_eq(bit_buffer_consumed_bits(&buffer), offset + total);
+		assert_false(memcmp(data, expected, sizeof(data)));
+
+		bit_buffer_reset(&buffer);
+		bit_buffer_skip_bits(&buffer, offset);
+
+		bit_buffer_t scalar;
+		bit_buffer_set(&scalar, data, len);
+		bit_buffer_skip_bits(&scalar, offset);
+
+		bool status;
+		bit_buffer_get_bits_array_safe(&buffer, got, count, bits, &status);
+		assert_true(status);
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			assert_eq(got[i], bit_buffer_get_bits(&scalar, bits));
+		}
+
+		bit_buffer_get_signed_bits_array(&buffer, got_signed, count, MACRO_MIN(bits, 31));
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			assert_eq(got_signed[i], signed_values[i]);
+			assert_eq(got_signed[i], bit_buffer_get_signed_bits(&scalar, MACRO_MIN(bits, 31)));
+		}
+
+		bit_buffer_get_fixed_point_array(&buffer, got_floats, count, integer_bits, fraction_bits);
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			float value = bit_buffer_get_fixed_point(&scalar, integer_bits, fraction_bits);
+			assert_false(memcmp(&got_floats[i], &value, sizeof(value)));
+		}
+
+		bit_buffer_get_signed_fixed_point_array_safe(&buffer, got_floats, count,
+			integer_bits, fraction_bits, &status);
+		assert_true(status);
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			float value = bit_buffer_get_signed_fixed_point(&scalar, integer_bits, fraction_bits);
+			assert_false(memcmp(&got_floats[i], &value, sizeof(value)));
+		}
+
+		assert_eq(bit_buffer_consumed_bits(&buffer), offset + total);
+		assert_eq(bit_buffer_consumed_bits(&scalar), offset + total);
+	}
+}
+
+
+void assert_used
+test_normal_pass__bit_buffer_set_get_arrays_patch(
+	void
+	)
+{
+	const uint32_t values[] = { 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA };
+
+	uint8_t data[16] = {0};
+	bit_buffer_t buffer;
+	bit_buffer_set(&buffer, data, sizeof(data));
+
+	bit_buffer_set_bits(&buffer, 1, 3);
+	bit_buffer_ctx_t ctx = bit_buffer_save(&buffer);
+	bit_buffer_skip_bits(&buffer, 40);
+	bit_buffer_set_bits(&buffer, 0xABCDEF, 24);
+
+	bit_buffer_restore(&buffer, &ctx);
+	bit_buffer_set_bits_array(&buffer, values, MACRO_ARRAY_LEN(values), 4);
+
+	bit_buffer_reset(&buffer);
+
+	uint32_t got[MACRO_ARRAY_LEN(values)];
+
+	assert_eq(bit_buffer_get_bits(&buffer, 3), 1);
+	bit_buffer_get_bits_array(&buffer, got, MACRO_ARRAY_LEN(got), 4);
+	assert_false(memcmp(got, values, sizeof(values)));
+	assert_eq(bit_buffer_get_bits(&buffer, 24), 0xABCDEF);
+
+	bool status;
+	bit_buffer_get_bits_array_safe(&buffer, got, 13, 5, &status);
+	assert_false(status);
+	assert_eq(bit_buffer_consumed_bits(&buffer), 67);
+
+	bit_buffer_get_signed_fixed_point_array_safe(&buffer, (float*) got, 3, 10, 10, &status);
+	assert_false(status);
+
+	bit_buffer_get_bits_array_safe(&buffer, got, 12, 5, &status);
+	assert_true(status);
+	assert_eq(bit_buffer_consumed_bits(&buffer), 127);
+}
+
+
+void assert_used
+test_normal_fail__bit_buffer_set_bits_array_null(
+	void
+	)
+{
+	uint32_t value = 0;
+	bit_buffer_set_bits_array(NULL, &value, 1, 1);
+}
+
+
+void assert_used
+test_normal_fail__bit_buffer_set_bits_array_too_wide(
+	void
+	)
+{
+	uint8_t data[8] = {0};
+	bit_buffer_t bit_buffer;
+	bit_buffer_set(&bit_buffer, data, sizeof(data));
+
+	uint32_t value = 0;
+	bit_buffer_set_bits_array(&bit_buffer, &value, 1, 33);
+}
+
+
+void assert_used
+test_normal_fail__bit_buffer_set_bits_array_overflow(
+	void
+	)
+{
+	uint8_t data[1] = {0};
+	bit_buffer_t bit_buffer;
+	bit_buffer_set(&bit_buffer, data, sizeof(data));
+
+	uint32_t values[2] = {0};
+	bit_buffer_set_bits_array(&bit_buffer, values, 2, 5);
+}
+
+
+void assert_used
+test_normal_fail__bit_buffer_get_bits_array_null(
+	void
+	)
+{
+	uint32_t value = 0;
+	bit_buffer_get_bits_array(NULL, &value, 1, 1);
+}
+
+
+void assert_used
+test_normal_fail__bit_buffer_get_bits_array_safe_null_status(
+	void
+	)
+{
+	bit_buffer_t bit_buffer;
+	uint32_t value = 0;
+	bit_buffer_get_bits_array_safe(&bit_buffer, &value, 1, 1, NULL);
+}
+
+
+void assert_used
+test_normal_fail__bit_buffer_set_fixed_point_array_null(
+	void
+	)
+{
+	float value = 0;
+	bit_buffer_set_fixed_point_array(NULL, &value, 1, 1, 1);
+}
+
+
+void assert_used
+test_normal_fail__bit_buffer_get_signed_fixed_point_array_safe_null_status(
+	void
+	)
+{
+	bit_buffer_t bit_buffer;
+	float value = 0;
+	bit_buffer_get_signed_fixed_point_array_safe(&bit_buffer, &value, 1, 1, 1, NULL);
+}
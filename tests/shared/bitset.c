@@ -0,0 +1,300 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+
+#include <shared/rand.h>
+#include <shared/debug.h>
+#include <shared/bitset.h>
+
+
+#define BITSET_TEST_BITS 1000
+
+
+void assert_used
+test_normal_pass__bitset_init_free(
+	void
+	)
+{
+	bitset_t set;
+	bitset_init(&set, BITSET_TEST_BITS);
+
+	assert_ge(set.word_count * BITSET_WORD_BITS, BITSET_TEST_BITS);
+	assert_eq(bitset_count(&set), 0);
+
+	bitset_free(&set);
+}
+
+
+void assert_used
+test_normal_fail__bitset_init_empty(
+	void
+	)
+{
+	bitset_t set;
+	bitset_init(&set, 0);
+}
+
+
+void assert_used
+test_normal_pass__bitset_set_get(
+	void
+	)
+{
+	bitset_t set;
+	bitset_init(&set, BITSET_TEST_BITS);
+
+	bitset_set(&set, 0);
+	bitset_set(&set, 63);
+	bitset_set(&set, 64);
+	bitset_set(&set, BITSET_TEST_BITS - 1);
+	bitset_set(&set, 64);
+
+	assert_true(bitset_get(&set, 0));
+	assert_false(bitset_get(&set, 1));
+	assert_true(bitset_get(&set, 63));
+	assert_true(bitset_get(&set, 64));
+	assert_true(bitset_get(&set, BITSET_TEST_BITS - 1));
+	assert_eq(bitset_count(&set), 4);
+
+	bitset_unset(&set, 63);
+
+	assert_false(bitset_get(&set, 63));
+	assert_eq(bitset_count(&set), 3);
+
+	bitset_clear(&set);
+
+	assert_eq(bitset_count(&set), 0);
+
+	bitset_free(&set);
+}
+
+
+void assert_used
+test_normal_pass__bitset_resize(
+	void
+	)
+{
+	bitset_t set;
+	bitset_init(&set, 100);
+
+	bitset_set(&set, 5);
+	bitset_set(&set, 99);
+
+	bitset_resize(&set, BITSET_TEST_BITS);
+
+	assert_ge(set.word_count * BITSET_WORD_BITS, BITSET_TEST_BITS);
+	assert_true(bitset_get(&set, 5));
+	assert_true(bitset_get(&set, 99));
+	assert_eq(bitset_count(&set), 2);
+
+	bitset_set(&set, BITSET_TEST_BITS - 1);
+	bitset_resize(&set, 64);
+
+	assert_true(bitset_get(&set, 5));
+	assert_eq(bitset_count(&set), 1);
+
+	bitset_free(&set);
+}
+
+
+void assert_used
+test_normal_pass__bitset_ops(
+	void
+	)
+{
+	bitset_t a;
+	bitset_t b;
+	bitset_t dst;
+	bitset_init(&a, BITSET_TEST_BITS);
+	bitset_init(&b, BITSET_TEST_BITS);
+	bitset_init(&dst, BITSET_TEST_BITS);
+
+	for(uint32_t i = 0; i < BITSET_TEST_BITS; ++i)
+	{
+		if(i % 2 == 0)
+		{
+			bitset_set(&a, i);
+		}
+
+		if(i % 3 == 0)
+		{
+			bitset_set(&b, i);
+		}
+	}
+
+	bitset_and(&dst, &a, &b);
+
+	for(uint32_t i = 0; i < BITSET_TEST_BITS; ++i)
+	{
+		assert_eq(bitset_get(&dst, i), i % 6 == 0);
+	}
+
+	bitset_andnot(&dst, &a, &b);
+
+	for(uint32_t i = 0; i < BITSET_TEST_BITS; ++i)
+	{
+		assert_eq(bitset_get(&dst, i), i % 2 == 0 && i % 3 != 0);
+	}
+
+	bitset_or(&dst, &a, &b);
+
+	for(uint32_t i = 0; i < BITSET_TEST_BITS; ++i)
+	{
+		assert_eq(bitset_get(&dst, i), i % 2 == 0 || i % 3 == 0);
+	}
+
+	bitset_free(&a);
+	bitset_free(&b);
+	bitset_free(&dst);
+}
+
+
+void assert_used
+test_normal_pass__bitset_next(
+	void
+	)
+{
+	bitset_t set;
+	bitset_init(&set, BITSET_TEST_BITS);
+
+	uint32_t bits[] = { 3, 64, 65, 511, 700, BITSET_TEST_BITS - 1 };
+
+	for(uint32_t i = 0; i < MACRO_ARRAY_LEN(bits); ++i)
+	{
+		bitset_set(&set, bits[i]);
+	}
+
+	uint32_t found = 0;
+
+	for(uint32_t bit = 0; bitset_next(&set, &bit); ++bit)
+	{
+		assert_lt(found, MACRO_ARRAY_LEN(bits));
+		assert_eq(bit, bits[found]);
+		++found;
+	}
+
+	assert_eq(found, MACRO_ARRAY_LEN(bits));
+
+	bitset_clear(&set);
+
+	uint32_t bit = 0;
+	assert_false(bitset_next(&set, &bit));
+
+	bitset_free(&set);
+}
+
+
+void assert_used
+test_normal_pass__bitset_diff(
+	void
+	)
+{
+	bitset_t old_set;
+	bitset_t new_set;
+	bitset_init(&old_set, BITSET_TEST_BITS);
+	bitset_init(&new_set, BITSET_TEST_BITS);
+
+	for(uint32_t i = 0; i < BITSET_TEST_BITS; ++i)
+	{
+		if(rand_u32() % 4 == 0)
+		{
+			bitset_set(&old_set, i);
+		}
+
+		if(rand_u32() % 4 == 0)
+		{
+			bitset_set(&new_set, i);
+		}
+	}
+
+	bitset_diff_iter_t iter;
+	bitset_diff_init(&iter, &old_set, &new_set);
+
+	uint32_t next = 0;
+	uint32_t bit;
+	bitset_change_t change;
+
+	while(bitset_diff_next(&iter, &bit, &change))
+	{
+		for(; next < bit; ++next)
+		{
+			assert_false(bitset_get(&old_set, next));
+			assert_false(bitset_get(&new_set, next));
+		}
+
+		bool was = bitset_get(&old_set, bit);
+		bool is = bitset_get(&new_set, bit);
+
+		switch(change)
+		{
+
+		case BITSET_CHANGE_ENTERED: assert_true(!was && is); break;
+		case BITSET_CHANGE_STAYED: assert_true(was && is); break;
+		case BITSET_CHANGE_LEFT: assert_true(was && !is); break;
+		default: assert_unreachable();
+
+		}
+
+		next = bit + 1;
+	}
+
+	for(; next < old_set.word_count * BITSET_WORD_BITS; ++next)
+	{
+		assert_false(bitset_get(&old_set, next));
+		assert_false(bitset_get(&new_set, next));
+	}
+
+	bitset_free(&old_set);
+	bitset_free(&new_set);
+}
+
+
+void assert_used
+test_normal_pass__bitset_diff_empty(
+	void
+	)
+{
+	bitset_t old_set;
+	bitset_t new_set;
+	bitset_init(&old_set, BITSET_TEST_BITS);
+	bitset_init(&new_set, BITSET_TEST_BITS);
+
+	bitset_diff_iter_t iter;
+	bitset_diff_init(&iter, &old_set, &new_set);
+
+	uint32_t bit;
+	bitset_change_t change;
+	assert_false(bitset_diff_next(&iter, &bit, &change));
+
+	bitset_free(&old_set);
+	bitset_free(&new_set);
+}
+
+
+void assert_used
+test_normal_fail__bitset_diff_mismatched(
+	void
+	)
+{
+	bitset_t old_set;
+	bitset_t new_set;
+	bitset_init(&old_set, 64);
+	bitset_init(&new_set, BITSET_TEST_BITS);
+
+	bitset_diff_iter_t iter;
+	bitset_diff_init(&iter, &old_set, &new_set);
+}
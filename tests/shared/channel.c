@@ -0,0 +1,358 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <shared/rand.h>
+#include <shared/debug.h>
+#include <shared/channel.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+
+void assert_used
+test_normal_pass__channel_seq_greater(
+	void
+	)
+{
+	assert_true(channel_seq_greater(1, 0));
+	assert_false(channel_seq_greater(0, 1));
+	assert_false(channel_seq_greater(5, 5));
+	assert_true(channel_seq_greater(0, UINT16_MAX));
+	assert_true(channel_seq_greater(10, UINT16_MAX - 10));
+	assert_false(channel_seq_greater(UINT16_MAX, 0));
+}
+
+
+private uint32_t
+channel_test_write(
+	channel_t* channel,
+	uint8_t* data,
+	uint32_t size,
+	uint32_t payload,
+	uint16_t* seq
+	)
+{
+	(void) memset(data, 0, size);
+
+	bit_buffer_t bit_buffer;
+	bit_buffer_set(&bit_buffer, data, size);
+
+	*seq = channel_write_header(channel, &bit_buffer, 512);
+	bit_buffer_set_bits(&bit_buffer, payload, 32);
+
+	return bit_buffer_consumed_bytes(&bit_buffer);
+}
+
+
+private void
+channel_test_read(
+	channel_t* channel,
+	uint8_t* data,
+	uint32_t len,
+	channel_packet_info_t* info,
+	uint32_t* payload
+	)
+{
+	bit_buffer_t bit_buffer;
+	bit_buffer_set(&bit_buffer, data, len);
+
+	bool status;
+	channel_read_header(channel, &bit_buffer, info, &status);
+	assert_true(status);
+
+	*payload = bit_buffer_get_bits_safe(&bit_buffer, 32, &status);
+	assert_true(status);
+}
+
+
+void assert_used
+test_normal_pass__channel_exchange(
+	void
+	)
+{
+	channel_t a;
+	channel_t b;
+	channel_init(&a);
+	channel_init(&b);
+
+	uint8_t data[CHANNEL_LINK_MTU];
+	uint16_t seq;
+	uint32_t payload;
+	channel_packet_info_t info;
+
+	uint32_t len = channel_test_write(&a, data, sizeof(data), 1234, &seq);
+	assert_eq(seq, 0);
+
+	channel_test_read(&b, data, len, &info, &payload);
+	assert_eq(info.seq, 0);
+	assert_true(info.fresh);
+	assert_false(info.duplicate);
+	assert_eq(payload, 1234);
+
+	channel_test_read(&b, data, len, &info, &payload);
+	assert_false(info.fresh);
+	assert_true(info.duplicate);
+
+	uint16_t acked;
+	assert_false(channel_last_acked(&a, &acked));
+	assert_false(channel_is_acked(&a, 0));
+
+	len = channel_test_write(&b, data, sizeof(data), 5678, &seq);
+	channel_test_read(&a, data, len, &info, &payload);
+	assert_eq(payload, 5678);
+
+	assert_true(channel_is_acked(&a, 0));
+	assert_true(channel_last_acked(&a, &acked));
+	assert_eq(acked, 0);
+}
+
+
+void assert_used
+test_normal_pass__channel_out_of_order(
+	void
+	)
+{
+	channel_t a;
+	channel_t b;
+	channel_init(&a);
+	channel_init(&b);
+
+	uint8_t data[3][CHANNEL_LINK_MTU];
+	uint32_t len[3];
+	uint16_t seq;
+	uint32_t payload;
+	channel_packet_info_t info;
+
+	for(uint32_t i = 0; i < 3; ++i)
+	{
+		len[i] = channel_test_write(&a, data[i], sizeof(data[i]), i, &seq);
+	}
+
+	channel_test_read(&b, data[2], len[2], &info, &payload);
+	assert_true(info.fresh);
+
+	channel_test_read(&b, data[0], len[0], &info, &payload);
+	assert_false(info.fresh);
+	assert_false(info.duplicate);
+
+	channel_test_read(&b, data[0], len[0], &info, &payload);
+	assert_true(info.duplicate);
+
+	uint8_t reply[CHANNEL_LINK_MTU];
+	uint32_t reply_len = channel_test_write(&b, reply, sizeof(reply), 0, &seq);
+	channel_test_read(&a, reply, reply_len, &info, &payload);
+
+	assert_true(channel_is_acked(&a, 0));
+	assert_false(channel_is_acked(&a, 1));
+	assert_true(channel_is_acked(&a, 2));
+}
+
+
+void assert_used
+test_normal_pass__channel_reliable_window_full(
+	void
+	)
+{
+	channel_t channel;
+	channel_init(&channel);
+
+	bool status;
+	uint8_t byte = 0;
+
+	for(uint32_t i = 0; i < CHANNEL_RELIABLE_WINDOW; ++i)
+	{
+		channel_send_reliable(&channel, &byte, 1, &status);
+		assert_true(status);
+	}
+
+	assert_eq(channel_reliable_pending(&channel), CHANNEL_RELIABLE_WINDOW);
+
+	channel_send_reliable(&channel, &byte, 1, &status);
+	assert_false(status);
+}
+
+
+void assert_used
+test_normal_pass__channel_truncated_header(
+	void
+	)
+{
+	channel_t channel;
+	channel_init(&channel);
+
+	uint8_t data[4] = {0};
+	bit_buffer_t bit_buffer;
+	bit_buffer_set(&bit_buffer, data, sizeof(data));
+
+	bool status;
+	channel_packet_info_t info;
+	channel_read_header(&channel, &bit_buffer, &info, &status);
+	assert_false(status);
+}
+
+
+private channel_link_t channel_test_link_ab;
+private channel_link_t channel_test_link_ba;
+
+
+void assert_used
+test_normal_pass__channel_lossy_link(
+	void
+	)
+{
+	rand_set_seed(1);
+
+	channel_t a;
+	channel_t b;
+	channel_init(&a);
+	channel_init(&b);
+
+	channel_link_init(&channel_test_link_ab, 0.3f, 50, 40);
+	channel_link_init(&channel_test_link_ba, 0.3f, 50, 40);
+
+	uint32_t sent = 0;
+	uint32_t received = 0;
+	uint32_t latest = 0;
+	bool latest_any = false;
+
+	uint8_t data[CHANNEL_LINK_MTU];
+	uint32_t len;
+	uint16_t seq;
+	uint32_t payload;
+	channel_packet_info_t info;
+
+	for(uint64_t now = 0; now < 20000; now += 10)
+	{
+		bool status = true;
+		while(sent < 300 && status)
+		{
+			channel_send_reliable(&a, &sent, sizeof(sent), &status);
+			sent += status;
+		}
+
+		len = channel_test_write(&a, data, sizeof(data), now, &seq);
+		channel_link_send(&channel_test_link_ab, now, data, len);
+
+		len = channel_test_write(&b, data, sizeof(data), now, &seq);
+		channel_link_send(&channel_test_link_ba, now, data, len);
+
+		while(channel_link_recv(&channel_test_link_ab, now, data, &len))
+		{
+			channel_test_read(&b, data, len, &info, &payload);
+
+			if(info.fresh)
+			{
+				assert_true(!latest_any || payload > latest);
+				latest = payload;
+				latest_any = true;
+			}
+		}
+
+		while(channel_link_recv(&channel_test_link_ba, now, data, &len))
+		{
+			channel_test_read(&a, data, len, &info, &payload);
+		}
+
+		uint32_t msg;
+		while(channel_recv_reliable(&b, &msg, &len))
+		{
+			assert_eq(len, sizeof(msg));
+			assert_eq(msg, received);
+			++received;
+		}
+	}
+
+	assert_eq(sent, 300);
+	assert_eq(received, 300);
+	assert_eq(channel_reliable_pending(&a), 0);
+
+	uint16_t acked;
+	assert_true(channel_last_acked(&a, &acked));
+	assert_true(channel_is_acked(&a, acked));
+}
+
+
+void assert_used
+test_normal_pass__channel_udp_loopback(
+	void
+	)
+{
+	int fds[2];
+	struct sockaddr_in addrs[2];
+
+	for(uint32_t i = 0; i < 2; ++i)
+	{
+		fds[i] = socket(AF_INET, SOCK_DGRAM, 0);
+		assert_neq(fds[i], -1);
+
+		addrs[i] =
+		(struct sockaddr_in)
+		{
+			.sin_family = AF_INET,
+			.sin_port = 0,
+			.sin_addr.s_addr = htonl(INADDR_LOOPBACK)
+		};
+
+		socklen_t addr_len = sizeof(addrs[i]);
+		assert_neq(bind(fds[i], (void*) &addrs[i], sizeof(addrs[i])), -1);
+		assert_neq(getsockname(fds[i], (void*) &addrs[i], &addr_len), -1);
+	}
+
+	channel_t a;
+	channel_t b;
+	channel_init(&a);
+	channel_init(&b);
+
+	bool status;
+	channel_send_reliable(&a, "hello", 5, &status);
+	assert_true(status);
+
+	uint8_t data[CHANNEL_LINK_MTU];
+	uint16_t seq;
+	uint32_t payload;
+	channel_packet_info_t info;
+
+	uint32_t len = channel_test_write(&a, data, sizeof(data), 42, &seq);
+	assert_eq(sendto(fds[0], data, len, 0, (void*) &addrs[1], sizeof(addrs[1])), len);
+
+	ssize_t bytes = recv(fds[1], data, sizeof(data), 0);
+	assert_eq(bytes, len);
+
+	channel_test_read(&b, data, bytes, &info, &payload);
+	assert_true(info.fresh);
+	assert_eq(payload, 42);
+
+	char msg[CHANNEL_MAX_MESSAGE_SIZE];
+	assert_true(channel_recv_reliable(&b, msg, &len));
+	assert_eq(len, 5);
+	assert_eq(memcmp(msg, "hello", 5), 0);
+
+	len = channel_test_write(&b, data, sizeof(data), 43, &seq);
+	assert_eq(sendto(fds[1], data, len, 0, (void*) &addrs[0], sizeof(addrs[0])), len);
+
+	bytes = recv(fds[0], data, sizeof(data), 0);
+	assert_eq(bytes, len);
+
+	channel_test_read(&a, data, bytes, &info, &payload);
+	assert_eq(payload, 43);
+	assert_true(channel_is_acked(&a, 0));
+	assert_eq(channel_reliable_pending(&a), 0);
+
+	close(fds[0]);
+	close(fds[1]);
+}
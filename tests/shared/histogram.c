@@ -0,0 +1,138 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <shared/debug.h>
+#include <shared/histogram.h>
+
+
+void assert_used
+test_normal_pass__histogram_empty(
+	void
+	)
+{
+	histogram_t histogram;
+	histogram_reset(&histogram);
+
+	assert_eq(histogram.count, 0);
+	assert_eq(histogram_percentile(&histogram, 50.0), 0);
+	assert_eq(histogram_mean(&histogram), 0);
+}
+
+
+void assert_used
+test_normal_pass__histogram_small_values_exact(
+	void
+	)
+{
+	histogram_t histogram;
+	histogram_reset(&histogram);
+
+	for(uint64_t i = 1; i <= 20; ++i)
+	{
+		histogram_record(&histogram, i);
+	}
+
+	assert_eq(histogram.count, 20);
+	assert_eq(histogram.min, 1);
+	assert_eq(histogram.max, 20);
+	assert_eq(histogram_mean(&histogram), 10);
+	assert_eq(histogram_percentile(&histogram, 0.0), 1);
+	assert_eq(histogram_percentile(&histogram, 50.0), 10);
+	assert_eq(histogram_percentile(&histogram, 100.0), 20);
+}
+
+
+void assert_used
+test_normal_pass__histogram_relative_precision(
+	void
+	)
+{
+	histogram_t histogram;
+	histogram_reset(&histogram);
+
+	for(uint64_t i = 1; i <= 100000; ++i)
+	{
+		histogram_record(&histogram, i * 1000);
+	}
+
+	uint64_t p50 = histogram_percentile(&histogram, 50.0);
+	uint64_t p99 = histogram_percentile(&histogram, 99.0);
+	uint64_t p999 = histogram_percentile(&histogram, 99.9);
+
+	assert_ge(p50, 50000000);
+	assert_le(p50, 50000000 + 50000000 / HISTOGRAM_SUB_BUCKETS);
+
+	assert_ge(p99, 99000000);
+	assert_le(p99, 99000000 + 99000000 / HISTOGRAM_SUB_BUCKETS);
+
+	assert_ge(p999, 99900000);
+	assert_le(p999, 100000000);
+
+	assert_eq(histogram_percentile(&histogram, 100.0), 100000000);
+}
+
+
+void assert_used
+test_normal_pass__histogram_huge_values(
+	void
+	)
+{
+	histogram_t histogram;
+	histogram_reset(&histogram);
+
+	histogram_record(&histogram, UINT64_MAX);
+	histogram_record(&histogram, UINT64_C(1) << 63);
+
+	assert_eq(histogram.min, UINT64_C(1) << 63);
+	assert_eq(histogram.max, UINT64_MAX);
+	assert_eq(histogram_percentile(&histogram, 100.0), UINT64_MAX);
+}
+
+
+void assert_used
+test_normal_pass__histogram_merge(
+	void
+	)
+{
+	histogram_t a;
+	histogram_t b;
+	histogram_reset(&a);
+	histogram_reset(&b);
+
+	histogram_record(&a, 5);
+	histogram_record(&b, 3);
+	histogram_record(&b, 9);
+
+	histogram_merge(&a, &b);
+
+	assert_eq(a.count, 3);
+	assert_eq(a.min, 3);
+	assert_eq(a.max, 9);
+	assert_eq(a.sum, 17);
+	assert_eq(histogram_percentile(&a, 50.0), 5);
+}
+
+
+void assert_used
+test_normal_fail__histogram_percentile_out_of_range(
+	void
+	)
+{
+	histogram_t histogram;
+	histogram_reset(&histogram);
+
+	(void) histogram_percentile(&histogram, 100.5);
+}
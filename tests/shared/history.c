@@ -0,0 +1,250 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/debug.h>
+#include <shared/history.h>
+
+
+#define HISTORY_TEST_LENGTH 4
+#define HISTORY_TEST_ENTITIES 8
+
+
+private void
+history_test_record(
+	history_t* history,
+	uint64_t tick,
+	float offset
+	)
+{
+	float x[HISTORY_TEST_ENTITIES];
+	float y[HISTORY_TEST_ENTITIES];
+	float w[HISTORY_TEST_ENTITIES];
+	float h[HISTORY_TEST_ENTITIES];
+
+	for(uint32_t i = 0; i < HISTORY_TEST_ENTITIES; ++i)
+	{
+		x[i] = i * 100.0f + offset;
+		y[i] = -(i * 100.0f);
+		w[i] = 10.0f;
+		h[i] = 10.0f;
+	}
+
+	history_record(history, tick, x, y, w, h, HISTORY_TEST_ENTITIES);
+}
+
+
+void assert_used
+test_normal_pass__history_init_free(
+	void
+	)
+{
+	history_t history;
+	history_init(&history, HISTORY_TEST_LENGTH, HISTORY_TEST_ENTITIES);
+
+	assert_false(history_has(&history, 0));
+
+	history_free(&history);
+}
+
+
+void assert_used
+test_normal_fail__history_init_empty(
+	void
+	)
+{
+	history_t history;
+	history_init(&history, 0, HISTORY_TEST_ENTITIES);
+}
+
+
+void assert_used
+test_normal_pass__history_get(
+	void
+	)
+{
+	history_t history;
+	history_init(&history, HISTORY_TEST_LENGTH, HISTORY_TEST_ENTITIES);
+
+	history_test_record(&history, 10, 0.0f);
+	history_test_record(&history, 11, 1.5f);
+
+	half_extent_t extent;
+	assert_true(history_get(&history, 10, 3, &extent));
+	assert_eq(extent.x, 300.0f);
+	assert_eq(extent.y, -300.0f);
+	assert_eq(extent.w, 10.0f);
+
+	assert_true(history_get(&history, 11, 3, &extent));
+	assert_eq(extent.x, 301.5f);
+
+	assert_false(history_get(&history, 9, 3, &extent));
+	assert_false(history_get(&history, 12, 3, &extent));
+
+	history_free(&history);
+}
+
+
+void assert_used
+test_normal_pass__history_wraps(
+	void
+	)
+{
+	history_t history;
+	history_init(&history, HISTORY_TEST_LENGTH, HISTORY_TEST_ENTITIES);
+
+	for(uint64_t tick = 1; tick <= HISTORY_TEST_LENGTH * 2; ++tick)
+	{
+		history_test_record(&history, tick, tick);
+	}
+
+	assert_false(history_has(&history, HISTORY_TEST_LENGTH));
+	assert_true(history_has(&history, HISTORY_TEST_LENGTH + 1));
+
+	half_extent_t extent;
+	assert_true(history_get(&history, HISTORY_TEST_LENGTH + 1, 0, &extent));
+	assert_eq(extent.x, (float)(HISTORY_TEST_LENGTH + 1));
+
+	history_free(&history);
+}
+
+
+void assert_used
+test_normal_fail__history_record_gap(
+	void
+	)
+{
+	history_t history;
+	history_init(&history, HISTORY_TEST_LENGTH, HISTORY_TEST_ENTITIES);
+
+	history_test_record(&history, 1, 0.0f);
+	history_test_record(&history, 3, 0.0f);
+}
+
+
+void assert_used
+test_normal_pass__history_spread(
+	void
+	)
+{
+	history_t history;
+	history_init(&history, HISTORY_TEST_LENGTH, HISTORY_TEST_ENTITIES);
+
+	history_test_record(&history, 1, 0.0f);
+	history_test_record(&history, 2, 2.0f);
+	history_test_record(&history, 3, 5.0f);
+
+	/* Slack of one quantization step on top of the movement */
+	float step = 1.0f / (1 << HISTORY_FRACTION_BITS);
+
+	assert_eq(history_spread(&history, 3), step);
+	assert_eq(history_spread(&history, 2), 3.0f + step);
+	assert_eq(history_spread(&history, 1), 5.0f + step);
+
+	history_free(&history);
+}
+
+
+void assert_used
+test_normal_pass__history_spawn(
+	void
+	)
+{
+	history_t history;
+	history_init(&history, HISTORY_TEST_LENGTH, HISTORY_TEST_ENTITIES);
+
+	history_test_record(&history, 1, 0.0f);
+
+	/* Index 2 is reused by an entity far away, which must not inflate spread */
+	history_spawn(&history, 2);
+
+	float x[HISTORY_TEST_ENTITIES] = {0};
+	float y[HISTORY_TEST_ENTITIES] = {0};
+	float w[HISTORY_TEST_ENTITIES] = {0};
+	float h[HISTORY_TEST_ENTITIES] = {0};
+
+	for(uint32_t i = 0; i < HISTORY_TEST_ENTITIES; ++i)
+	{
+		x[i] = i * 100.0f;
+		y[i] = -(i * 100.0f);
+		w[i] = 10.0f;
+		h[i] = 10.0f;
+	}
+
+	x[2] = 5000.0f;
+	history_record(&history, 2, x, y, w, h, HISTORY_TEST_ENTITIES);
+
+	half_extent_t extent;
+	assert_false(history_get(&history, 1, 2, &extent));
+	assert_true(history_get(&history, 2, 2, &extent));
+	assert_true(history_get(&history, 1, 3, &extent));
+
+	assert_lt(history_spread(&history, 1), 1.0f);
+
+	history_free(&history);
+}
+
+
+void assert_used
+test_normal_pass__history_intersects(
+	void
+	)
+{
+	history_t history;
+	history_init(&history, HISTORY_TEST_LENGTH, HISTORY_TEST_ENTITIES);
+
+	history_test_record(&history, 1, 0.0f);
+	history_test_record(&history, 2, 50.0f);
+
+	rect_extent_t rect =
+	{
+		.min_x = -5.0f,
+		.min_y = -5.0f,
+		.max_x = 5.0f,
+		.max_y = 5.0f
+	};
+
+	assert_true(history_intersects(&history, 1, 0, rect));
+	assert_false(history_intersects(&history, 2, 0, rect));
+	assert_false(history_intersects(&history, 1, 1, rect));
+
+	history_free(&history);
+}
+
+
+void assert_used
+test_normal_pass__history_resize(
+	void
+	)
+{
+	history_t history;
+	history_init(&history, HISTORY_TEST_LENGTH, HISTORY_TEST_ENTITIES);
+
+	history_test_record(&history, 1, 0.0f);
+	history_resize(&history, HISTORY_TEST_ENTITIES * 4);
+
+	half_extent_t extent;
+	assert_true(history_get(&history, 1, HISTORY_TEST_ENTITIES - 1, &extent));
+	assert_eq(extent.x, (HISTORY_TEST_ENTITIES - 1) * 100.0f);
+	assert_false(history_get(&history, 1, HISTORY_TEST_ENTITIES, &extent));
+
+	history_test_record(&history, 2, 1.0f);
+
+	assert_true(history_get(&history, 2, 0, &extent));
+	assert_eq(extent.x, 1.0f);
+
+	history_free(&history);
+}
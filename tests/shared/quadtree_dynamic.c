@@ -224,6 +224,51 @@ qt_test_query(
 }
 
 
+static void
+qt_test_query_at(
+	qt_test_t* test,
+	const history_t* history,
+	uint64_t tick,
+	float x,
+	float y,
+	float w,
+	float h
+	)
+{
+	test->queried_count = 0;
+	memset(test->queried, 0, sizeof(test->queried));
+	quadtree_query_rect_at(&test->qt, history, tick,
+		half_to_rect_extent((half_extent_t){ .x = x, .y = y, .w = w, .h = h }), qt_test_query_fn, NULL);
+}
+
+
+static void
+qt_test_record(
+	qt_test_t* test,
+	history_t* history,
+	uint64_t tick
+	)
+{
+	float x[MAX_ENTITIES] = {0};
+	float y[MAX_ENTITIES] = {0};
+	float w[MAX_ENTITIES] = {0};
+	float h[MAX_ENTITIES] = {0};
+
+	for(uint32_t i = 1; i < test->qt.entities_used; ++i)
+	{
+		const qt_dyn_test_entity_data_t* data = &test->qt.entities[i].data;
+		half_extent_t extent = rect_to_half_extent(data->rect_extent);
+
+		x[data->idx] = extent.x;
+		y[data->idx] = extent.y;
+		w[data->idx] = extent.w;
+		h[data->idx] = extent.h;
+	}
+
+	history_record(history, tick, x, y, w, h, test->next_idx);
+}
+
+
 void assert_used
 test_normal_pass__quadtree_dynamic_init_free(
 	void
@@ -538,3 +583,143 @@ test_normal_pass__quadtree_dynamic_rapid_cross_tree_movement(
 
 	qt_test_free(&test);
 }
+
+
+static quadtree_status_t
+qt_test_oscillate_fn(
+	quadtree_t* qt,
+	quadtree_entity_info_t info,
+	void* user_data
+	)
+{
+	qt_test_update_fn(qt, info, user_data);
+
+	info.data->vx = -info.data->vx;
+	info.data->vy = -info.data->vy;
+
+	return QUADTREE_STATUS_CHANGED;
+}
+
+
+static void
+qt_test_count_collide_fn(
+	const quadtree_t* qt,
+	quadtree_entity_info_t a,
+	quadtree_entity_info_t b,
+	void* user_data
+	)
+{
+	(void) qt;
+	(void) a;
+	(void) b;
+
+	++*(uint32_t*) user_data;
+}
+
+
+void assert_used
+test_normal_pass__quadtree_dynamic_steady_state_no_alloc(
+	void
+	)
+{
+	qt_test_t test = qt_test_init(
+		0.0f, 0.0f, 100.0f, 100.0f,
+		(qt_test_opts_t)
+		{
+			.split_threshold = 2,
+			.max_depth = 8,
+			.dfs_length = 32,
+			.merge_ht_size = 64,
+			.min_size = 1.0f,
+			.merge_threshold_set = false
+		}
+	);
+
+	for(uint32_t i = 0; i < MAX_ENTITIES; ++i)
+	{
+		float x = -75.0f + (i % 4) * 50.0f;
+		float y = -75.0f + (i / 4) * 50.0f;
+
+		qt_test_insert(&test, x, y, 30.0f, 30.0f, 30.0f, -30.0f);
+	}
+
+	uint32_t collisions = 0;
+
+	for(uint32_t tick = 0; tick < 4; ++tick)
+	{
+		quadtree_update(&test.qt, qt_test_oscillate_fn, NULL);
+		quadtree_collide(&test.qt, qt_test_count_collide_fn, &collisions);
+		qt_test_query(&test, 0.0f, 0.0f, 100.0f, 100.0f);
+	}
+
+	uint64_t memory_usage = quadtree_memory_usage(&test.qt);
+	alloc_t alloc_calls = alloc_get_call_count();
+
+	for(uint32_t tick = 0; tick < 16; ++tick)
+	{
+		quadtree_update(&test.qt, qt_test_oscillate_fn, NULL);
+		quadtree_collide(&test.qt, qt_test_count_collide_fn, &collisions);
+		qt_test_query(&test, 0.0f, 0.0f, 100.0f, 100.0f);
+		assert_eq(test.queried_count, MAX_ENTITIES);
+	}
+
+	assert_eq(alloc_get_call_count(), alloc_calls);
+	assert_eq(quadtree_memory_usage(&test.qt), memory_usage);
+	assert_gt(collisions, 0);
+
+	qt_test_free(&test);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_dynamic_query_rect_at(
+	void
+	)
+{
+	qt_test_t test = qt_test_init(
+		0.0f, 0.0f, 100.0f, 100.0f,
+		(qt_test_opts_t)
+		{
+			.split_threshold = 1,
+			.max_depth = 8,
+			.dfs_length = 32,
+			.merge_ht_size = 64,
+			.min_size = 1.0f,
+			.merge_threshold_set = false
+		}
+	);
+
+	history_t history;
+	history_init(&history, 8, MAX_ENTITIES);
+
+	qt_test_insert(&test, -40.0f, 0.0f, 5.0f, 5.0f, 10.0f, 0.0f);
+	qt_test_insert(&test, 40.0f, 0.0f, 5.0f, 5.0f, 0.0f, 0.0f);
+	qt_test_normalize(&test);
+	qt_test_record(&test, &history, 1);
+
+	for(uint64_t tick = 2; tick <= 4; ++tick)
+	{
+		qt_test_update(&test);
+		qt_test_normalize(&test);
+		qt_test_record(&test, &history, tick);
+	}
+
+	qt_test_query(&test, -40.0f, 0.0f, 2.0f, 2.0f);
+	assert_eq(test.queried_count, 0);
+
+	qt_test_query_at(&test, &history, 1, -40.0f, 0.0f, 2.0f, 2.0f);
+	assert_eq(test.queried_count, 1);
+	assert_eq(test.qt.entities[test.queried[0]].data.idx, 0);
+
+	qt_test_query_at(&test, &history, 4, -10.0f, 0.0f, 2.0f, 2.0f);
+	assert_eq(test.queried_count, 1);
+
+	qt_test_query_at(&test, &history, 1, -10.0f, 0.0f, 2.0f, 2.0f);
+	assert_eq(test.queried_count, 0);
+
+	qt_test_query_at(&test, &history, 2, 0.0f, 0.0f, 50.0f, 10.0f);
+	assert_eq(test.queried_count, 2);
+
+	history_free(&history);
+	qt_test_free(&test);
+}
@@ -0,0 +1,243 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <tests/base.h>
+#include <shared/debug.h>
+#include <shared/extent.h>
+#include <shared/alloc_ext.h>
+#include <tests/quadtree_f64.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_ENTITIES 16
+
+
+typedef struct qt_f64_test
+{
+	quadtree_t qt;
+	uint32_t next_idx;
+	uint32_t queried[MAX_ENTITIES];
+	uint32_t queried_order[MAX_ENTITIES];
+	uint32_t queried_count;
+	uint32_t collided_count;
+}
+qt_f64_test_t;
+
+
+static qt_f64_test_t
+qt_f64_test_init(
+	double x,
+	double y,
+	double w,
+	double h
+	)
+{
+	qt_f64_test_t test = {0};
+
+	test.qt.half_extent = (half_extent_f64_t){ .x = x, .y = y, .w = w, .h = h };
+	test.qt.rect_extent = half_to_rect_extent_f64(test.qt.half_extent);
+	quadtree_init(&test.qt);
+
+	return test;
+}
+
+
+static void
+qt_f64_test_insert(
+	qt_f64_test_t* test,
+	double x,
+	double y,
+	double w,
+	double h
+	)
+{
+	half_extent_f64_t half_extent = { .x = x, .y = y, .w = w, .h = h };
+	quadtree_insert(&test->qt, &(
+		(qt_f64_test_entity_data_t)
+		{
+			.rect_extent = half_to_rect_extent_f64(half_extent),
+			.idx = test->next_idx++
+		}
+		));
+}
+
+
+static quadtree_status_t
+qt_f64_test_query_fn(
+	quadtree_t* qt,
+	quadtree_entity_info_t info,
+	void* user_data
+	)
+{
+	(void) user_data;
+
+	qt_f64_test_t* test = MACRO_CONTAINER_OF(qt, qt_f64_test_t, qt);
+	++test->queried[info.data->idx];
+	test->queried_order[test->queried_count++] = info.data->idx;
+
+	return QUADTREE_STATUS_NOT_CHANGED;
+}
+
+
+static void
+qt_f64_test_reset_query(
+	qt_f64_test_t* test
+	)
+{
+	memset(test->queried, 0, sizeof(test->queried));
+	test->queried_count = 0;
+}
+
+
+static void
+qt_f64_test_collide_fn(
+	const quadtree_t* qt,
+	quadtree_entity_info_t a,
+	quadtree_entity_info_t b,
+	void* user_data
+	)
+{
+	(void) a;
+	(void) b;
+	(void) user_data;
+
+	qt_f64_test_t* test = MACRO_CONTAINER_OF(qt, qt_f64_test_t, qt);
+	++test->collided_count;
+}
+
+
+void assert_used
+test_normal_pass__quadtree_f64_init_free(
+	void
+	)
+{
+	qt_f64_test_t test = qt_f64_test_init(0.0, 0.0, 64.0, 64.0);
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_f64_separates_distant_neighbors(
+	void
+	)
+{
+	/* At 1e8 a float has a spacing of 8, so these would be the same point */
+	qt_f64_test_t test = qt_f64_test_init(1e8, 1e8, 1024.0, 1024.0);
+
+	qt_f64_test_insert(&test, 1e8, 1e8, 1.0, 1.0);
+	qt_f64_test_insert(&test, 1e8 + 4.0, 1e8, 1.0, 1.0);
+
+	quadtree_collide(&test.qt, qt_f64_test_collide_fn, NULL);
+	assert_eq(test.collided_count, 0);
+
+	qt_f64_test_reset_query(&test);
+	quadtree_query_rect(&test.qt,
+		half_to_rect_extent_f64((half_extent_f64_t){ .x = 1e8 - 1.0, .y = 1e8, .w = 0.5, .h = 0.5 }),
+		qt_f64_test_query_fn, NULL);
+	assert_eq(test.queried[0], 1);
+	assert_eq(test.queried[1], 0);
+
+	qt_f64_test_reset_query(&test);
+	quadtree_query_circle(&test.qt, 1e8 + 5.5, 1e8, 1.0, qt_f64_test_query_fn, NULL);
+	assert_eq(test.queried[0], 0);
+	assert_eq(test.queried[1], 1);
+
+	quadtree_check(&test.qt);
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_f64_collide_touching(
+	void
+	)
+{
+	qt_f64_test_t test = qt_f64_test_init(1e8, 1e8, 1024.0, 1024.0);
+
+	qt_f64_test_insert(&test, 1e8, 1e8, 1.0, 1.0);
+	qt_f64_test_insert(&test, 1e8 + 2.0, 1e8, 1.0, 1.0);
+
+	quadtree_collide(&test.qt, qt_f64_test_collide_fn, NULL);
+	assert_eq(test.collided_count, 1);
+
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_f64_nearest_circle(
+	void
+	)
+{
+	qt_f64_test_t test = qt_f64_test_init(0.0, 0.0, 1e9, 1e9);
+
+	qt_f64_test_insert(&test, 5e8 + 30.0, 5e8, 1.0, 1.0);
+	qt_f64_test_insert(&test, 5e8 + 10.0, 5e8, 1.0, 1.0);
+	qt_f64_test_insert(&test, 5e8 + 20.0, 5e8, 1.0, 1.0);
+
+	qt_f64_test_reset_query(&test);
+	quadtree_nearest_circle(&test.qt, 5e8, 5e8, -1.0, 3, qt_f64_test_query_fn, NULL);
+
+	assert_eq(test.queried_count, 3);
+	assert_eq(test.queried_order[0], 1);
+	assert_eq(test.queried_order[1], 2);
+	assert_eq(test.queried_order[2], 0);
+
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_f64_raycast(
+	void
+	)
+{
+	qt_f64_test_t test = qt_f64_test_init(1e8, 1e8, 1024.0, 1024.0);
+
+	qt_f64_test_insert(&test, 1e8 + 100.0, 1e8, 1.0, 1.0);
+	qt_f64_test_insert(&test, 1e8 + 100.0, 1e8 + 3.0, 1.0, 1.0);
+
+	qt_f64_test_reset_query(&test);
+	quadtree_raycast(&test.qt, 1e8, 1e8, 200.0, 0.0, qt_f64_test_query_fn, NULL);
+	assert_eq(test.queried[0], 1);
+	assert_eq(test.queried[1], 0);
+
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_f64_split_merge(
+	void
+	)
+{
+	qt_f64_test_t test = qt_f64_test_init(1e8, 1e8, 1024.0, 1024.0);
+
+	for(uint32_t i = 0; i < MAX_ENTITIES; ++i)
+	{
+		qt_f64_test_insert(&test, 1e8 + i * 64.0 - 512.0, 1e8 + i * 32.0 - 256.0, 0.25, 0.25);
+	}
+
+	quadtree_normalize(&test.qt);
+	assert_gt(quadtree_depth(&test.qt), 1);
+	quadtree_check(&test.qt);
+
+	quadtree_collide(&test.qt, qt_f64_test_collide_fn, NULL);
+	assert_eq(test.collided_count, 0);
+
+	quadtree_free(&test.qt);
+}
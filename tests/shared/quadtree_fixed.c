@@ -0,0 +1,390 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <tests/base.h>
+#include <shared/debug.h>
+#include <shared/extent.h>
+#include <shared/alloc_ext.h>
+#include <tests/quadtree_fixed.h>
+
+#include <string.h>
+
+#define MAX_ENTITIES 64
+#define FX(x) quadtree_coord_from_f32(x)
+
+
+typedef struct qt_fixed_test
+{
+	quadtree_t qt;
+	uint32_t next_idx;
+	uint32_t queried[MAX_ENTITIES];
+	uint32_t queried_order[MAX_ENTITIES];
+	uint32_t queried_count;
+	uint32_t collided_count;
+	uint64_t collided_hash;
+}
+qt_fixed_test_t;
+
+
+static qt_fixed_test_t
+qt_fixed_test_init(
+	int32_t x,
+	int32_t y,
+	int32_t w,
+	int32_t h
+	)
+{
+	qt_fixed_test_t test = {0};
+
+	test.qt.half_extent = (half_extent_i32_t){ .x = x, .y = y, .w = w, .h = h };
+	test.qt.rect_extent = half_to_rect_extent_i32(test.qt.half_extent);
+	quadtree_init(&test.qt);
+
+	return test;
+}
+
+
+static void
+qt_fixed_test_insert(
+	qt_fixed_test_t* test,
+	int32_t x,
+	int32_t y,
+	int32_t w,
+	int32_t h
+	)
+{
+	half_extent_i32_t half_extent = { .x = x, .y = y, .w = w, .h = h };
+	quadtree_insert(&test->qt, &(
+		(qt_fixed_test_entity_data_t)
+		{
+			.rect_extent = half_to_rect_extent_i32(half_extent),
+			.idx = test->next_idx++
+		}
+		));
+}
+
+
+static quadtree_status_t
+qt_fixed_test_query_fn(
+	quadtree_t* qt,
+	quadtree_entity_info_t info,
+	void* user_data
+	)
+{
+	(void) user_data;
+
+	qt_fixed_test_t* test = MACRO_CONTAINER_OF(qt, qt_fixed_test_t, qt);
+	++test->queried[info.data->idx];
+	test->queried_order[test->queried_count++] = info.data->idx;
+
+	return QUADTREE_STATUS_NOT_CHANGED;
+}
+
+
+static void
+qt_fixed_test_reset_query(
+	qt_fixed_test_t* test
+	)
+{
+	memset(test->queried, 0, sizeof(test->queried));
+	test->queried_count = 0;
+}
+
+
+static void
+qt_fixed_test_collide_fn(
+	const quadtree_t* qt,
+	quadtree_entity_info_t a,
+	quadtree_entity_info_t b,
+	void* user_data
+	)
+{
+	(void) user_data;
+
+	qt_fixed_test_t* test = MACRO_CONTAINER_OF(qt, qt_fixed_test_t, qt);
+	++test->collided_count;
+
+	uint32_t lo = MACRO_MIN(a.data->idx, b.data->idx);
+	uint32_t hi = MACRO_MAX(a.data->idx, b.data->idx);
+	test->collided_hash += ((uint64_t) lo << 32 | hi) * 0x9E3779B97F4A7C15;
+}
+
+
+static quadtree_status_t
+qt_fixed_test_update_fn(
+	quadtree_t* qt,
+	quadtree_entity_info_t info,
+	void* user_data
+	)
+{
+	(void) qt;
+	(void) user_data;
+
+	int32_t vx = (int32_t)(info.data->idx * 37 % 17) - 8;
+	int32_t vy = (int32_t)(info.data->idx * 53 % 13) - 6;
+
+	info.data->rect_extent.min_x += vx;
+	info.data->rect_extent.max_x += vx;
+	info.data->rect_extent.min_y += vy;
+	info.data->rect_extent.max_y += vy;
+
+	return QUADTREE_STATUS_CHANGED;
+}
+
+
+void assert_used
+test_normal_pass__quadtree_fixed_init_free(
+	void
+	)
+{
+	qt_fixed_test_t test = qt_fixed_test_init(0, 0, FX(64.0f), FX(64.0f));
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_fixed_coord_conversion(
+	void
+	)
+{
+	assert_eq(FX(1.0f), 1 << quadtree_fixed_fraction_bits);
+	assert_eq(FX(-1.0f), -(1 << quadtree_fixed_fraction_bits));
+	assert_eq(FX(0.5f), 1 << (quadtree_fixed_fraction_bits - 1));
+	assert_eq(quadtree_coord_to_f32(FX(-123.25f)), -123.25f);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_fixed_odd_extent(
+	void
+	)
+{
+	qt_fixed_test_t test = qt_fixed_test_init(0, 0, FX(100.0f) + 1, FX(100.0f) + 1);
+
+	assert_eq(test.qt.half_extent.w, FX(128.0f));
+	assert_eq(test.qt.half_extent.h, FX(128.0f));
+	assert_eq(test.qt.rect_extent.max_x, FX(128.0f));
+	assert_eq(test.qt.rect_extent.min_y, -FX(128.0f));
+
+	/* Hugging the original odd edge, deep enough to split several times */
+	for(uint32_t i = 0; i < 32; ++i)
+	{
+		int32_t offset = FX(3.0f) * i;
+		qt_fixed_test_insert(&test, FX(100.0f) - offset, FX(100.0f) - offset, 1, 1);
+	}
+
+	for(uint32_t i = 0; i < 32; ++i)
+	{
+		int32_t offset = FX(3.0f) * i;
+
+		qt_fixed_test_reset_query(&test);
+		quadtree_query_rect(&test.qt,
+			(rect_extent_i32_t)
+			{
+				.min_x = FX(100.0f) - offset,
+				.min_y = FX(100.0f) - offset,
+				.max_x = FX(100.0f) - offset,
+				.max_y = FX(100.0f) - offset
+			},
+			qt_fixed_test_query_fn, NULL);
+		assert_eq(test.queried_count, 1);
+		assert_eq(test.queried[i], 1);
+	}
+
+	quadtree_check(&test.qt);
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_fixed_max_extent(
+	void
+	)
+{
+	int32_t half = INT32_C(1) << 29;
+	qt_fixed_test_t test = qt_fixed_test_init(half - 1, -half + 1, half, half);
+
+	assert_eq(test.qt.rect_extent.max_x, (INT32_C(1) << 30) - 1);
+	assert_eq(test.qt.rect_extent.min_y, -(INT32_C(1) << 30) + 1);
+
+	qt_fixed_test_insert(&test, test.qt.rect_extent.max_x - 1, test.qt.rect_extent.min_y + 1, 1, 1);
+
+	/* From the opposite corner of the coordinate range, the squared
+	 * distance comes within a hair of 2^63 */
+	qt_fixed_test_reset_query(&test);
+	quadtree_query_circle(&test.qt, -(INT32_C(1) << 30) + 1, (INT32_C(1) << 30) - 1,
+		INT32_C(1) << 30, qt_fixed_test_query_fn, NULL);
+	assert_eq(test.queried_count, 0);
+
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_fail__quadtree_fixed_extent_too_large(
+	void
+	)
+{
+	int32_t half = INT32_C(1) << 29;
+	qt_fixed_test_t test = qt_fixed_test_init(half, 0, half, half);
+
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_fixed_collide_exact_boundary(
+	void
+	)
+{
+	qt_fixed_test_t test = qt_fixed_test_init(0, 0, FX(1024.0f), FX(1024.0f));
+
+	/* Touching by exactly zero raw units */
+	qt_fixed_test_insert(&test, FX(10.0f), 0, FX(1.0f), FX(1.0f));
+	qt_fixed_test_insert(&test, FX(12.0f), 0, FX(1.0f), FX(1.0f));
+
+	/* Apart by exactly one raw unit */
+	qt_fixed_test_insert(&test, FX(-10.0f), 0, FX(1.0f), FX(1.0f));
+	qt_fixed_test_insert(&test, FX(-12.0f) - 1, 0, FX(1.0f), FX(1.0f));
+
+	quadtree_collide(&test.qt, qt_fixed_test_collide_fn, NULL);
+	assert_eq(test.collided_count, 1);
+
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_fixed_query_circle_boundary(
+	void
+	)
+{
+	qt_fixed_test_t test = qt_fixed_test_init(0, 0, FX(1024.0f), FX(1024.0f));
+
+	qt_fixed_test_insert(&test, FX(101.0f), 0, FX(1.0f), FX(1.0f));
+
+	qt_fixed_test_reset_query(&test);
+	quadtree_query_circle(&test.qt, 0, 0, FX(100.0f), qt_fixed_test_query_fn, NULL);
+	assert_eq(test.queried[0], 1);
+
+	qt_fixed_test_reset_query(&test);
+	quadtree_query_circle(&test.qt, 0, 0, FX(100.0f) - 1, qt_fixed_test_query_fn, NULL);
+	assert_eq(test.queried[0], 0);
+
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_fixed_nearest_circle(
+	void
+	)
+{
+	qt_fixed_test_t test = qt_fixed_test_init(0, 0, FX(1024.0f), FX(1024.0f));
+
+	qt_fixed_test_insert(&test, FX(300.0f), 0, FX(1.0f), FX(1.0f));
+	qt_fixed_test_insert(&test, FX(100.0f), 0, FX(1.0f), FX(1.0f));
+	qt_fixed_test_insert(&test, FX(200.0f), 0, FX(1.0f), FX(1.0f));
+
+	qt_fixed_test_reset_query(&test);
+	quadtree_nearest_circle(&test.qt, 0, 0, -1, 3, qt_fixed_test_query_fn, NULL);
+	assert_eq(test.queried_count, 3);
+	assert_eq(test.queried_order[0], 1);
+	assert_eq(test.queried_order[1], 2);
+	assert_eq(test.queried_order[2], 0);
+
+	qt_fixed_test_reset_query(&test);
+	quadtree_nearest_circle(&test.qt, 0, 0, FX(150.0f), 3, qt_fixed_test_query_fn, NULL);
+	assert_eq(test.queried_count, 1);
+	assert_eq(test.queried_order[0], 1);
+
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_fixed_raycast(
+	void
+	)
+{
+	qt_fixed_test_t test = qt_fixed_test_init(0, 0, FX(1024.0f), FX(1024.0f));
+
+	qt_fixed_test_insert(&test, 0, FX(100.0f), FX(1.0f), FX(1.0f));
+	qt_fixed_test_insert(&test, FX(3.0f), FX(100.0f), FX(1.0f), FX(1.0f));
+	qt_fixed_test_insert(&test, FX(100.0f), FX(1.0f), FX(1.0f), FX(1.0f));
+
+	/* Zero horizontal direction */
+	qt_fixed_test_reset_query(&test);
+	quadtree_raycast(&test.qt, 0, 0, 0, FX(200.0f), qt_fixed_test_query_fn, NULL);
+	assert_eq(test.queried_count, 1);
+	assert_eq(test.queried[0], 1);
+
+	/* Grazing the bottom edge of the third entity */
+	qt_fixed_test_reset_query(&test);
+	quadtree_raycast(&test.qt, 0, 0, FX(200.0f), 0, qt_fixed_test_query_fn, NULL);
+	assert_eq(test.queried_count, 1);
+	assert_eq(test.queried[2], 1);
+
+	qt_fixed_test_reset_query(&test);
+	quadtree_raycast(&test.qt, 0, 0, FX(50.0f), 0, qt_fixed_test_query_fn, NULL);
+	assert_eq(test.queried_count, 0);
+
+	quadtree_free(&test.qt);
+}
+
+
+void assert_used
+test_normal_pass__quadtree_fixed_simulation_reproducible(
+	void
+	)
+{
+	uint64_t hashes[2];
+	uint32_t counts[2];
+
+	for(uint32_t run = 0; run < 2; ++run)
+	{
+		qt_fixed_test_t test = qt_fixed_test_init(0, 0, FX(1024.0f), FX(1024.0f));
+		test.qt.min_size = FX(8.0f);
+
+		uint32_t seed = 1234;
+		for(uint32_t i = 0; i < MAX_ENTITIES; ++i)
+		{
+			seed = seed * 1103515245 + 12345;
+			int32_t x = (int32_t)(seed >> 8) % FX(512.0f);
+			seed = seed * 1103515245 + 12345;
+			int32_t y = (int32_t)(seed >> 8) % FX(512.0f);
+
+			qt_fixed_test_insert(&test, x, y, FX(24.0f), FX(24.0f));
+		}
+
+		for(uint32_t tick = 0; tick < 64; ++tick)
+		{
+			quadtree_update(&test.qt, qt_fixed_test_update_fn, NULL);
+			quadtree_collide(&test.qt, qt_fixed_test_collide_fn, NULL);
+		}
+
+		quadtree_check(&test.qt);
+
+		hashes[run] = test.collided_hash;
+		counts[run] = test.collided_count;
+
+		quadtree_free(&test.qt);
+	}
+
+	assert_gt(counts[0], 0);
+	assert_eq(counts[0], counts[1]);
+	assert_eq(hashes[0], hashes[1]);
+}
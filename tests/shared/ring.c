@@ -0,0 +1,241 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/ring.h>
+#include <shared/debug.h>
+
+#include <string.h>
+
+
+void assert_used
+test_normal_pass__ring_init_free(
+	void
+	)
+{
+	ring_t ring;
+	ring_init(&ring, 16);
+
+	assert_eq(ring_used(&ring), 0);
+	assert_eq(ring_available(&ring), 16);
+
+	ring_free(&ring);
+}
+
+
+void assert_used
+test_normal_fail__ring_init_not_power_of_2(
+	void
+	)
+{
+	ring_t ring;
+	ring_init(&ring, 12);
+}
+
+
+void assert_used
+test_normal_pass__ring_write_read(
+	void
+	)
+{
+	ring_t ring;
+	ring_init(&ring, 16);
+
+	ring_write(&ring, "hello", 5);
+	assert_eq(ring_used(&ring), 5);
+
+	char out[5];
+	ring_peek(&ring, out, 5);
+	assert_eq(memcmp(out, "hello", 5), 0);
+	assert_eq(ring_used(&ring), 5);
+
+	ring_read(&ring, out, 5);
+	assert_eq(memcmp(out, "hello", 5), 0);
+	assert_eq(ring_used(&ring), 0);
+
+	ring_free(&ring);
+}
+
+
+void assert_used
+test_normal_pass__ring_wrap_around(
+	void
+	)
+{
+	ring_t ring;
+	ring_init(&ring, 8);
+
+	ring_write(&ring, "abcdef", 6);
+
+	char out[8];
+	ring_read(&ring, out, 4);
+	assert_eq(memcmp(out, "abcd", 4), 0);
+
+	ring_write(&ring, "ghijkl", 6);
+	assert_eq(ring_used(&ring), 8);
+	assert_eq(ring_available(&ring), 0);
+
+	ring_segment_t segments[2];
+	assert_eq(ring_read_segments(&ring, segments), 2);
+	assert_eq(segments[0].len, 4);
+	assert_eq(segments[1].len, 4);
+	assert_eq(memcmp(segments[0].data, "efgh", 4), 0);
+	assert_eq(memcmp(segments[1].data, "ijkl", 4), 0);
+
+	ring_read(&ring, out, 8);
+	assert_eq(memcmp(out, "efghijkl", 8), 0);
+
+	ring_free(&ring);
+}
+
+
+void assert_used
+test_normal_pass__ring_safe_limits(
+	void
+	)
+{
+	bool status;
+
+	ring_t ring;
+	ring_init(&ring, 4);
+
+	ring_write_safe(&ring, "abcde", 5, &status);
+	assert_false(status);
+	assert_eq(ring_used(&ring), 0);
+
+	ring_write_safe(&ring, "abcd", 4, &status);
+	assert_true(status);
+
+	char out[5];
+	ring_read_safe(&ring, out, 5, &status);
+	assert_false(status);
+	assert_eq(ring_used(&ring), 4);
+
+	ring_read_safe(&ring, out, 4, &status);
+	assert_true(status);
+	assert_eq(memcmp(out, "abcd", 4), 0);
+
+	ring_free(&ring);
+}
+
+
+void assert_used
+test_normal_fail__ring_write_overflow(
+	void
+	)
+{
+	ring_t ring;
+	ring_init(&ring, 4);
+
+	ring_write(&ring, "abcde", 5);
+}
+
+
+void assert_used
+test_normal_pass__ring_write_segments_produce(
+	void
+	)
+{
+	ring_t ring;
+	ring_init(&ring, 8);
+
+	ring_write(&ring, "xxxxxx", 6);
+	ring_consume(&ring, 4);
+
+	ring_segment_t segments[2];
+	assert_eq(ring_write_segments(&ring, segments), 2);
+	assert_eq(segments[0].len, 2);
+	assert_eq(segments[1].len, 4);
+
+	(void) memcpy(segments[0].data, "ab", 2);
+	(void) memcpy(segments[1].data, "cd", 2);
+	ring_produce(&ring, 4);
+
+	char out[6];
+	ring_read(&ring, out, 6);
+	assert_eq(memcmp(out, "xxabcd", 6), 0);
+
+	assert_eq(ring_read_segments(&ring, segments), 0);
+	assert_eq(ring_write_segments(&ring, segments), 1);
+	assert_eq(segments[0].len, 8);
+
+	ring_free(&ring);
+}
+
+
+void assert_used
+test_normal_pass__ring_mirrored_contiguous(
+	void
+	)
+{
+	ring_t ring;
+	ring_init_mirrored(&ring, 16);
+
+	assert_ge(ring.size, 16);
+	assert_true(MACRO_IS_POWER_OF_2(ring.size));
+
+	uint32_t offset = ring.size - 3;
+	ring_produce(&ring, offset);
+	ring_consume(&ring, offset - 1);
+
+	(void) memcpy(ring_write_ptr(&ring), "abcdefgh", 8);
+	ring_produce(&ring, 8);
+
+	assert_eq(ring_used(&ring), 9);
+	assert_eq(memcmp(ring_read_ptr(&ring) + 1, "abcdefgh", 8), 0);
+	assert_eq(memcmp(ring.data, "defgh", 5), 0);
+
+	ring_consume(&ring, 9);
+
+	assert_eq(ring_used(&ring), 0);
+	assert_eq(ring_available(&ring), ring.size);
+
+	ring_free(&ring);
+}
+
+
+void assert_used
+test_normal_pass__ring_mirrored_copy(
+	void
+	)
+{
+	ring_t ring;
+	ring_init_mirrored(&ring, 16);
+
+	ring_produce(&ring, ring.size - 2);
+	ring_consume(&ring, ring.size - 3);
+
+	ring_write(&ring, "abcd", 4);
+
+	char out[5];
+	ring_peek(&ring, out, 5);
+	assert_eq(memcmp(out + 1, "abcd", 4), 0);
+	assert_eq(memcmp(ring_read_ptr(&ring) + 1, "abcd", 4), 0);
+
+	ring_free(&ring);
+}
+
+
+void assert_used
+test_normal_fail__ring_read_ptr_not_mirrored(
+	void
+	)
+{
+	ring_t ring;
+	ring_init(&ring, 16);
+
+	(void) ring_read_ptr(&ring);
+}
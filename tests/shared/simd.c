@@ -0,0 +1,186 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/simd.h>
+#include <shared/debug.h>
+#include <shared/macro.h>
+
+#include <math.h>
+#include <stddef.h>
+
+
+#define SIMD_TEST_COUNT 4099
+
+
+void assert_used
+test_normal_pass__simd_sincos_accuracy(
+	void
+	)
+{
+	static float angle[SIMD_TEST_COUNT];
+	static float sin_out[SIMD_TEST_COUNT];
+	static float cos_out[SIMD_TEST_COUNT];
+
+	for(float range = 4.0f; range <= 8192.0f; range *= 8.0f)
+	{
+		for(uint32_t i = 0; i < SIMD_TEST_COUNT; ++i)
+		{
+			angle[i] = -range + 2.0f * range * i / (SIMD_TEST_COUNT - 1);
+		}
+
+		simd_sincos(angle, sin_out, cos_out, SIMD_TEST_COUNT);
+
+		for(uint32_t i = 0; i < SIMD_TEST_COUNT; ++i)
+		{
+			assert_lt(fabs(sin_out[i] - sin((double) angle[i])), 1.2e-7);
+			assert_lt(fabs(cos_out[i] - cos((double) angle[i])), 1.2e-7);
+		}
+	}
+}
+
+
+void assert_used
+test_normal_pass__simd_sincos_exact_points(
+	void
+	)
+{
+	float angle[] = { 0.0f, -0.0f, M_PI_2, M_PI, -M_PI_2 };
+	float sin_out[MACRO_ARRAY_LEN(angle)];
+	float cos_out[MACRO_ARRAY_LEN(angle)];
+
+	simd_sincos(angle, sin_out, cos_out, MACRO_ARRAY_LEN(angle));
+
+	assert_eq(sin_out[0], 0.0f);
+	assert_eq(cos_out[0], 1.0f);
+	assert_eq(cos_out[1], 1.0f);
+	assert_lt(fabsf(sin_out[2] - 1.0f), 1e-7f);
+	assert_lt(fabsf(cos_out[3] + 1.0f), 1e-7f);
+	assert_lt(fabsf(sin_out[4] + 1.0f), 1e-7f);
+}
+
+
+void assert_used
+test_normal_pass__simd_sincos_in_place(
+	void
+	)
+{
+	float value[13];
+	float cos_out[13];
+
+	for(uint32_t i = 0; i < 13; ++i)
+	{
+		value[i] = i * 0.5f;
+	}
+
+	simd_sincos(value, value, cos_out, 13);
+
+	for(uint32_t i = 0; i < 13; ++i)
+	{
+		assert_lt(fabs(value[i] - sin(i * 0.5)), 1.2e-7);
+	}
+}
+
+
+void assert_used
+test_normal_pass__simd_sincos_empty(
+	void
+	)
+{
+	simd_sincos(NULL, NULL, NULL, 0);
+}
+
+
+void assert_used
+test_normal_fail__simd_sincos_null(
+	void
+	)
+{
+	float out[1];
+	simd_sincos(NULL, out, out, 1);
+}
+
+
+void assert_used
+test_normal_pass__simd_lerp(
+	void
+	)
+{
+	float value[11];
+	float target[11];
+
+	for(uint32_t i = 0; i < 11; ++i)
+	{
+		value[i] = i;
+		target[i] = 100.0f + i;
+	}
+
+	simd_lerp(value, target, 0.25f, 11);
+
+	for(uint32_t i = 0; i < 11; ++i)
+	{
+		assert_eq(value[i], i + (100.0f + i - i) * 0.25f);
+	}
+}
+
+
+void assert_used
+test_normal_pass__simd_lerp_to(
+	void
+	)
+{
+	float value[11];
+
+	for(uint32_t i = 0; i < 11; ++i)
+	{
+		value[i] = i * 10.0f;
+	}
+
+	simd_lerp_to(value, 0.0f, 0.5f, 11);
+
+	for(uint32_t i = 0; i < 11; ++i)
+	{
+		assert_eq(value[i], i * 5.0f);
+	}
+}
+
+
+void assert_used
+test_normal_pass__simd_clamp(
+	void
+	)
+{
+	float value[] = { -5.0f, -1.0f, 0.0f, 0.5f, 1.0f, 7.0f, -0.0f, 2.0f, -3.0f };
+
+	simd_clamp(value, -1.0f, 1.0f, MACRO_ARRAY_LEN(value));
+
+	float expected[] = { -1.0f, -1.0f, 0.0f, 0.5f, 1.0f, 1.0f, -0.0f, 1.0f, -1.0f };
+
+	for(uint32_t i = 0; i < MACRO_ARRAY_LEN(value); ++i)
+	{
+		assert_eq(value[i], expected[i]);
+	}
+}
+
+
+void assert_used
+test_normal_fail__simd_clamp_inverted(
+	void
+	)
+{
+	float value[1] = {0};
+	simd_clamp(value, 1.0f, -1.0f, 1);
+}
@@ -19,6 +19,7 @@
 #include <shared/debug.h>
 #include <shared/threads.h>
 
+#include <sched.h>
 #include <stdatomic.h>
 
 
@@ -57,6 +58,51 @@ test_normal_pass__thread_init_free(
 }
 
 
+#ifdef __linux__
+
+void assert_used
+test_normal_pass__thread_set_affinity(
+	void
+	)
+{
+	thread_t self = thread_self();
+	cpu_set_t old;
+	assert_eq(pthread_getaffinity_np(self, sizeof(old), &old), 0);
+
+	uint32_t cpu = 0;
+	while(!CPU_ISSET(cpu, &old))
+	{
+		++cpu;
+	}
+
+	assert_true(thread_set_affinity(self, cpu));
+	assert_eq(sched_getcpu(), (int) cpu);
+
+	assert_eq(pthread_setaffinity_np(self, sizeof(old), &old), 0);
+}
+
+
+void assert_used
+test_normal_fail__thread_set_affinity_out_of_range(
+	void
+	)
+{
+	(void) thread_set_affinity(thread_self(), CPU_SETSIZE);
+}
+
+#else
+
+void assert_used
+test_normal_pass__thread_set_affinity_unsupported(
+	void
+	)
+{
+	assert_false(thread_set_affinity(thread_self(), 0));
+}
+
+#endif
+
+
 void assert_used
 test_normal_fail__thread_free_null(
 	void
@@ -64,6 +64,100 @@ test_normal_pass__time_time_conversion(
 }
 
 
+void assert_used
+test_normal_pass__time_get_monotonic(
+	void
+	)
+{
+	uint64_t before = time_get_monotonic();
+	thread_sleep(time_ms_to_ns(1));
+	uint64_t after = time_get_monotonic();
+
+	assert_ge(after - before, time_ms_to_ns(1));
+}
+
+
+void assert_used
+test_normal_pass__time_scheduler_on_time(
+	void
+	)
+{
+	time_scheduler_t scheduler;
+	time_scheduler_init(&scheduler, time_ms_to_ns(2), TIME_CATCH_UP_BOUNDED, 2, time_us_to_ns(200));
+
+	uint64_t start = time_get_monotonic();
+
+	for(uint32_t i = 0; i < 5; ++i)
+	{
+		uint64_t jitter = time_scheduler_wait(&scheduler);
+		assert_lt(jitter, time_ms_to_ns(2));
+	}
+
+	assert_ge(time_get_monotonic() - start, time_ms_to_ns(8));
+	assert_eq(scheduler.ticks, 5);
+	assert_eq(scheduler.skipped, 0);
+}
+
+
+void assert_used
+test_normal_pass__time_scheduler_skip(
+	void
+	)
+{
+	time_scheduler_t scheduler;
+	time_scheduler_init(&scheduler, time_ms_to_ns(2), TIME_CATCH_UP_SKIP, 2, 0);
+
+	thread_sleep(time_ms_to_ns(11));
+
+	uint64_t jitter = time_scheduler_wait(&scheduler);
+
+	assert_lt(jitter, time_ms_to_ns(2));
+	assert_ge(scheduler.skipped, 4);
+	assert_eq(scheduler.overruns, 1);
+
+	uint64_t before = time_get_monotonic();
+	(void) time_scheduler_wait(&scheduler);
+
+	assert_gt(time_get_monotonic() - before, 0);
+	assert_eq(scheduler.overruns, 1);
+}
+
+
+void assert_used
+test_normal_pass__time_scheduler_bounded(
+	void
+	)
+{
+	time_scheduler_t scheduler;
+	time_scheduler_init(&scheduler, time_ms_to_ns(2), TIME_CATCH_UP_BOUNDED, 2, 0);
+
+	thread_sleep(time_ms_to_ns(11));
+
+	for(uint32_t i = 0; i < 3; ++i)
+	{
+		(void) time_scheduler_wait(&scheduler);
+	}
+
+	assert_ge(scheduler.skipped, 2);
+	assert_eq(scheduler.overruns, 3);
+	assert_eq(scheduler.ticks, 3);
+
+	(void) time_scheduler_wait(&scheduler);
+
+	assert_eq(scheduler.overruns, 3);
+}
+
+
+void assert_used
+test_normal_fail__time_scheduler_spin_too_long(
+	void
+	)
+{
+	time_scheduler_t scheduler;
+	time_scheduler_init(&scheduler, time_ms_to_ns(1), TIME_CATCH_UP_SKIP, 0, time_ms_to_ns(1));
+}
+
+
 void assert_used
 test_normal_pass__time_timers_init_free(
 	void
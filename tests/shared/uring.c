@@ -0,0 +1,230 @@
+/*
+ *   Copyright 2025 Franciszek Balcerak
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <shared/debug.h>
+#include <shared/uring.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+
+static int
+uring_test_listen(
+	uint16_t* port
+	)
+{
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	assert_neq(fd, -1);
+
+	struct sockaddr_in addr = {0};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	assert_neq(bind(fd, (struct sockaddr*) &addr, sizeof(addr)), -1);
+	assert_neq(listen(fd, 16), -1);
+
+	socklen_t len = sizeof(addr);
+	assert_neq(getsockname(fd, (struct sockaddr*) &addr, &len), -1);
+	*port = ntohs(addr.sin_port);
+
+	return fd;
+}
+
+
+static int
+uring_test_connect(
+	uint16_t port
+	)
+{
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	assert_neq(fd, -1);
+
+	struct sockaddr_in addr = {0};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons(port);
+
+	assert_neq(connect(fd, (struct sockaddr*) &addr, sizeof(addr)), -1);
+
+	return fd;
+}
+
+
+static void
+uring_test_wait_event(
+	uring_t* uring,
+	uring_event_t* event
+	)
+{
+	while(!uring_next_event(uring, event))
+	{
+		(void) uring_submit(uring, 1);
+	}
+}
+
+
+void assert_used
+test_normal_pass__uring_init_free(
+	void
+	)
+{
+	uring_t uring;
+
+	if(!uring_init(&uring, 8, 4, 64))
+	{
+		return;
+	}
+
+	uring_event_t event;
+	assert_false(uring_next_event(&uring, &event));
+	assert_eq(uring_submit(&uring, 0), 0);
+
+	uring_free(&uring);
+}
+
+
+void assert_used
+test_normal_pass__uring_accept_recv_send(
+	void
+	)
+{
+	uring_t uring;
+
+	if(!uring_init(&uring, 16, 4, 64))
+	{
+		return;
+	}
+
+	uint16_t port;
+	int listen_fd = uring_test_listen(&port);
+
+	assert_true(uring_accept_multishot(&uring, listen_fd, 1));
+	assert_eq(uring_submit(&uring, 0), 1);
+
+	int client_fds[2];
+	int server_fds[2];
+
+	for(int i = 0; i < 2; ++i)
+	{
+		client_fds[i] = uring_test_connect(port);
+
+		uring_event_t event;
+		uring_test_wait_event(&uring, &event);
+
+		assert_eq(event.user_data, 1);
+		assert_ge(event.res, 0);
+		assert_true(event.more);
+
+		server_fds[i] = event.res;
+		assert_true(uring_recv_multishot(&uring, server_fds[i], 10 + i));
+	}
+
+	assert_eq(write(client_fds[1], "world", 5), 5);
+	assert_eq(write(client_fds[0], "hello", 5), 5);
+
+	uint32_t seen = 0;
+
+	while(seen != 3)
+	{
+		uring_event_t event;
+		uring_test_wait_event(&uring, &event);
+
+		assert_true(event.user_data == 10 || event.user_data == 11);
+		assert_eq(event.res, 5);
+		assert_not_null(event.buf);
+		assert_true(event.more);
+
+		const char* expected = event.user_data == 10 ? "hello" : "world";
+		assert_eq(memcmp(event.buf, expected, 5), 0);
+
+		uring_return_buf(&uring, event.buf_id);
+
+		seen |= 1 << (event.user_data - 10);
+	}
+
+	assert_true(uring_send(&uring, server_fds[0], "pong", 4, 20));
+
+	uring_event_t event;
+	uring_test_wait_event(&uring, &event);
+
+	assert_eq(event.user_data, 20);
+	assert_eq(event.res, 4);
+	assert_false(event.more);
+
+	char buf[4];
+	assert_eq(read(client_fds[0], buf, 4), 4);
+	assert_eq(memcmp(buf, "pong", 4), 0);
+
+	for(int i = 0; i < 2; ++i)
+	{
+		(void) close(client_fds[i]);
+		(void) close(server_fds[i]);
+	}
+
+	(void) close(listen_fd);
+
+	uring_free(&uring);
+}
+
+
+void assert_used
+test_normal_pass__uring_recv_reuses_bufs(
+	void
+	)
+{
+	uring_t uring;
+
+	if(!uring_init(&uring, 8, 2, 16))
+	{
+		return;
+	}
+
+	int fds[2];
+	assert_neq(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), -1);
+
+	assert_true(uring_recv_multishot(&uring, fds[0], 1));
+
+	for(int i = 0; i < 16; ++i)
+	{
+		char msg = 'a' + i;
+		assert_eq(write(fds[1], &msg, 1), 1);
+
+		uring_event_t event;
+		uring_test_wait_event(&uring, &event);
+
+		assert_eq(event.user_data, 1);
+		assert_eq(event.res, 1);
+		assert_eq(event.buf[0], msg);
+		assert_true(event.more);
+
+		uring_return_buf(&uring, event.buf_id);
+	}
+
+	(void) close(fds[1]);
+
+	uring_event_t event;
+	uring_test_wait_event(&uring, &event);
+
+	assert_eq(event.res, 0);
+	assert_false(event.more);
+
+	(void) close(fds[0]);
+
+	uring_free(&uring);
+}